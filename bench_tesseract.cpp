@@ -0,0 +1,335 @@
+// Microbenchmark Suite
+// Times the puzzle, math and projection hot paths and compares runs as JSON:
+//   bench_tesseract [--reps N] [--warmup MS] [--filter TEXT] [--json FILE]
+//                   [--baseline FILE] [--max-regression PCT]
+// Each benchmark is warmed up, then timed for N repetitions of a calibrated batch; the
+// median and p99 of the per-call times are reported. With --baseline, exits 1 when any
+// median is more than PCT percent (default 10) slower than the stored run.
+
+#include "tesseract_model.h"
+#include "rubik_cube.h"
+#include "math_4d.h"
+#include "rotor_4d.h"
+#include "projection_4d.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Results feed this so the optimizer cannot drop the timed work
+static volatile uint64_t sink;
+
+static inline uint64_t floatBits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+struct Benchmark {
+    std::string name;
+    std::function<void(uint64_t iterations)> run;
+};
+
+struct BenchResult {
+    std::string name;
+    double medianNs;
+    double p99Ns;
+    double minNs;
+    uint64_t batch;
+    int reps;
+};
+
+static double secondsSince(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// Warm up for warmupMs, growing the batch until one call of run() takes >= 1 ms, then time reps batches
+static BenchResult measure(const Benchmark& b, int reps, double warmupMs) {
+    uint64_t batch = 1;
+    auto t0 = Clock::now();
+    for (;;) {
+        auto t1 = Clock::now();
+        b.run(batch);
+        double s = secondsSince(t1);
+        if (s >= 1e-3 && secondsSince(t0) * 1e3 >= warmupMs) break;
+        if (s < 1e-3) batch *= 2;
+    }
+    std::vector<double> ns;
+    for (int r = 0; r < reps; r++) {
+        auto t1 = Clock::now();
+        b.run(batch);
+        ns.push_back(secondsSince(t1) * 1e9 / static_cast<double>(batch));
+    }
+    std::sort(ns.begin(), ns.end());
+    BenchResult res;
+    res.name = b.name;
+    res.medianNs = ns[ns.size() / 2];
+    res.p99Ns = ns[std::min(ns.size() - 1, static_cast<size_t>(ns.size() * 0.99))];
+    res.minNs = ns[0];
+    res.batch = batch;
+    res.reps = reps;
+    return res;
+}
+
+static std::vector<Benchmark> benchmarks() {
+    std::vector<Benchmark> list;
+    list.push_back({"tesseract.rotateSlice", [](uint64_t n) {
+        TesseractPuzzle p;
+        for (uint64_t i = 0; i < n; i++) p.rotateSlice(static_cast<int>(i % 6), static_cast<int>(i / 6 % 4), (i & 1) != 0);
+        sink = sink + p.hash();
+    }});
+    list.push_back({"tesseract.applyMove", [](uint64_t n) {
+        static const std::vector<std::string> names = [] {
+            std::vector<std::string> v;
+            for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+                TesseractOp op{static_cast<uint8_t>(m)};
+                v.push_back(formatMoves(&op, 1));
+            }
+            return v;
+        }();
+        TesseractPuzzle p;
+        for (uint64_t i = 0; i < n; i++) p.applyMove(names[i % names.size()]);
+        sink = sink + p.hash();
+    }});
+    list.push_back({"tesseract.scramble", [](uint64_t n) {
+        TesseractPuzzle p;
+        for (uint64_t i = 0; i < n; i++) p.scramble(30, i);
+        sink = sink + p.hash();
+    }});
+    list.push_back({"tesseract.canonicalize", [](uint64_t n) {
+        TesseractPuzzle p;
+        p.scramble(30, 3);
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            TesseractPuzzle q = p;
+            acc += static_cast<uint64_t>(q.canonicalize());
+            p.rotateSlice(static_cast<int>(i % 6), static_cast<int>(i / 6 % 4), true);  // a new state each time
+        }
+        sink = sink + acc;
+    }});
+    list.push_back({"tesseract.isSolved", [](uint64_t n) {
+        TesseractPuzzle p;
+        p.scramble(30, 1);
+        uint64_t solved = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            solved += p.isSolved();
+            if ((i & 63) == 0) p.rotateSlice(0, 0, true);  // keep the state from being hoisted
+        }
+        sink = sink + solved;
+    }});
+    list.push_back({"tesseract.getAllVertices", [](uint64_t n) {
+        TesseractPuzzle p;
+        p.scramble(30, 2);
+        std::vector<Vertex4D> verts;
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            p.getAllVertices(verts);
+            acc += static_cast<uint64_t>(verts[i & 15].colors[i & 3]);
+        }
+        sink = sink + acc;
+    }});
+    list.push_back({"hypercube.3x3x3x3.apply", [](uint64_t n) {
+        Tesseract3Puzzle p;
+        for (uint64_t i = 0; i < n; i++) p.apply(static_cast<int>(i % Tesseract3Puzzle::MOVES));
+        sink = sink + static_cast<uint64_t>(p.getColor(7));
+    }});
+    list.push_back({"math.rotate4D", [](uint64_t n) {
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++) acc += floatBits(rotate4D(static_cast<int>(i % 6), static_cast<float>(i & 255)).m[5]);
+        sink = sink + acc;
+    }});
+    list.push_back({"rotor.slerp.toMatrix", [](uint64_t n) {
+        Rotor4 quarter = Rotor4::plane(PLANE_XW, 90.0f);
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++)
+            acc += floatBits(slerp(Rotor4::identity(), quarter, static_cast<float>(i & 255) / 256.0f).toMatrix().m[5]);
+        sink = sink + acc;
+    }});
+    list.push_back({"rotor.compose", [](uint64_t n) {
+        Rotor4 step = Rotor4::plane(PLANE_YZ, 1.0f), r;
+        for (uint64_t i = 0; i < n; i++) r = compose(step, r);
+        sink = sink + floatBits(r.left.w);
+    }});
+    list.push_back({"math.matMul.vec", [](uint64_t n) {
+        Mat4x4 m = matMul(rotate4D(PLANE_XW, 30.0f), rotate4D(PLANE_YZ, 20.0f));
+        Vec4 v(1.0f, 0.5f, -0.25f, 0.75f);
+        for (uint64_t i = 0; i < n; i++) v = matMul(m, v);
+        sink = sink + floatBits(v.x);
+    }});
+    list.push_back({"math.matMul.mat", [](uint64_t n) {
+        Mat4x4 r = rotate4D(PLANE_ZW, 10.0f), m = Mat4x4::identity();
+        for (uint64_t i = 0; i < n; i++) m = matMul(r, m);
+        sink = sink + floatBits(m.m[0]);
+    }});
+    list.push_back({"math.givensRotate", [](uint64_t n) {
+        Mat4x4 m = Mat4x4::identity();
+        const float c = std::cos(0.01f), s = std::sin(0.01f);
+        for (uint64_t i = 0; i < n; i++) givensRotate(m, planeAxes(4, static_cast<int>(i % 6)), c, s);
+        sink = sink + floatBits(m.m[0]);
+    }});
+    list.push_back({"math.givensRotate.5d", [](uint64_t n) {
+        Mat5f m = Mat5f::identity();
+        const float c = std::cos(0.01f), s = std::sin(0.01f);
+        for (uint64_t i = 0; i < n; i++) givensRotate(m, planeAxes(5, static_cast<int>(i % 10)), c, s);
+        sink = sink + floatBits(m.m[0]);
+    }});
+    list.push_back({"math.transformPoints", [](uint64_t n) {
+        static std::vector<Vec4> pts(1024, Vec4(0.5f, -0.5f, 0.25f, 1.0f));
+        Mat4x4 m = rotate4D(PLANE_XW, 0.5f);
+        for (uint64_t i = 0; i < n; i += pts.size()) transformPoints(m, pts.data(), pts.data(), pts.size());
+        sink = sink + floatBits(pts[7].x);
+    }});
+    list.push_back({"math.transformPoints.soa", [](uint64_t n) {
+        static std::vector<float> xs(1024, 0.5f), ys(1024, -0.5f), zs(1024, 0.25f), ws(1024, 1.0f);
+        Vec4SoA s = {xs.data(), ys.data(), zs.data(), ws.data()};
+        Mat4x4 m = rotate4D(PLANE_XW, 0.5f);
+        for (uint64_t i = 0; i < n; i += xs.size()) transformPoints(m, s, s, xs.size());
+        sink = sink + floatBits(xs[7]);
+    }});
+    list.push_back({"projection.project4Dto3D", [](uint64_t n) {
+        Vec4 p(0.5f, -0.5f, 0.5f, 0.25f);
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            p.w = static_cast<float>(i & 7) * 0.125f - 0.5f;
+            acc += floatBits(project4Dto3D(p, 3.0f).x);
+        }
+        sink = sink + acc;
+    }});
+
+    list.push_back({"projection.projectPoints", [](uint64_t n) {
+        static std::vector<float> xs(1024, 0.5f), ys(1024, -0.5f), zs(1024, 0.25f), ws(1024, 0.75f), out(4 * 1024);
+        Vec4SoA in = {xs.data(), ys.data(), zs.data(), ws.data()};
+        Vec4SoA dst = {out.data(), out.data() + 1024, out.data() + 2048, out.data() + 3072};
+        for (uint64_t i = 0; i < n; i += xs.size()) projectPoints(in, dst, xs.size(), 3.0f);
+        sink = sink + floatBits(out[7]);
+    }});
+
+    typedef void (RubikCube::*RubikMove)();
+    static const struct { const char* name; RubikMove move; } rubikMoves[] = {
+        {"R", &RubikCube::rotateR}, {"R'", &RubikCube::rotateRPrime},
+        {"L", &RubikCube::rotateL}, {"L'", &RubikCube::rotateLPrime},
+        {"U", &RubikCube::rotateU}, {"U'", &RubikCube::rotateUPrime},
+        {"D", &RubikCube::rotateD}, {"D'", &RubikCube::rotateDPrime},
+        {"F", &RubikCube::rotateF}, {"F'", &RubikCube::rotateFPrime},
+        {"B", &RubikCube::rotateB}, {"B'", &RubikCube::rotateBPrime},
+    };
+    for (const auto& m : rubikMoves) {
+        RubikMove move = m.move;
+        list.push_back({std::string("rubik.") + m.name, [move](uint64_t n) {
+            RubikCube c;
+            for (uint64_t i = 0; i < n; i++) (c.*move)();
+            sink = sink + c.hash();
+        }});
+    }
+    return list;
+}
+
+// ---------------------------------------------------------------------------
+// JSON
+
+static bool writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "{\n  \"version\": 1,\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        std::fprintf(f, "    {\"name\": \"%s\", \"median_ns\": %.3f, \"p99_ns\": %.3f, \"min_ns\": %.3f, "
+                        "\"batch\": %llu, \"reps\": %d}%s\n",
+                     r.name.c_str(), r.medianNs, r.p99Ns, r.minNs, static_cast<unsigned long long>(r.batch),
+                     r.reps, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    return std::fclose(f) == 0;
+}
+
+// Reads back what writeJson produces: each "name" and the "median_ns" that follows it
+static bool readBaseline(const std::string& path, std::vector<BenchResult>& out) {
+    FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return false;
+    std::string text;
+    char buf[4096];
+    size_t got;
+    while ((got = std::fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, got);
+    std::fclose(f);
+    out.clear();
+    for (size_t pos = 0; (pos = text.find("\"name\"", pos)) != std::string::npos;) {
+        size_t open = text.find('"', text.find(':', pos) + 1);
+        size_t close = text.find('"', open + 1);
+        size_t median = text.find("\"median_ns\"", close);
+        if (open == std::string::npos || close == std::string::npos || median == std::string::npos) return false;
+        BenchResult r = BenchResult();
+        r.name = text.substr(open + 1, close - open - 1);
+        r.medianNs = std::strtod(text.c_str() + text.find(':', median) + 1, nullptr);
+        out.push_back(r);
+        pos = median;
+    }
+    return !out.empty();
+}
+
+static void usage() {
+    std::fprintf(stderr,
+                 "usage: bench_tesseract [--reps N] [--warmup MS] [--filter TEXT] [--json FILE]\n"
+                 "                       [--baseline FILE] [--max-regression PCT]\n");
+}
+
+int main(int argc, char** argv) {
+    int reps = 25;
+    double warmupMs = 50.0, maxRegression = 10.0;
+    std::string filter, jsonPath, baselinePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--reps" && hasValue) reps = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue) warmupMs = std::atof(argv[++i]);
+        else if (arg == "--filter" && hasValue) filter = argv[++i];
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--max-regression" && hasValue) maxRegression = std::atof(argv[++i]);
+        else { usage(); return 2; }
+    }
+    if (reps < 1) { usage(); return 2; }
+
+    std::vector<BenchResult> baseline;
+    if (!baselinePath.empty() && !readBaseline(baselinePath, baseline)) {
+        std::fprintf(stderr, "cannot read baseline %s\n", baselinePath.c_str());
+        return 2;
+    }
+
+    std::printf("%-28s %12s %12s %12s %10s\n", "benchmark", "median ns", "p99 ns", "min ns", "vs base");
+    std::vector<BenchResult> results;
+    int regressions = 0;
+    for (const Benchmark& b : benchmarks()) {
+        if (!filter.empty() && b.name.find(filter) == std::string::npos) continue;
+        BenchResult r = measure(b, reps, warmupMs);
+        results.push_back(r);
+        std::printf("%-28s %12.2f %12.2f %12.2f", r.name.c_str(), r.medianNs, r.p99Ns, r.minNs);
+        for (const BenchResult& base : baseline) {
+            if (base.name != r.name || base.medianNs <= 0.0) continue;
+            double change = (r.medianNs / base.medianNs - 1.0) * 100.0;
+            bool slower = change > maxRegression;
+            regressions += slower;
+            std::printf(" %+9.1f%%%s", change, slower ? "  REGRESSION" : "");
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, results)) {
+        std::fprintf(stderr, "cannot write %s\n", jsonPath.c_str());
+        return 1;
+    }
+    if (regressions > 0) {
+        std::fprintf(stderr, "%d benchmark(s) more than %.1f%% slower than %s\n", regressions, maxRegression,
+                     baselinePath.c_str());
+        return 1;
+    }
+    return 0;
+}
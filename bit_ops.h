@@ -0,0 +1,35 @@
+// Bit Operations
+// Portable 64-bit helpers (GCC/Clang builtins, MSVC intrinsics)
+
+#ifndef BIT_OPS_H
+#define BIT_OPS_H
+
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit; x must be non-zero
+inline int lowestBit(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+inline int popCount(uint64_t x) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(x));
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> ((64 - r) & 63));
+}
+
+#endif // BIT_OPS_H
@@ -0,0 +1,316 @@
+// Cubie-Level Cube Implementation
+
+#include "cubie_cube.h"
+#include "bit_ops.h"
+#include <cstring>
+
+static void setError(std::string* error, const std::string& msg) {
+    if (error) *error = msg;
+}
+
+// Slot facelets from the cubie geometry: the reference facelet first, then the others
+// ordered so the three (or two) normals always have the same handedness
+struct SlotTables {
+    uint8_t corners[CORNER_COUNT][3];
+    uint8_t edges[EDGE_COUNT][2];
+    uint8_t cornerColors[CORNER_COUNT][3];  // solved colors, in the same order
+    uint8_t edgeColors[EDGE_COUNT][2];
+
+    SlotTables() {
+        static const int cornerPos[CORNER_COUNT][3] = {
+            {1, 1, 1}, {-1, 1, 1}, {-1, 1, -1}, {1, 1, -1}, {1, -1, 1}, {-1, -1, 1}, {-1, -1, -1}, {1, -1, -1}};
+        static const int edgePos[EDGE_COUNT][3] = {
+            {1, 1, 0}, {0, 1, 1}, {-1, 1, 0}, {0, 1, -1}, {1, -1, 0}, {0, -1, 1},
+            {-1, -1, 0}, {0, -1, -1}, {1, 0, 1}, {-1, 0, 1}, {-1, 0, -1}, {1, 0, -1}};
+        RubikCube solved;
+        for (int s = 0; s < CORNER_COUNT; s++) {
+            int found[3], n = 0;
+            collect(cornerPos[s], found, n);
+            // Reference = the U/D facelet (faces 2, 3)
+            int ref = 0;
+            while (found[ref] / 9 / 2 != 1) ref++;
+            int a = found[ref], b = found[(ref + 1) % 3], c = found[(ref + 2) % 3];
+            if (det(a, b, c) > 0) { int t = b; b = c; c = t; }
+            corners[s][0] = static_cast<uint8_t>(a);
+            corners[s][1] = static_cast<uint8_t>(b);
+            corners[s][2] = static_cast<uint8_t>(c);
+            for (int k = 0; k < 3; k++) cornerColors[s][k] = solved.facelets()[corners[s][k]];
+        }
+        for (int s = 0; s < EDGE_COUNT; s++) {
+            int found[3], n = 0;
+            collect(edgePos[s], found, n);
+            // Reference = the U/D facelet, or the F/B facelet (faces 4, 5) in the middle slice
+            int refAxis = edgePos[s][1] != 0 ? 1 : 2;
+            int ref = found[0] / 9 / 2 == refAxis ? 0 : 1;
+            edges[s][0] = static_cast<uint8_t>(found[ref]);
+            edges[s][1] = static_cast<uint8_t>(found[1 - ref]);
+            for (int k = 0; k < 2; k++) edgeColors[s][k] = solved.facelets()[edges[s][k]];
+        }
+    }
+
+    static void collect(const int pos[3], int found[3], int& n) {
+        for (int f = 0; f < RUBIK_FACELETS; f++) {
+            int x, y, z;
+            RubikCube::faceletCubie(f, x, y, z);
+            if (f % 9 != 4 && x == pos[0] && y == pos[1] && z == pos[2]) found[n++] = f;
+        }
+    }
+
+    static void normal(int facelet, int n[3]) {
+        int face = facelet / 9;
+        for (int k = 0; k < 3; k++) n[k] = k == face / 2 ? (face % 2 == 0 ? 1 : -1) : 0;
+    }
+
+    static int det(int a, int b, int c) {
+        int u[3], v[3], w[3];
+        normal(a, u);
+        normal(b, v);
+        normal(c, w);
+        return u[0] * (v[1] * w[2] - v[2] * w[1]) - u[1] * (v[0] * w[2] - v[2] * w[0]) +
+               u[2] * (v[0] * w[1] - v[1] * w[0]);
+    }
+};
+
+static const SlotTables& slotTables() {
+    static const SlotTables tables;
+    return tables;
+}
+
+const uint8_t (&CubieCube::cornerFacelets())[CORNER_COUNT][3] {
+    return slotTables().corners;
+}
+
+const uint8_t (&CubieCube::edgeFacelets())[EDGE_COUNT][2] {
+    return slotTables().edges;
+}
+
+CubieCube::CubieCube() {
+    for (int i = 0; i < CORNER_COUNT; i++) { cp[i] = static_cast<uint8_t>(i); co[i] = 0; }
+    for (int i = 0; i < EDGE_COUNT; i++) { ep[i] = static_cast<uint8_t>(i); eo[i] = 0; }
+}
+
+static int permutationParity(const uint8_t* p, int n) {
+    int parity = 0;
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++) parity ^= p[j] < p[i];
+    return parity;
+}
+
+bool CubieCube::fromFacelets(const uint8_t facelets[RUBIK_FACELETS], CubieCube& out, std::string* error) {
+    const SlotTables& t = slotTables();
+    RubikCube solved;
+    for (int face = 0; face < 6; face++)
+        if (facelets[face * 9 + 4] != solved.facelets()[face * 9 + 4]) { setError(error, "centers are not in place"); return false; }
+
+    bool seenCorner[CORNER_COUNT] = {false}, seenEdge[EDGE_COUNT] = {false};
+    int twist = 0, flip = 0;
+    for (int s = 0; s < CORNER_COUNT; s++) {
+        int piece = -1, ori = 0;
+        for (int p = 0; p < CORNER_COUNT && piece < 0; p++)
+            for (int o = 0; o < 3 && piece < 0; o++) {
+                bool match = true;
+                for (int k = 0; k < 3; k++) match = match && facelets[t.corners[s][(k + o) % 3]] == t.cornerColors[p][k];
+                if (match) { piece = p; ori = o; }
+            }
+        if (piece < 0 || seenCorner[piece]) { setError(error, "corner " + std::to_string(s) + " has impossible colors"); return false; }
+        seenCorner[piece] = true;
+        out.cp[s] = static_cast<uint8_t>(piece);
+        out.co[s] = static_cast<uint8_t>(ori);
+        twist += ori;
+    }
+    for (int s = 0; s < EDGE_COUNT; s++) {
+        int piece = -1, ori = 0;
+        for (int p = 0; p < EDGE_COUNT && piece < 0; p++)
+            for (int o = 0; o < 2 && piece < 0; o++)
+                if (facelets[t.edges[s][o]] == t.edgeColors[p][0] && facelets[t.edges[s][1 - o]] == t.edgeColors[p][1]) {
+                    piece = p;
+                    ori = o;
+                }
+        if (piece < 0 || seenEdge[piece]) { setError(error, "edge " + std::to_string(s) + " has impossible colors"); return false; }
+        seenEdge[piece] = true;
+        out.ep[s] = static_cast<uint8_t>(piece);
+        out.eo[s] = static_cast<uint8_t>(ori);
+        flip += ori;
+    }
+    if (twist % 3 != 0) { setError(error, "a corner is twisted"); return false; }
+    if (flip % 2 != 0) { setError(error, "an edge is flipped"); return false; }
+    if (permutationParity(out.cp, CORNER_COUNT) != permutationParity(out.ep, EDGE_COUNT)) {
+        setError(error, "two pieces are swapped");
+        return false;
+    }
+    return true;
+}
+
+void CubieCube::toFacelets(uint8_t facelets[RUBIK_FACELETS]) const {
+    const SlotTables& t = slotTables();
+    RubikCube solved;
+    std::memcpy(facelets, solved.facelets(), RUBIK_FACELETS);
+    for (int s = 0; s < CORNER_COUNT; s++)
+        for (int k = 0; k < 3; k++) facelets[t.corners[s][(k + co[s]) % 3]] = t.cornerColors[cp[s]][k];
+    for (int s = 0; s < EDGE_COUNT; s++)
+        for (int k = 0; k < 2; k++) facelets[t.edges[s][(k + eo[s]) % 2]] = t.edgeColors[ep[s]][k];
+}
+
+void CubieCube::toCube(RubikCube& cube) const {
+    uint8_t facelets[RUBIK_FACELETS];
+    toFacelets(facelets);
+    cube.setFacelets(facelets);
+}
+
+void CubieCube::multiply(const CubieCube& b) {
+    CubieCube a = *this;
+    for (int i = 0; i < CORNER_COUNT; i++) {
+        cp[i] = a.cp[b.cp[i]];
+        co[i] = static_cast<uint8_t>((a.co[b.cp[i]] + b.co[i]) % 3);
+    }
+    for (int i = 0; i < EDGE_COUNT; i++) {
+        ep[i] = a.ep[b.ep[i]];
+        eo[i] = static_cast<uint8_t>(a.eo[b.ep[i]] ^ b.eo[i]);
+    }
+}
+
+const CubieCube& CubieCube::moveCube(RubikOp op) {
+    struct Table {
+        CubieCube moves[RUBIK_OP_COUNT];
+        Table() {
+            for (int m = 0; m < RUBIK_OP_COUNT; m++) {
+                RubikCube cube;
+                cube.apply(RubikOp{static_cast<uint8_t>(m)});
+                fromCube(cube, moves[m]);
+            }
+        }
+    };
+    static const Table table;
+    return table.moves[op.code];
+}
+
+void CubieCube::apply(RubikOp op) {
+    multiply(moveCube(op));
+}
+
+bool CubieCube::operator==(const CubieCube& o) const {
+    return std::memcmp(cp, o.cp, sizeof(cp)) == 0 && std::memcmp(co, o.co, sizeof(co)) == 0 &&
+           std::memcmp(ep, o.ep, sizeof(ep)) == 0 && std::memcmp(eo, o.eo, sizeof(eo)) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Coordinates
+
+// Lehmer code: digit i counts the later entries smaller than p[i]
+int rankPermutation(const uint8_t* p, int n) {
+    uint32_t unplaced = 0;
+    for (int i = 0; i < n; i++) unplaced |= 1u << p[i];
+    int r = 0;
+    for (int i = 0; i < n; i++) {
+        r = r * (n - i) + popCount(unplaced & ((1u << p[i]) - 1));
+        unplaced ^= 1u << p[i];
+    }
+    return r;
+}
+
+void unrankPermutation(int rank, uint8_t* p, int n, int first) {
+    int digits[EDGE_COUNT];
+    for (int i = n - 1; i >= 0; i--) {
+        digits[i] = rank % (n - i);
+        rank /= n - i;
+    }
+    uint64_t unused = 0;  // nibble k = k-th smallest value not placed yet
+    for (int v = n - 1; v >= 0; v--) unused = (unused << 4) | static_cast<uint64_t>(v);
+    for (int i = 0; i < n; i++) {
+        int shift = digits[i] * 4;
+        uint64_t low = unused & ((uint64_t(1) << shift) - 1);
+        p[i] = static_cast<uint8_t>(first + ((unused >> shift) & 0xF));
+        unused = low | ((unused >> (shift + 4)) << shift);
+    }
+}
+
+static int choose(int n, int k) {
+    if (k < 0 || k > n) return 0;
+    int r = 1;
+    for (int i = 0; i < k; i++) r = r * (n - i) / (i + 1);
+    return r;
+}
+
+int CubieCube::twist() const {
+    int v = 0;
+    for (int i = 0; i < CORNER_COUNT - 1; i++) v = v * 3 + co[i];
+    return v;
+}
+
+void CubieCube::setTwist(int v) {
+    int sum = 0;
+    for (int i = CORNER_COUNT - 2; i >= 0; i--) {
+        co[i] = static_cast<uint8_t>(v % 3);
+        sum += co[i];
+        v /= 3;
+    }
+    co[CORNER_COUNT - 1] = static_cast<uint8_t>((3 - sum % 3) % 3);
+}
+
+int CubieCube::flip() const {
+    int v = 0;
+    for (int i = 0; i < EDGE_COUNT - 1; i++) v = v * 2 + eo[i];
+    return v;
+}
+
+void CubieCube::setFlip(int v) {
+    int sum = 0;
+    for (int i = EDGE_COUNT - 2; i >= 0; i--) {
+        eo[i] = static_cast<uint8_t>(v & 1);
+        sum += eo[i];
+        v >>= 1;
+    }
+    eo[EDGE_COUNT - 1] = static_cast<uint8_t>(sum & 1);
+}
+
+// Colex rank of the slots holding FR..BR, counted from BR down so the solved cube is 0
+int CubieCube::slice() const {
+    int v = 0, k = 0;
+    for (int q = 0; q < EDGE_COUNT; q++)
+        if (ep[EDGE_COUNT - 1 - q] >= FR) v += choose(q, ++k);
+    return v;
+}
+
+void CubieCube::setSlice(int v) {
+    bool inSlice[EDGE_COUNT] = {false};
+    for (int k = 4; k >= 1; k--) {
+        int q = k - 1;
+        while (choose(q + 1, k) <= v) q++;
+        v -= choose(q, k);
+        inSlice[EDGE_COUNT - 1 - q] = true;
+    }
+    int sliceEdge = FR, other = UR;
+    for (int s = 0; s < EDGE_COUNT; s++) ep[s] = static_cast<uint8_t>(inSlice[s] ? sliceEdge++ : other++);
+}
+
+int CubieCube::cornerPerm() const {
+    return rankPermutation(cp, CORNER_COUNT);
+}
+
+void CubieCube::setCornerPerm(int v) {
+    unrankPermutation(v, cp, CORNER_COUNT);
+}
+
+int CubieCube::edgePerm() const {
+    return rankPermutation(ep, EDGE_COUNT);
+}
+
+void CubieCube::setEdgePerm(int v) {
+    unrankPermutation(v, ep, EDGE_COUNT);
+}
+
+int CubieCube::udEdgePerm() const {
+    return rankPermutation(ep, 8);
+}
+
+void CubieCube::setUdEdgePerm(int v) {
+    unrankPermutation(v, ep, 8, UR);
+}
+
+int CubieCube::slicePerm() const {
+    return rankPermutation(ep + FR, 4);
+}
+
+void CubieCube::setSlicePerm(int v) {
+    unrankPermutation(v, ep + FR, 4, FR);
+}
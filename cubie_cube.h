@@ -0,0 +1,85 @@
+// Cubie-Level Cube
+// RubikCube as corner / edge permutation and orientation, with the two-phase coordinates
+
+#ifndef CUBIE_CUBE_H
+#define CUBIE_CUBE_H
+
+#include "rubik_cube.h"
+#include <cstdint>
+#include <string>
+
+// Slots in Kociemba order (x = R/L, y = U/D, z = F/B in faceletCubie coordinates)
+enum CornerSlot { URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB };
+enum EdgeSlot { UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR };
+
+constexpr int CORNER_COUNT = 8;
+constexpr int EDGE_COUNT = 12;
+
+// Coordinate ranges; every coordinate is 0 for the solved cube
+constexpr int TWIST_COUNT = 2187;         // corner orientations, 3^7
+constexpr int FLIP_COUNT = 2048;          // edge orientations, 2^11
+constexpr int SLICE_COUNT = 495;          // which 4 slots hold the FR, FL, BL, BR edges, C(12, 4)
+constexpr int CORNER_PERM_COUNT = 40320;  // 8!
+constexpr int EDGE_PERM_COUNT = 479001600; // 12!
+constexpr int UD_EDGE_PERM_COUNT = 40320; // 8! arrangements of the U/D-layer edges (phase 2 only)
+constexpr int SLICE_PERM_COUNT = 24;      // 4! arrangements of the slice edges (phase 2 only)
+
+// Lexicographic (Lehmer) rank of n distinct values below 32, n <= 12, and its inverse onto
+// first .. first + n - 1. Both are O(n): rank counts the smaller values still unplaced with
+// one popcount, unrank removes each digit from a nibble-packed list of the unused values.
+int rankPermutation(const uint8_t* p, int n);
+void unrankPermutation(int rank, uint8_t* p, int n, int first = 0);
+
+// cp[i] / ep[i] = piece in slot i; co / eo = its twist (0..2) / flip (0..1).
+// Orientation is read from the facelet in the slot's reference position: the U/D facelet,
+// or the F/B facelet for the middle-slice edges. Corner facelets are listed clockwise
+// from it, so twists are additive and sum to 0 mod 3 on any legal cube.
+struct CubieCube {
+    uint8_t cp[CORNER_COUNT];
+    uint8_t co[CORNER_COUNT];
+    uint8_t ep[EDGE_COUNT];
+    uint8_t eo[EDGE_COUNT];
+
+    CubieCube();  // solved
+
+    // False (with a reason) for colorings that no sequence of moves can reach
+    static bool fromFacelets(const uint8_t facelets[RUBIK_FACELETS], CubieCube& out, std::string* error = nullptr);
+    static bool fromCube(const RubikCube& cube, CubieCube& out, std::string* error = nullptr) {
+        return fromFacelets(cube.facelets(), out, error);
+    }
+    void toFacelets(uint8_t facelets[RUBIK_FACELETS]) const;
+    void toCube(RubikCube& cube) const;
+
+    // Apply b after this cube
+    void multiply(const CubieCube& b);
+    void apply(RubikOp op);
+    // The cubie effect of each of the 18 opcodes
+    static const CubieCube& moveCube(RubikOp op);
+
+    bool operator==(const CubieCube& o) const;
+    bool operator!=(const CubieCube& o) const { return !(*this == o); }
+
+    int twist() const;
+    int flip() const;
+    int slice() const;
+    int cornerPerm() const;
+    int edgePerm() const;
+    int udEdgePerm() const;
+    int slicePerm() const;
+    // Setters touch only the pieces their coordinate describes, which is all move-table
+    // generation needs. udEdgePerm / slicePerm assume the slice edges are in the slice.
+    // twist, flip, cornerPerm and edgePerm together identify the cube: its dense index.
+    void setTwist(int v);
+    void setFlip(int v);
+    void setSlice(int v);
+    void setCornerPerm(int v);
+    void setEdgePerm(int v);
+    void setUdEdgePerm(int v);
+    void setSlicePerm(int v);
+
+    // Facelets of each slot: [0] is the reference facelet, the rest follow it clockwise
+    static const uint8_t (&cornerFacelets())[CORNER_COUNT][3];
+    static const uint8_t (&edgeFacelets())[EDGE_COUNT][2];
+};
+
+#endif // CUBIE_CUBE_H
@@ -0,0 +1,189 @@
+// Hypercube Puzzle Engine
+// Size^Dim puzzles (2x2x2x2, 3x3x3x3, 4x4x4x4, ...) with slice-move tables generated from the geometry
+
+#ifndef HYPERCUBE_PUZZLE_H
+#define HYPERCUBE_PUZZLE_H
+
+#include "math_nd.h"
+#include "philox.h"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+constexpr int hypercubePow(int base, int exp) { return exp == 0 ? 1 : base * hypercubePow(base, exp - 1); }
+
+// Geometry of the Size^Dim puzzle, built once at startup.
+//
+// Cubies sit on a Size^Dim grid, numbered lexicographically with axis 0 most significant.
+// A cubie has one sticker per axis on which it lies on the surface (coordinate 0 or
+// Size-1); stickers are numbered cubie by cubie, then in axis order, so for 2^4 sticker
+// vertex * 4 + slot is the TesseractPuzzle layout. The sticker on axis a is color 2a on
+// the + side and 2a + 1 on the - side (CellColor for Dim = 4).
+//
+// A move turns one Size x Size square of cubies a quarter turn in rotation plane (i, j)
+// (planeAxes order: XY, XZ, XW, YZ, YW, ZW for Dim = 4). The square is picked by the
+// layer, the coordinates on the other Dim - 2 axes as base-Size digits (first such axis
+// most significant). Clockwise takes (u, v) to (Size-1-v, u), and the stickers on axes i
+// and j trade axes. Move code = (plane * LAYERS + layer) * 2 + (clockwise ? 0 : 1), the
+// TesseractOp layout for 2^4.
+template <int Size, int Dim>
+struct HypercubeGeometry {
+    static_assert(Size >= 2 && Dim >= 2, "a hypercube puzzle needs Size >= 2 and Dim >= 2");
+
+    static constexpr int CUBIES = hypercubePow(Size, Dim);
+    static constexpr int STICKERS = 2 * Dim * hypercubePow(Size, Dim - 1);
+    static constexpr int COLORS = 2 * Dim;
+    static constexpr int PLANES = planeCount(Dim);
+    static constexpr int LAYERS = hypercubePow(Size, Dim - 2);
+    static constexpr int MOVES = PLANES * LAYERS * 2;
+    static constexpr int MAX_MOVED = Size * Size * Dim;  // stickers of one square of cubies
+
+    typedef std::conditional_t<STICKERS <= 256, uint8_t, uint16_t> Index;
+
+    // A move as a gather over the stickers it moves: new[dst[k]] = old[src[k]]
+    struct Move {
+        int count;
+        Index dst[MAX_MOVED];
+        Index src[MAX_MOVED];
+    };
+
+    int sticker[CUBIES][Dim];  // sticker of cubie on axis, -1 off the surface
+    uint8_t solved[STICKERS];
+    Move moves[MOVES];
+
+    static const HypercubeGeometry& get() {
+        static const HypercubeGeometry geometry;
+        return geometry;
+    }
+
+    static int cubieIndex(const int coords[Dim]) {
+        int c = 0;
+        for (int a = 0; a < Dim; a++) c = c * Size + coords[a];
+        return c;
+    }
+
+    static void cubieCoords(int cubie, int coords[Dim]) {
+        for (int a = Dim - 1; a >= 0; a--) {
+            coords[a] = cubie % Size;
+            cubie /= Size;
+        }
+    }
+
+    static int moveCode(int plane, int layer, bool clockwise) {
+        return (plane * LAYERS + layer) * 2 + (clockwise ? 0 : 1);
+    }
+
+    // Whether a move in (plane, layer) turns the cubie
+    static bool inSlice(int cubie, int plane, int layer) {
+        if (plane < 0 || plane >= PLANES || layer < 0 || layer >= LAYERS) return false;
+        PlaneAxes p = planeAxes(Dim, plane);
+        int coords[Dim];
+        cubieCoords(cubie, coords);
+        for (int a = Dim - 1; a >= 0; a--) {
+            if (a == p.first || a == p.second) continue;
+            if (coords[a] != layer % Size) return false;
+            layer /= Size;
+        }
+        return true;
+    }
+
+private:
+    HypercubeGeometry() {
+        int next = 0;
+        for (int c = 0; c < CUBIES; c++) {
+            int coords[Dim];
+            cubieCoords(c, coords);
+            for (int a = 0; a < Dim; a++) {
+                bool surface = coords[a] == 0 || coords[a] == Size - 1;
+                sticker[c][a] = surface ? next : -1;
+                if (surface) solved[next++] = static_cast<uint8_t>(2 * a + (coords[a] == Size - 1 ? 0 : 1));
+            }
+        }
+        for (int plane = 0; plane < PLANES; plane++)
+            for (int layer = 0; layer < LAYERS; layer++)
+                for (int ccw = 0; ccw < 2; ccw++) buildMove(plane, layer, ccw == 0, moves[moveCode(plane, layer, ccw == 0)]);
+    }
+
+    void buildMove(int plane, int layer, bool clockwise, Move& move) {
+        PlaneAxes p = planeAxes(Dim, plane);
+        int coords[Dim];
+        for (int a = Dim - 1, rest = layer; a >= 0; a--) {
+            if (a == p.first || a == p.second) continue;
+            coords[a] = rest % Size;
+            rest /= Size;
+        }
+        move.count = 0;
+        for (int u = 0; u < Size; u++)
+            for (int v = 0; v < Size; v++) {
+                coords[p.first] = u;
+                coords[p.second] = v;
+                int from = cubieIndex(coords);
+                coords[p.first] = clockwise ? Size - 1 - v : v;
+                coords[p.second] = clockwise ? u : Size - 1 - u;
+                int to = cubieIndex(coords);
+                for (int a = 0; a < Dim; a++) {
+                    if (sticker[from][a] < 0) continue;
+                    int t = a == p.first ? p.second : (a == p.second ? p.first : a);
+                    if (sticker[to][t] == sticker[from][a]) continue;  // center of an odd square
+                    move.dst[move.count] = static_cast<Index>(sticker[to][t]);
+                    move.src[move.count] = static_cast<Index>(sticker[from][a]);
+                    move.count++;
+                }
+            }
+    }
+};
+
+// Size^Dim puzzle state, one byte per sticker. Moves are table gathers over the stickers
+// they move only (a 3^4 quarter turn moves 36 of 216), so no case analysis per move.
+// HypercubePuzzle<2, 4> is TesseractPuzzle (tesseract_model.h), which packs its 64
+// stickers into bit planes instead.
+template <int Size, int Dim>
+class HypercubePuzzle {
+public:
+    typedef HypercubeGeometry<Size, Dim> Geometry;
+    static constexpr int STICKERS = Geometry::STICKERS;
+    static constexpr int MOVES = Geometry::MOVES;
+
+    HypercubePuzzle() { reset(); }
+
+    void reset() { std::memcpy(stickers_, Geometry::get().solved, STICKERS); }
+
+    void apply(int move) {
+        if (move < 0 || move >= MOVES) return;
+        const typename Geometry::Move& m = Geometry::get().moves[move];
+        uint8_t moved[Geometry::MAX_MOVED];
+        for (int k = 0; k < m.count; k++) moved[k] = stickers_[m.src[k]];
+        for (int k = 0; k < m.count; k++) stickers_[m.dst[k]] = moved[k];
+    }
+
+    void rotateSlice(int plane, int layer, bool clockwise) {
+        if (plane < 0 || plane >= Geometry::PLANES || layer < 0 || layer >= Geometry::LAYERS) return;
+        apply(Geometry::moveCode(plane, layer, clockwise));
+    }
+
+    // Random moves from Philox stream 0 of seed, as TesseractPuzzle::scramble
+    void scramble(int numMoves, uint64_t seed) {
+        PhiloxStream rng(seed, 0);
+        for (int i = 0; i < numMoves; i++) apply(static_cast<int>(rng.below(MOVES)));
+    }
+
+    bool isSolved() const { return std::memcmp(stickers_, Geometry::get().solved, STICKERS) == 0; }
+
+    int getColor(int sticker) const { return stickers_[sticker]; }
+    const uint8_t* stickers() const { return stickers_; }
+
+    bool operator==(const HypercubePuzzle& o) const { return std::memcmp(stickers_, o.stickers_, STICKERS) == 0; }
+    bool operator!=(const HypercubePuzzle& o) const { return !(*this == o); }
+
+private:
+    uint8_t stickers_[STICKERS];
+};
+
+// Defined in tesseract_model.h
+template <>
+class HypercubePuzzle<2, 4>;
+
+typedef HypercubePuzzle<3, 4> Tesseract3Puzzle;
+typedef HypercubePuzzle<4, 4> Tesseract4Puzzle;
+
+#endif // HYPERCUBE_PUZZLE_H
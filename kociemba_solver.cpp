@@ -0,0 +1,272 @@
+// Kociemba Two-Phase Solver Implementation
+
+#include "kociemba_solver.h"
+#include "move_simplifier.h"
+#include "bit_ops.h"
+#include <chrono>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int MAX_LENGTH = 32;
+
+// <U, D, R2, L2, F2, B2>: all U and D turns plus the half turns of the other faces
+const uint32_t PHASE2_MOVES = (7u << (UP * 3)) | (7u << (DOWN * 3)) | (1u << (RIGHT * 3 + 2)) |
+                              (1u << (LEFT * 3 + 2)) | (1u << (FRONT * 3 + 2)) | (1u << (BACK * 3 + 2));
+const uint32_t ALL_MOVES = (1u << RUBIK_OP_COUNT) - 1;
+
+const int COORD_SIZE[6] = {TWIST_COUNT, FLIP_COUNT, SLICE_COUNT, CORNER_PERM_COUNT, UD_EDGE_PERM_COUNT,
+                           SLICE_PERM_COUNT};
+
+int getCoord(const CubieCube& c, int table) {
+    switch (table) {
+        case KOCIEMBA_TWIST_MOVE: return c.twist();
+        case KOCIEMBA_FLIP_MOVE: return c.flip();
+        case KOCIEMBA_SLICE_MOVE: return c.slice();
+        case KOCIEMBA_CORNER_PERM_MOVE: return c.cornerPerm();
+        case KOCIEMBA_UD_EDGE_PERM_MOVE: return c.udEdgePerm();
+        default: return c.slicePerm();
+    }
+}
+
+void setCoord(CubieCube& c, int table, int v) {
+    switch (table) {
+        case KOCIEMBA_TWIST_MOVE: c.setTwist(v); break;
+        case KOCIEMBA_FLIP_MOVE: c.setFlip(v); break;
+        case KOCIEMBA_SLICE_MOVE: c.setSlice(v); break;
+        case KOCIEMBA_CORNER_PERM_MOVE: c.setCornerPerm(v); break;
+        case KOCIEMBA_UD_EDGE_PERM_MOVE: c.setUdEdgePerm(v); break;
+        default: c.setSlicePerm(v); break;
+    }
+}
+
+// Level-by-level BFS over index = a * sizeB + b from the solved index 0, packed to nibbles
+void buildPrune(const uint16_t* moveA, int sizeA, const uint16_t* moveB, int sizeB, uint32_t moves,
+                DistanceTable& out) {
+    uint64_t size = static_cast<uint64_t>(sizeA) * static_cast<uint64_t>(sizeB);
+    std::vector<uint8_t> dist(size, 0xFF);
+    dist[0] = 0;
+    std::vector<uint64_t> depthCounts(1, 1);
+    for (int d = 0; depthCounts.back() > 0; d++) {
+        uint64_t added = 0;
+        for (uint64_t i = 0; i < size; i++) {
+            if (dist[i] != d) continue;
+            int a = static_cast<int>(i / static_cast<uint64_t>(sizeB)), b = static_cast<int>(i % static_cast<uint64_t>(sizeB));
+            for (uint32_t m = moves; m; m &= m - 1) {
+                int op = lowestBit(m);
+                uint64_t j = static_cast<uint64_t>(moveA[a * RUBIK_OP_COUNT + op]) * static_cast<uint64_t>(sizeB) +
+                             moveB[b * RUBIK_OP_COUNT + op];
+                if (dist[j] == 0xFF) { dist[j] = static_cast<uint8_t>(d + 1); added++; }
+            }
+        }
+        depthCounts.push_back(added);
+    }
+    depthCounts.pop_back();
+    std::vector<uint8_t> packed((size + 1) / 2, 0);
+    for (uint64_t i = 0; i < size; i++) packed[i >> 1] |= static_cast<uint8_t>(dist[i] << ((i & 1) * 4));
+    out.adopt(packed, size, depthCounts);
+}
+
+struct Search {
+    const uint16_t* const* move;
+    const DistanceTable* prune;
+    CubieCube start;
+    int maxLength;
+    Clock::time_point deadline;
+    uint64_t nodes;
+    bool timedOut;
+    int length1;
+    int length;
+    RubikOp path[MAX_LENGTH];
+
+    int phase1Bound(int twist, int flip, int slice) const {
+        int a = prune[0].get(static_cast<uint64_t>(twist) * SLICE_COUNT + slice);
+        int b = prune[1].get(static_cast<uint64_t>(flip) * SLICE_COUNT + slice);
+        return a > b ? a : b;
+    }
+
+    int phase2Bound(int corner, int edge, int slice) const {
+        int a = prune[2].get(static_cast<uint64_t>(corner) * SLICE_PERM_COUNT + slice);
+        int b = prune[3].get(static_cast<uint64_t>(edge) * SLICE_PERM_COUNT + slice);
+        return a > b ? a : b;
+    }
+
+    bool expired() {
+        if ((++nodes & 4095) == 0 && Clock::now() > deadline) timedOut = true;
+        return timedOut;
+    }
+
+    bool phase1(int twist, int flip, int slice, int g, int togo) {
+        if (togo == 0) {
+            // A phase-2 move last means a shorter phase 1 already reached this subgroup state
+            if (twist != 0 || flip != 0 || slice != 0) return false;
+            if (g > 0 && ((PHASE2_MOVES >> path[g - 1].code) & 1)) return false;
+            return startPhase2(g);
+        }
+        uint32_t next = g == 0 ? ALL_MOVES : canonicalSuccessors(path[g - 1]);
+        for (; next && !timedOut; next &= next - 1) {
+            int op = lowestBit(next);
+            int t = move[KOCIEMBA_TWIST_MOVE][twist * RUBIK_OP_COUNT + op];
+            int f = move[KOCIEMBA_FLIP_MOVE][flip * RUBIK_OP_COUNT + op];
+            int s = move[KOCIEMBA_SLICE_MOVE][slice * RUBIK_OP_COUNT + op];
+            if (expired() || phase1Bound(t, f, s) > togo - 1) continue;
+            path[g] = RubikOp{static_cast<uint8_t>(op)};
+            if (phase1(t, f, s, g + 1, togo - 1)) return true;
+        }
+        return false;
+    }
+
+    bool startPhase2(int g) {
+        CubieCube c = start;
+        for (int i = 0; i < g; i++) c.apply(path[i]);
+        int corner = c.cornerPerm(), edge = c.udEdgePerm(), slice = c.slicePerm();
+        for (int depth = phase2Bound(corner, edge, slice); g + depth <= maxLength && !timedOut; depth++) {
+            if (phase2(corner, edge, slice, g, depth)) {
+                length1 = g;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool phase2(int corner, int edge, int slice, int g, int togo) {
+        if (togo == 0) {
+            if (corner != 0 || edge != 0 || slice != 0) return false;
+            length = g;
+            return true;
+        }
+        uint32_t next = (g == 0 ? ALL_MOVES : canonicalSuccessors(path[g - 1])) & PHASE2_MOVES;
+        for (; next && !timedOut; next &= next - 1) {
+            int op = lowestBit(next);
+            int c = move[KOCIEMBA_CORNER_PERM_MOVE][corner * RUBIK_OP_COUNT + op];
+            int e = move[KOCIEMBA_UD_EDGE_PERM_MOVE][edge * RUBIK_OP_COUNT + op];
+            int s = move[KOCIEMBA_SLICE_PERM_MOVE][slice * RUBIK_OP_COUNT + op];
+            if (expired() || phase2Bound(c, e, s) > togo - 1) continue;
+            path[g] = RubikOp{static_cast<uint8_t>(op)};
+            if (phase2(c, e, s, g + 1, togo - 1)) return true;
+        }
+        return false;
+    }
+};
+
+}  // namespace
+
+KociembaSolver::KociembaSolver(const KociembaOptions& options) : options_(options) {
+    if (!options_.tablePath.empty() && file_.open(options_.tablePath) && attachTables()) return;
+    file_.close();
+    buildTables();
+    // Best effort: a missing cache only costs the next process a rebuild
+    if (!options_.tablePath.empty()) writeTables(options_.tablePath);
+}
+
+bool KociembaSolver::attachTables() {
+    for (int t = 0; t < MOVE_TABLES; t++) {
+        const PdbTableEntry* e = file_.find(PDB_KOCIEMBA, static_cast<uint32_t>(t), 0);
+        uint64_t entries = static_cast<uint64_t>(COORD_SIZE[t]) * RUBIK_OP_COUNT;
+        if (!e || e->entries != entries || e->bytes != entries * sizeof(uint16_t)) return false;
+        move_[t] = reinterpret_cast<const uint16_t*>(file_.tableData(*e));
+    }
+    static const int pruneSize[PRUNE_TABLES] = {TWIST_COUNT * SLICE_COUNT, FLIP_COUNT * SLICE_COUNT,
+                                                CORNER_PERM_COUNT * SLICE_PERM_COUNT,
+                                                UD_EDGE_PERM_COUNT * SLICE_PERM_COUNT};
+    for (int p = 0; p < PRUNE_TABLES; p++) {
+        const PdbTableEntry* e = file_.find(PDB_KOCIEMBA, static_cast<uint32_t>(MOVE_TABLES + p), 0);
+        if (!e || e->entries != static_cast<uint64_t>(pruneSize[p]) || e->bytes != (e->entries + 1) / 2) return false;
+        prune_[p].attach(file_.tableData(*e), e->entries, static_cast<int>(e->maxDistance));
+    }
+    return true;
+}
+
+void KociembaSolver::buildTables() {
+    for (int t = 0; t < MOVE_TABLES; t++) {
+        std::vector<uint16_t>& table = owned_[t];
+        table.assign(static_cast<size_t>(COORD_SIZE[t]) * RUBIK_OP_COUNT, 0);
+        for (int v = 0; v < COORD_SIZE[t]; v++) {
+            CubieCube c;
+            setCoord(c, t, v);
+            // Three quarter turns in a row give the cw, half and prime results
+            for (int face = 0; face < 6; face++) {
+                CubieCube d = c;
+                static const int turnAfter[3] = {0, 2, 1};
+                for (int k = 0; k < 3; k++) {
+                    d.apply(makeRubikOp(face, 0));
+                    table[static_cast<size_t>(v) * RUBIK_OP_COUNT + face * 3 + turnAfter[k]] =
+                        static_cast<uint16_t>(getCoord(d, t));
+                }
+            }
+        }
+        move_[t] = table.data();
+    }
+    buildPrune(move_[KOCIEMBA_TWIST_MOVE], TWIST_COUNT, move_[KOCIEMBA_SLICE_MOVE], SLICE_COUNT, ALL_MOVES, prune_[0]);
+    buildPrune(move_[KOCIEMBA_FLIP_MOVE], FLIP_COUNT, move_[KOCIEMBA_SLICE_MOVE], SLICE_COUNT, ALL_MOVES, prune_[1]);
+    buildPrune(move_[KOCIEMBA_CORNER_PERM_MOVE], CORNER_PERM_COUNT, move_[KOCIEMBA_SLICE_PERM_MOVE],
+               SLICE_PERM_COUNT, PHASE2_MOVES, prune_[2]);
+    buildPrune(move_[KOCIEMBA_UD_EDGE_PERM_MOVE], UD_EDGE_PERM_COUNT, move_[KOCIEMBA_SLICE_PERM_MOVE],
+               SLICE_PERM_COUNT, PHASE2_MOVES, prune_[3]);
+}
+
+bool KociembaSolver::writeTables(const std::string& path) const {
+    std::vector<PdbTableSource> sources;
+    for (int t = 0; t < KOCIEMBA_TABLE_COUNT; t++) {
+        PdbTableSource s;
+        s.entry = PdbTableEntry();
+        s.entry.kind = PDB_KOCIEMBA;
+        s.entry.param = static_cast<uint32_t>(t);
+        if (t < MOVE_TABLES) {
+            s.entry.entries = static_cast<uint64_t>(COORD_SIZE[t]) * RUBIK_OP_COUNT;
+            s.entry.bytes = s.entry.entries * sizeof(uint16_t);
+            s.data = reinterpret_cast<const uint8_t*>(move_[t]);
+        } else {
+            const DistanceTable& d = prune_[t - MOVE_TABLES];
+            s.entry.entries = d.size();
+            s.entry.bytes = d.bytes();
+            s.entry.maxDistance = static_cast<uint32_t>(d.maxDistance());
+            s.data = d.data();
+        }
+        sources.push_back(s);
+    }
+    return writePdbFile(path, sources);
+}
+
+bool KociembaSolver::solve(const RubikCube& cube, std::vector<RubikOp>& solution, KociembaStats* stats,
+                           std::string* error) const {
+    auto t0 = Clock::now();
+    solution.clear();
+    KociembaStats local;
+    Search s;
+    if (!CubieCube::fromCube(cube, s.start, error)) {
+        if (stats) *stats = local;
+        return false;
+    }
+    s.move = move_;
+    s.prune = prune_;
+    s.maxLength = options_.maxLength < MAX_LENGTH ? options_.maxLength : MAX_LENGTH;
+    s.deadline = t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options_.timeLimit));
+    s.nodes = 0;
+    s.timedOut = false;
+    s.length1 = s.length = 0;
+
+    int twist = s.start.twist(), flip = s.start.flip(), slice = s.start.slice();
+    bool found = false;
+    for (int depth = s.phase1Bound(twist, flip, slice); depth <= s.maxLength && !found && !s.timedOut; depth++)
+        found = s.phase1(twist, flip, slice, 0, depth);
+    if (found) solution.assign(s.path, s.path + s.length);
+    else if (error) *error = s.timedOut ? "time limit reached" : "no solution within the length limit";
+
+    local.length = found ? s.length : 0;
+    local.phase1Length = found ? s.length1 : 0;
+    local.nodes = s.nodes;
+    local.timedOut = !found && s.timedOut;
+    local.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    if (stats) *stats = local;
+    return found;
+}
+
+bool KociembaSolver::solve(const RubikCube& cube, std::string& solution, KociembaStats* stats,
+                           std::string* error) const {
+    std::vector<RubikOp> ops;
+    bool ok = solve(cube, ops, stats, error);
+    solution = formatMoves(ops.data(), ops.size());
+    return ok;
+}
@@ -0,0 +1,75 @@
+// Kociemba Two-Phase Solver
+// Short RubikCube solutions: phase 1 reaches <U, D, R2, L2, F2, B2>, phase 2 solves inside it
+
+#ifndef KOCIEMBA_SOLVER_H
+#define KOCIEMBA_SOLVER_H
+
+#include "cubie_cube.h"
+#include "pattern_db.h"
+#include "pdb_file.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct KociembaOptions {
+    int maxLength;          // return the first solution at most this many moves long
+    double timeLimit;       // seconds before solve() gives up
+    std::string tablePath;  // table cache: mapped when valid, else built and written here; "" = memory only
+    KociembaOptions() : maxLength(21), timeLimit(10.0), tablePath("kociemba.tables") {}
+};
+
+struct KociembaStats {
+    int length;        // solution moves
+    int phase1Length;  // moves until the cube was in the phase-2 subgroup
+    uint64_t nodes;    // phase 1 + phase 2 nodes
+    double seconds;
+    bool timedOut;     // stopped by KociembaOptions::timeLimit
+    KociembaStats() : length(0), phase1Length(0), nodes(0), seconds(0.0), timedOut(false) {}
+};
+
+// Table ids in the cache file (PdbTableEntry::param of PDB_KOCIEMBA entries)
+enum KociembaTable {
+    KOCIEMBA_TWIST_MOVE, KOCIEMBA_FLIP_MOVE, KOCIEMBA_SLICE_MOVE,
+    KOCIEMBA_CORNER_PERM_MOVE, KOCIEMBA_UD_EDGE_PERM_MOVE, KOCIEMBA_SLICE_PERM_MOVE,
+    KOCIEMBA_TWIST_SLICE_PRUNE, KOCIEMBA_FLIP_SLICE_PRUNE,
+    KOCIEMBA_CORNER_SLICE_PRUNE, KOCIEMBA_EDGE_SLICE_PRUNE,
+    KOCIEMBA_TABLE_COUNT
+};
+
+// Each search phase is IDA* over coordinate move tables (coordinate x 18 opcodes, uint16)
+// with the max of two nibble pruning tables as its bound: twist x slice and flip x slice
+// in phase 1, corner perm x slice perm and U/D edge perm x slice perm in phase 2.
+// Successors follow the canonical order from move_simplifier.h. Phase 1 solutions are
+// tried in order of length, each followed by the shortest phase 2 that fits in maxLength.
+class KociembaSolver {
+public:
+    explicit KociembaSolver(const KociembaOptions& options = KociembaOptions());
+
+    // False for unreachable colorings (error says why) or when nothing fits in
+    // maxLength / timeLimit. The tables are read-only, so threads may share one solver.
+    bool solve(const RubikCube& cube, std::vector<RubikOp>& solution, KociembaStats* stats = nullptr,
+               std::string* error = nullptr) const;
+    // Same, as space-separated RubikCube::applyMove tokens ("R U' F2 ...")
+    bool solve(const RubikCube& cube, std::string& solution, KociembaStats* stats = nullptr,
+               std::string* error = nullptr) const;
+
+    // True when the tables came from options.tablePath rather than a fresh build
+    bool mappedTables() const { return file_.isOpen(); }
+
+private:
+    static const int MOVE_TABLES = KOCIEMBA_TWIST_SLICE_PRUNE;
+    static const int PRUNE_TABLES = KOCIEMBA_TABLE_COUNT - MOVE_TABLES;
+
+    KociembaOptions options_;
+    PdbFile file_;
+    // Move tables point into file_ or owned_; pruning tables attach or adopt likewise
+    std::vector<uint16_t> owned_[MOVE_TABLES];
+    const uint16_t* move_[MOVE_TABLES];
+    DistanceTable prune_[PRUNE_TABLES];
+
+    bool attachTables();
+    void buildTables();
+    bool writeTables(const std::string& path) const;
+};
+
+#endif // KOCIEMBA_SOLVER_H
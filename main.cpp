@@ -6,11 +6,20 @@
 #include <iostream>
 #include <optional>
 #include <exception>
+#include <array>
+#include <string>
+#include <vector>
 #include "rubik_cube.h"
 #include "renderer.h"
+#include "move_journal.h"
+#include "puzzle_gallery.h"
 
 constexpr int WINDOW_WIDTH = 1400;
 constexpr int WINDOW_HEIGHT = 1000;
+constexpr size_t GALLERY_POPULATION_SIZE = 4096;
+constexpr int GALLERY_SCRAMBLE_MOVES = 30;
+
+enum GalleryMode { GALLERY_OFF, GALLERY_HISTORY, GALLERY_POPULATION };
 
 class TesseractGame {
 private:
@@ -28,6 +37,11 @@ private:
     sf::Clock animationClock;
     const float ANIMATION_SPEED = 300.0f;
     int currentLayer_;
+    MoveJournal journal;
+    std::vector<std::array<Vec4, 16>> outerCheckpoints_;  // renderer outer positions per journal checkpoint
+    PuzzleGallery gallery;
+    GalleryMode galleryMode_;
+    uint64_t populationSeed_;
 
     bool loadFont() {
         if (font.openFromFile("C:/Windows/Fonts/arial.ttf"))
@@ -50,6 +64,10 @@ private:
                 "4D cube: Q/W/E/R/T/Y\n"
                 "Shift + key: Counter-clockwise\n"
                 "\n"
+                "Backspace: Undo | Enter: Redo\n"
+                "Home / End: Jump to start / end of history\n"
+                "G: Gallery of history | Shift + G: Gallery of scrambles\n"
+                "\n"
                 "Space: Reset | I: Toggle UI",
                 18);
             instructionText->setFillColor(sf::Color::White);
@@ -61,15 +79,111 @@ private:
     void updateUI() {
         if (!statusText) return;
         std::string status = puzzle.isSolved() ? "Solved " : "";
+        if (journal.size() > 0)
+            status += "Move " + std::to_string(journal.position()) + "/" + std::to_string(journal.size());
+        if (galleryMode_ != GALLERY_OFF) {
+            const GalleryStats& stats = gallery.stats();
+            status += " Gallery: " + std::to_string(stats.tiles) + " puzzles";
+            if (stats.pending > 0) status += ", " + std::to_string(stats.pending) + " to draw";
+        }
         statusText->setString(status);
     }
 
 public:
-    TesseractGame() : isDragging(false), showInstructions(true), currentLayer_(0) {
+    TesseractGame()
+        : isDragging(false), showInstructions(true), currentLayer_(0), galleryMode_(GALLERY_OFF), populationSeed_(0) {
         loadFont();
         setupUI();
         renderer.initialize();
+        std::string galleryError;
+        if (!gallery.initialize(&galleryError)) std::cerr << "Gallery unavailable: " << galleryError << std::endl;
         puzzle.scramble();
+        resetJournal();
+        updateUI();
+    }
+
+    void resetJournal() {
+        journal.reset(puzzle, innerCube);
+        outerCheckpoints_.assign(1, std::array<Vec4, 16>());
+        renderer.getOuterPositions(outerCheckpoints_[0].data());
+    }
+
+    void recordMove(uint8_t entry) {
+        bool appending = journal.position() == journal.size();
+        bool checkpoint = journal.record(entry, puzzle, innerCube);
+        outerCheckpoints_.resize(journal.checkpointCount());
+        if (checkpoint) renderer.getOuterPositions(outerCheckpoints_.back().data());
+        if (galleryMode_ != GALLERY_HISTORY) return;
+        if (appending) {
+            // Earlier tiles are unchanged: add the one for the new position
+            gallery.resize(journal.size() + 1);
+            gallery.setPuzzle(journal.position(), puzzle.getState());
+        } else {
+            showHistoryGallery();  // the redo tail was cut
+        }
+    }
+
+    // One tile per journal position, walked out from the current puzzle in both directions
+    // without moving the journal. Tiles already showing their state are not redrawn. A full
+    // replay, so only for G, Space and a cut redo tail; recordMove appends otherwise.
+    void showHistoryGallery() {
+        gallery.resize(journal.size() + 1);
+        TesseractPuzzle replay = puzzle;
+        RubikCube replayCube = innerCube;
+        gallery.setPuzzle(journal.position(), replay.getState());
+        for (size_t i = journal.position(); i > 0; i--) {
+            MoveJournal::applyEntry(inverseEntry(journal.entry(i - 1)), replay, replayCube);
+            gallery.setPuzzle(i - 1, replay.getState());
+        }
+        replay = puzzle;
+        replayCube = innerCube;
+        for (size_t i = journal.position(); i < journal.size(); i++) {
+            MoveJournal::applyEntry(journal.entry(i), replay, replayCube);
+            gallery.setPuzzle(i + 1, replay.getState());
+        }
+    }
+
+    // A batch of independent scrambles: Philox stream i of the population seed for tile i
+    void showPopulationGallery() {
+        gallery.resize(GALLERY_POPULATION_SIZE);
+        TesseractOp ops[GALLERY_SCRAMBLE_MOVES];
+        for (size_t i = 0; i < GALLERY_POPULATION_SIZE; i++) {
+            TesseractPuzzle scrambled;
+            TesseractPuzzle::scrambleMoves(populationSeed_, i, GALLERY_SCRAMBLE_MOVES, ops);
+            scrambled.apply(ops, GALLERY_SCRAMBLE_MOVES);
+            gallery.setPuzzle(i, scrambled.getState());
+        }
+    }
+
+    // Apply a journal entry without animation, keeping the outer vertices in step
+    void applyJournalEntry(uint8_t entry) {
+        MoveJournal::applyEntry(entry, puzzle, innerCube);
+        if (isRubikEntry(entry)) {
+            RubikOp op = entryRubikOp(entry);
+            renderer.commitOuterRubikRotation(opFace(op), opTurn(op) == 0);
+        }
+    }
+
+    void undoMove() {
+        uint8_t entry;
+        if (journal.undo(entry)) applyJournalEntry(inverseEntry(entry));
+        updateUI();
+    }
+
+    void redoMove() {
+        uint8_t entry;
+        if (journal.redo(entry)) applyJournalEntry(entry);
+        updateUI();
+    }
+
+    void seekMove(size_t target) {
+        if (target > journal.size()) return;
+        renderer.setOuterPositions(outerCheckpoints_[target / journal.checkpointInterval()].data());
+        journal.seek(target, puzzle, innerCube, [this](uint8_t entry) {
+            if (!isRubikEntry(entry)) return;
+            RubikOp op = entryRubikOp(entry);
+            renderer.commitOuterRubikRotation(opFace(op), opTurn(op) == 0);
+        });
         updateUI();
     }
 
@@ -131,6 +245,7 @@ public:
                 case BACK:  rubikAnim.clockwise ? innerCube.rotateB() : innerCube.rotateBPrime(); break;
             }
             renderer.commitOuterRubikRotation(rubikAnim.face, rubikAnim.clockwise);
+            recordMove(journalEntry(makeRubikOp(rubikAnim.face, rubikAnim.clockwise ? 0 : 1)));
         }
         updateUI();
     }
@@ -148,6 +263,7 @@ public:
     void applyRotationToPuzzle() {
         if (animation.plane >= 0 && animation.layer >= 0) {
             puzzle.rotateSlice(animation.plane, animation.layer, animation.clockwise);
+            recordMove(journalEntry(makeTesseractOp(animation.plane, animation.layer, animation.clockwise)));
         }
         updateUI();
     }
@@ -176,12 +292,32 @@ public:
             case sf::Keyboard::Key::Num2: currentLayer_ = 1; updateUI(); break;
             case sf::Keyboard::Key::Num3: currentLayer_ = 2; updateUI(); break;
             case sf::Keyboard::Key::Num4: currentLayer_ = 3; updateUI(); break;
+            case sf::Keyboard::Key::Backspace: undoMove(); break;
+            case sf::Keyboard::Key::Enter: redoMove(); break;
+            case sf::Keyboard::Key::Home: seekMove(0); break;
+            case sf::Keyboard::Key::End: seekMove(journal.size()); break;
             case sf::Keyboard::Key::Space:
                 puzzle.reset();
                 innerCube.reset();
                 renderer.resetOuterPositions();
                 animation.isAnimating = false;
                 rubikAnim.isAnimating = false;
+                resetJournal();
+                if (galleryMode_ == GALLERY_HISTORY) showHistoryGallery();
+                updateUI();
+                break;
+            case sf::Keyboard::Key::G:
+                if (!gallery.isAvailable()) break;
+                if (shift) {
+                    populationSeed_++;
+                    galleryMode_ = GALLERY_POPULATION;
+                    showPopulationGallery();
+                } else if (galleryMode_ != GALLERY_OFF) {
+                    galleryMode_ = GALLERY_OFF;
+                } else {
+                    galleryMode_ = GALLERY_HISTORY;
+                    showHistoryGallery();
+                }
                 updateUI();
                 break;
             case sf::Keyboard::Key::I:
@@ -216,7 +352,13 @@ public:
 
     void render(sf::RenderWindow& window) {
         if (!window.setActive(true)) return;  // Ensure OpenGL context is active before GL calls
-        renderer.render(puzzle, &innerCube, static_cast<int>(window.getSize().x), static_cast<int>(window.getSize().y), animation, rubikAnim);
+        int width = static_cast<int>(window.getSize().x), height = static_cast<int>(window.getSize().y);
+        if (galleryMode_ != GALLERY_OFF && gallery.isAvailable()) {
+            gallery.render(width, height);
+            updateUI();  // tiles still to draw
+        } else {
+            renderer.render(puzzle, &innerCube, width, height, animation, rubikAnim);
+        }
         window.pushGLStates();
         if (statusText) {
             window.draw(*statusText);
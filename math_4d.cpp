@@ -3,64 +3,138 @@
 #include "math_4d.h"
 #include <cmath>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MATH_AVX 1
+#define MATH_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MATH_SSE 1
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846f
 #endif
 
-Mat4x4::Mat4x4() {
-    for (int i = 0; i < 16; i++) m[i] = 0.0f;
-}
-
-Mat4x4 Mat4x4::identity() {
-    Mat4x4 r;
-    r.m[0] = r.m[5] = r.m[10] = r.m[15] = 1.0f;
+Mat4x4 rotate4D(int plane, float angleDeg) {
+    float rad = angleDeg * (float)(M_PI / 180.0);
+    Mat4x4 r = Mat4x4::identity();
+    if (plane < 0 || plane >= planeCount(4)) return r;
+    givensRotate(r, planeAxes(4, plane), std::cos(rad), std::sin(rad));
     return r;
 }
 
-// Build 4D rotation matrix in plane (i,j) by angle (radians)
-// Column-major: m[col*4+row]
-static void setRotation2D(Mat4x4& out, int i, int j, float c, float s) {
-    out = Mat4x4::identity();
-    out.m[i * 4 + i] = c;
-    out.m[i * 4 + j] = -s;
-    out.m[j * 4 + i] = s;
-    out.m[j * 4 + j] = c;
+#if defined(MATH_SSE)
+// m * v as four broadcast lanes times the matrix columns
+static inline __m128 mulColumns(const __m128 col[4], __m128 v) {
+    __m128 r = _mm_mul_ps(col[0], _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+    r = _mm_add_ps(r, _mm_mul_ps(col[1], _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+    r = _mm_add_ps(r, _mm_mul_ps(col[2], _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+    return _mm_add_ps(r, _mm_mul_ps(col[3], _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
 }
 
-Mat4x4 rotate4D(int plane, float angleDeg) {
-    float rad = angleDeg * (float)(M_PI / 180.0);
-    float c = std::cos(rad);
-    float s = std::sin(rad);
-    Mat4x4 r;
-    switch (plane) {
-        case 0: setRotation2D(r, 0, 1, c, s); break; // XY
-        case 1: setRotation2D(r, 0, 2, c, s); break; // XZ
-        case 2: setRotation2D(r, 0, 3, c, s); break; // XW
-        case 3: setRotation2D(r, 1, 2, c, s); break; // YZ
-        case 4: setRotation2D(r, 1, 3, c, s); break; // YW
-        case 5: setRotation2D(r, 2, 3, c, s); break; // ZW
-        default: r = Mat4x4::identity(); break;
-    }
-    return r;
+static inline void loadColumns(const Mat4x4& m, __m128 col[4]) {
+    for (int c = 0; c < 4; c++) col[c] = _mm_load_ps(m.m + c * 4);
 }
+#endif
 
 Vec4 matMul(const Mat4x4& m, const Vec4& v) {
+#if defined(MATH_SSE)
+    __m128 col[4];
+    loadColumns(m, col);
+    Vec4 r;
+    _mm_store_ps(&r.x, mulColumns(col, _mm_load_ps(&v.x)));
+    return r;
+#else
     return Vec4(
         m.m[0] * v.x + m.m[4] * v.y + m.m[8] * v.z + m.m[12] * v.w,
         m.m[1] * v.x + m.m[5] * v.y + m.m[9] * v.z + m.m[13] * v.w,
         m.m[2] * v.x + m.m[6] * v.y + m.m[10] * v.z + m.m[14] * v.w,
         m.m[3] * v.x + m.m[7] * v.y + m.m[11] * v.z + m.m[15] * v.w
     );
+#endif
 }
 
+// Column c of a * b is a * (column c of b)
 Mat4x4 matMul(const Mat4x4& a, const Mat4x4& b) {
     Mat4x4 r;
+#if defined(MATH_SSE)
+    __m128 col[4];
+    loadColumns(a, col);
+    for (int c = 0; c < 4; c++) _mm_store_ps(r.m + c * 4, mulColumns(col, _mm_load_ps(b.m + c * 4)));
+#else
     for (int col = 0; col < 4; col++) {
         for (int row = 0; row < 4; row++) {
-            r.m[col * 4 + row] = 0.0f;
-            for (int k = 0; k < 4; k++)
-                r.m[col * 4 + row] += a.m[k * 4 + row] * b.m[col * 4 + k];
+            float sum = a.m[row] * b.m[col * 4];
+            for (int k = 1; k < 4; k++) sum += a.m[k * 4 + row] * b.m[col * 4 + k];
+            r.m[col * 4 + row] = sum;
         }
     }
+#endif
     return r;
 }
+
+void transformPoints(const Mat4x4& m, const Vec4* in, Vec4* out, size_t n) {
+    size_t i = 0;
+#if defined(MATH_AVX)
+    // Two points per 256-bit register: each column is broadcast to both halves
+    __m256 col[4];
+    for (int c = 0; c < 4; c++) col[c] = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m + c * 4));
+    for (; i + 2 <= n; i += 2) {
+        __m256 v = _mm256_loadu_ps(&in[i].x);
+        __m256 r = _mm256_mul_ps(col[0], _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(col[1], _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm256_add_ps(r, _mm256_mul_ps(col[2], _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2))));
+        r = _mm256_add_ps(r, _mm256_mul_ps(col[3], _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3))));
+        _mm256_storeu_ps(&out[i].x, r);
+    }
+#endif
+#if defined(MATH_SSE)
+    __m128 cols[4];
+    loadColumns(m, cols);
+    for (; i < n; i++) _mm_store_ps(&out[i].x, mulColumns(cols, _mm_load_ps(&in[i].x)));
+#else
+    for (; i < n; i++) out[i] = matMul(m, in[i]);
+#endif
+}
+
+void transformPoints(const Mat4x4& m, const Vec4SoA& in, const Vec4SoA& out, size_t n) {
+    size_t i = 0;
+#if defined(MATH_AVX)
+    __m256 e8[16];
+    for (int k = 0; k < 16; k++) e8[k] = _mm256_set1_ps(m.m[k]);
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(in.x + i), y = _mm256_loadu_ps(in.y + i);
+        __m256 z = _mm256_loadu_ps(in.z + i), w = _mm256_loadu_ps(in.w + i);
+        float* dst[4] = {out.x + i, out.y + i, out.z + i, out.w + i};
+        for (int row = 0; row < 4; row++) {
+            __m256 r = _mm256_mul_ps(e8[row], x);
+            r = _mm256_add_ps(r, _mm256_mul_ps(e8[4 + row], y));
+            r = _mm256_add_ps(r, _mm256_mul_ps(e8[8 + row], z));
+            _mm256_storeu_ps(dst[row], _mm256_add_ps(r, _mm256_mul_ps(e8[12 + row], w)));
+        }
+    }
+#endif
+#if defined(MATH_SSE)
+    __m128 e4[16];
+    for (int k = 0; k < 16; k++) e4[k] = _mm_set1_ps(m.m[k]);
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i);
+        __m128 z = _mm_loadu_ps(in.z + i), w = _mm_loadu_ps(in.w + i);
+        float* dst[4] = {out.x + i, out.y + i, out.z + i, out.w + i};
+        for (int row = 0; row < 4; row++) {
+            __m128 r = _mm_mul_ps(e4[row], x);
+            r = _mm_add_ps(r, _mm_mul_ps(e4[4 + row], y));
+            r = _mm_add_ps(r, _mm_mul_ps(e4[8 + row], z));
+            _mm_storeu_ps(dst[row], _mm_add_ps(r, _mm_mul_ps(e4[12 + row], w)));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        Vec4 v = matMul(m, Vec4(in.x[i], in.y[i], in.z[i], in.w[i]));
+        out.x[i] = v.x;
+        out.y[i] = v.y;
+        out.z[i] = v.z;
+        out.w[i] = v.w;
+    }
+}
@@ -4,28 +4,42 @@
 #ifndef MATH_4D_H
 #define MATH_4D_H
 
-// 4D vector
-struct Vec4 {
-    float x, y, z, w;
-    Vec4() : x(0), y(0), z(0), w(0) {}
-    Vec4(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
-};
+#include "math_nd.h"
+#include <cstddef>
 
-// 4x4 matrix (column-major for OpenGL compatibility)
-struct Mat4x4 {
-    float m[16];
-    Mat4x4();
-    static Mat4x4 identity();
-};
+// 4D vector (x, y, z, w); 16-byte aligned so a Vec4 is one SSE register load
+typedef Vec<4, float> Vec4;
+
+// 4x4 matrix (column-major for OpenGL compatibility); each column is an aligned Vec4
+typedef Mat<4, float> Mat4x4;
 
 // 4D rotation in plane (axis1, axis2) by angle in degrees
 // Planes: XY=0, XZ=1, XW=2, YZ=3, YW=4, ZW=5
 Mat4x4 rotate4D(int plane, float angleDeg);
 
-// Matrix-vector multiply: out = m * v
+// Matrix-vector multiply: out = m * v. These SIMD overloads take precedence over the
+// math_nd.h templates for 4D.
 Vec4 matMul(const Mat4x4& m, const Vec4& v);
 
 // Matrix multiply: out = a * b
 Mat4x4 matMul(const Mat4x4& a, const Mat4x4& b);
 
+// Batch transforms. matMul and these use AVX when the build enables it (TESSERACT_AVX2),
+// SSE on any x86-64 build and scalar code elsewhere, always adding the four column
+// products in the same order, so every path gives the same floats.
+
+// out[i] = m * in[i] for i in [0, n); in == out is allowed
+void transformPoints(const Mat4x4& m, const Vec4* in, Vec4* out, size_t n);
+
+// Structure-of-arrays points: coordinate i of point k is x[k], y[k], z[k], w[k]
+struct Vec4SoA {
+    float* x;
+    float* y;
+    float* z;
+    float* w;
+};
+
+// Same as above over SoA streams (4 or 8 points per instruction); in == out is allowed
+void transformPoints(const Mat4x4& m, const Vec4SoA& in, const Vec4SoA& out, size_t n);
+
 #endif // MATH_4D_H
@@ -0,0 +1,180 @@
+// N-Dimensional Math Templates
+// Vec<N, T>, Mat<N, T>, rotation-plane enumeration, Givens rotations and N -> N-1 perspective
+// projection. Every loop runs over the compile-time N through unroll<N>, so each N used
+// (3, 4 and 5 in this tree) gets straight-line code with no loop counters.
+
+#ifndef MATH_ND_H
+#define MATH_ND_H
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace nd_detail {
+template <typename F, size_t... I>
+inline void unroll(F&& f, std::index_sequence<I...>) {
+    (f(std::integral_constant<int, static_cast<int>(I)>()), ...);
+}
+
+// 16-byte alignment whenever the object fills whole SSE registers
+template <typename T>
+constexpr size_t alignFor(size_t count) {
+    return (count * sizeof(T)) % 16 == 0 ? 16 : alignof(T);
+}
+} // namespace nd_detail
+
+// f(0), f(1), ..., f(N - 1), each index an integral_constant usable as an int
+template <int N, typename F>
+inline void unroll(F&& f) {
+    nd_detail::unroll(f, std::make_index_sequence<N>());
+}
+
+template <int N, typename T = float>
+struct alignas(nd_detail::alignFor<T>(N)) Vec {
+    static_assert(N >= 1, "Vec needs at least one component");
+    T v[N];
+    Vec() : v() {}
+    template <typename... A, typename = std::enable_if_t<sizeof...(A) == N>>
+    Vec(A... a) : v{static_cast<T>(a)...} {}
+    T& operator[](int i) { return v[i]; }
+    const T& operator[](int i) const { return v[i]; }
+};
+
+// Vec<4, float> is the renderer's Vec4: named x, y, z, w and one SSE register load
+template <>
+struct alignas(16) Vec<4, float> {
+    float x, y, z, w;
+    Vec() : x(0), y(0), z(0), w(0) {}
+    Vec(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+    float& operator[](int i) { return (&x)[i]; }
+    const float& operator[](int i) const { return (&x)[i]; }
+};
+static_assert(sizeof(Vec<4, float>) == 4 * sizeof(float), "Vec4 components must be contiguous");
+
+// N x N matrix, column-major: m[col * N + row]
+template <int N, typename T = float>
+struct alignas(nd_detail::alignFor<T>(N * N)) Mat {
+    T m[N * N];
+    Mat() : m() {}
+    static Mat identity() {
+        Mat r;
+        unroll<N>([&](auto i) { r.m[i * N + i] = T(1); });
+        return r;
+    }
+};
+
+// Rotation planes of R^n: one per axis pair, n (n - 1) / 2 in all
+constexpr int planeCount(int n) { return n * (n - 1) / 2; }
+
+struct PlaneAxes {
+    int first, second;  // first < second
+};
+
+// Planes in lexicographic axis order (0,1), (0,2), ..., (n-2,n-1); for n = 4 that is
+// XY, XZ, XW, YZ, YW, ZW, the rotate4D numbering. {-1, -1} when out of range.
+constexpr PlaneAxes planeAxes(int n, int plane) {
+    for (int i = 0; i < n - 1 && plane >= 0; i++) {
+        if (plane < n - 1 - i) return PlaneAxes{i, i + 1 + plane};
+        plane -= n - 1 - i;
+    }
+    return PlaneAxes{-1, -1};
+}
+
+// Inverse of planeAxes for axes i < j
+constexpr int planeIndex(int n, int i, int j) {
+    return i * (2 * n - i - 1) / 2 + (j - i - 1);
+}
+
+static_assert(planeCount(4) == 6 && planeAxes(4, 2).first == 0 && planeAxes(4, 2).second == 3 &&
+                  planeAxes(4, 5).first == 2 && planeIndex(5, 3, 4) == 9,
+              "plane enumeration");
+
+// out = m * v, summing the column products left to right (the same order as matMul on Mat4x4)
+template <int N, typename T>
+inline Vec<N, T> matMul(const Mat<N, T>& m, const Vec<N, T>& v) {
+    Vec<N, T> r;
+    unroll<N>([&](auto row) {
+        T sum = m.m[row] * v[0];
+        unroll<N - 1>([&](auto k) { sum += m.m[(k + 1) * N + row] * v[k + 1]; });
+        r[row] = sum;
+    });
+    return r;
+}
+
+// out = a * b; column c of the product is a * (column c of b)
+template <int N, typename T>
+inline Mat<N, T> matMul(const Mat<N, T>& a, const Mat<N, T>& b) {
+    Mat<N, T> r;
+    unroll<N>([&](auto col) {
+        unroll<N>([&](auto row) {
+            T sum = a.m[row] * b.m[col * N];
+            unroll<N - 1>([&](auto k) { sum += a.m[(k + 1) * N + row] * b.m[col * N + k + 1]; });
+            r.m[col * N + row] = sum;
+        });
+    });
+    return r;
+}
+
+// Givens rotation by (c, s) = (cos, sin) of the angle in plane (i, j), i < j:
+//   x_i' = c x_i + s x_j,  x_j' = c x_j - s x_i
+// (rotate4D's sign convention). Applied to a matrix it left-multiplies by the rotation,
+// touching rows i and j only: 4N multiplies instead of the N^3 of a full matMul.
+template <int N, typename T>
+inline void givensRotate(Vec<N, T>& v, PlaneAxes p, T c, T s) {
+    T a = v[p.first], b = v[p.second];
+    v[p.first] = c * a + s * b;
+    v[p.second] = c * b - s * a;
+}
+
+template <int N, typename T>
+inline void givensRotate(Mat<N, T>& m, PlaneAxes p, T c, T s) {
+    unroll<N>([&](auto col) {
+        T a = m.m[col * N + p.first], b = m.m[col * N + p.second];
+        m.m[col * N + p.first] = c * a + s * b;
+        m.m[col * N + p.second] = c * b - s * a;
+    });
+}
+
+// Plane fixed at compile time, so the row offsets are constants too
+template <int Plane, int N, typename T>
+inline void givensRotate(Mat<N, T>& m, T c, T s) {
+    static_assert(Plane >= 0 && Plane < planeCount(N), "no such rotation plane");
+    constexpr PlaneAxes p = planeAxes(N, Plane);
+    unroll<N>([&](auto col) {
+        T a = m.m[col * N + p.first], b = m.m[col * N + p.second];
+        m.m[col * N + p.first] = c * a + s * b;
+        m.m[col * N + p.second] = c * b - s * a;
+    });
+}
+
+// Rotation matrix of `plane` by angleDeg; the identity for a plane out of range
+template <int N, typename T = float>
+inline Mat<N, T> planeRotation(int plane, T angleDeg) {
+    Mat<N, T> r = Mat<N, T>::identity();
+    if (plane < 0 || plane >= planeCount(N)) return r;
+    T rad = angleDeg * static_cast<T>(3.14159265358979323846 / 180.0);
+    givensRotate(r, planeAxes(N, plane), static_cast<T>(std::cos(rad)), static_cast<T>(std::sin(rad)));
+    return r;
+}
+
+// Perspective projection along the last axis onto the hyperplane at that distance:
+// the first N - 1 coordinates scaled by distance / (distance + p[N - 1]).
+// For N = 4 this is project4Dto3D without its trailing w = 0.
+template <int N, typename T>
+inline Vec<N - 1, T> projectPerspective(const Vec<N, T>& p, T distance) {
+    static_assert(N >= 2, "nothing to project onto");
+    T denom = distance + p[N - 1];
+    if (std::fabs(denom) < T(1e-6)) denom = T(1e-6);
+    T scale = distance / denom;
+    Vec<N - 1, T> r;
+    unroll<N - 1>([&](auto i) { r[i] = p[i] * scale; });
+    return r;
+}
+
+typedef Vec<3, float> Vec3f;
+typedef Vec<5, float> Vec5f;
+typedef Mat<3, float> Mat3f;
+typedef Mat<5, float> Mat5f;
+
+#endif // MATH_ND_H
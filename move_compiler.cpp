@@ -0,0 +1,140 @@
+// Move Sequence Compiler Implementation
+
+#include "move_compiler.h"
+#include "bit_ops.h"
+
+static uint64_t gcd64(uint64_t a, uint64_t b) {
+    while (b) { uint64_t t = a % b; a = b; b = t; }
+    return a;
+}
+
+StickerPermutation::StickerPermutation() {
+    for (int i = 0; i < TESSERACT_STICKERS; i++) src_[i] = static_cast<uint8_t>(i);
+    build();
+}
+
+void StickerPermutation::build() {
+    keep_ = 0;
+    groups_ = 0;
+    for (int dst = 0; dst < TESSERACT_STICKERS; dst++) {
+        if (src_[dst] == dst) { keep_ |= uint64_t(1) << dst; continue; }
+        int r = (dst - src_[dst]) & 63;
+        int g = 0;
+        while (g < groups_ && rot_[g] != r) g++;
+        if (g == groups_) { rot_[g] = static_cast<uint8_t>(r); mask_[g] = 0; groups_++; }
+        mask_[g] |= uint64_t(1) << src_[dst];
+    }
+}
+
+StickerPermutation StickerPermutation::fromSlice(int plane, int layer, bool clockwise) {
+    StickerPermutation p;
+    TesseractPuzzle::slicePermutation(plane, layer, clockwise, p.src_);
+    p.build();
+    return p;
+}
+
+StickerPermutation StickerPermutation::compile(const TesseractOp* ops, size_t count) {
+    StickerPermutation acc;
+    for (size_t k = 0; k < count; k++) {
+        uint8_t move[TESSERACT_STICKERS];
+        TesseractPuzzle::slicePermutation(opPlane(ops[k]), opLayer(ops[k]), opClockwise(ops[k]), move);
+        uint8_t next[TESSERACT_STICKERS];
+        for (int i = 0; i < TESSERACT_STICKERS; i++) next[i] = acc.src_[move[i]];
+        for (int i = 0; i < TESSERACT_STICKERS; i++) acc.src_[i] = next[i];
+    }
+    acc.build();
+    return acc;
+}
+
+bool StickerPermutation::compile(const std::string& moves, StickerPermutation& out) {
+    StickerPermutation acc;
+    std::string_view text(moves);
+    TesseractOp chunk[64];
+    while (true) {
+        size_t count = 0, consumed = 0;
+        if (!parseTesseractMoves(text, chunk, 64, count, consumed)) return false;
+        acc = acc.then(compile(chunk, count));
+        if (count < 64) break;
+        text.remove_prefix(consumed);
+    }
+    out = acc;
+    return true;
+}
+
+StickerPermutation StickerPermutation::then(const StickerPermutation& next) const {
+    StickerPermutation r;
+    for (int i = 0; i < TESSERACT_STICKERS; i++) r.src_[i] = src_[next.src_[i]];
+    r.build();
+    return r;
+}
+
+StickerPermutation StickerPermutation::inverse() const {
+    StickerPermutation r;
+    for (int i = 0; i < TESSERACT_STICKERS; i++) r.src_[src_[i]] = static_cast<uint8_t>(i);
+    r.build();
+    return r;
+}
+
+StickerPermutation StickerPermutation::power(long long n) const {
+    StickerPermutation base = n < 0 ? inverse() : *this;
+    unsigned long long e = n < 0 ? 0ull - static_cast<unsigned long long>(n) : static_cast<unsigned long long>(n);
+    // Reduce by the order so huge exponents cost at most ~log2(order) squarings
+    e %= base.order();
+    StickerPermutation result;
+    while (e) {
+        if (e & 1) result = result.then(base);
+        base = base.then(base);
+        e >>= 1;
+    }
+    return result;
+}
+
+void StickerPermutation::cycleLengths(std::vector<int>& out) const {
+    out.clear();
+    bool seen[TESSERACT_STICKERS] = {false};
+    for (int i = 0; i < TESSERACT_STICKERS; i++) {
+        if (seen[i]) continue;
+        int len = 0;
+        for (int j = i; !seen[j]; j = src_[j]) { seen[j] = true; len++; }
+        if (len > 1) out.push_back(len);
+    }
+}
+
+uint64_t StickerPermutation::order() const {
+    std::vector<int> cycles;
+    cycleLengths(cycles);
+    uint64_t ord = 1;
+    for (int len : cycles) ord = ord / gcd64(ord, static_cast<uint64_t>(len)) * static_cast<uint64_t>(len);
+    return ord;
+}
+
+bool StickerPermutation::isIdentity() const {
+    return groups_ == 0;
+}
+
+void StickerPermutation::apply(TesseractState& state) const {
+    uint64_t p0 = state.planes[0], p1 = state.planes[1], p2 = state.planes[2];
+    uint64_t r0 = p0 & keep_, r1 = p1 & keep_, r2 = p2 & keep_;
+    for (int g = 0; g < groups_; g++) {
+        uint64_t m = mask_[g];
+        int r = rot_[g];
+        r0 |= rotl64(p0 & m, r);
+        r1 |= rotl64(p1 & m, r);
+        r2 |= rotl64(p2 & m, r);
+    }
+    state.planes[0] = r0;
+    state.planes[1] = r1;
+    state.planes[2] = r2;
+}
+
+void StickerPermutation::apply(TesseractPuzzle& puzzle) const {
+    TesseractState s = puzzle.getState();
+    apply(s);
+    puzzle.setState(s);
+}
+
+bool StickerPermutation::operator==(const StickerPermutation& o) const {
+    for (int i = 0; i < TESSERACT_STICKERS; i++)
+        if (src_[i] != o.src_[i]) return false;
+    return true;
+}
@@ -0,0 +1,51 @@
+// Move Sequence Compiler
+// Fuses a tesseract move sequence into one permutation of the 64 sticker slots
+
+#ifndef MOVE_COMPILER_H
+#define MOVE_COMPILER_H
+
+#include "tesseract_model.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sticker permutation stored as a gather: new[dst] = old[src[dst]].
+// Applying it costs one pass of masked rotations, however many moves it fuses.
+class StickerPermutation {
+public:
+    StickerPermutation();  // identity
+
+    static StickerPermutation fromSlice(int plane, int layer, bool clockwise);
+    static StickerPermutation compile(const TesseractOp* ops, size_t count);
+    // Compile whitespace-separated moves ("XY0 ZW1' XW3"); returns false on a bad token
+    static bool compile(const std::string& moves, StickerPermutation& out);
+
+    // Composition: apply this permutation, then next
+    StickerPermutation then(const StickerPermutation& next) const;
+    StickerPermutation inverse() const;
+    // n-th power by repeated squaring; negative n raises the inverse
+    StickerPermutation power(long long n) const;
+    // Lengths of the non-trivial cycles, and their lcm (the permutation's order)
+    void cycleLengths(std::vector<int>& out) const;
+    uint64_t order() const;
+    bool isIdentity() const;
+
+    int source(int dst) const { return src_[dst]; }
+    void apply(TesseractState& state) const;
+    void apply(TesseractPuzzle& puzzle) const;
+
+    bool operator==(const StickerPermutation& o) const;
+    bool operator!=(const StickerPermutation& o) const { return !(*this == o); }
+
+private:
+    uint8_t src_[TESSERACT_STICKERS];
+    // Masked-rotation form of src_: stickers grouped by (dst - src) mod 64
+    uint64_t keep_;
+    int groups_;
+    uint64_t mask_[TESSERACT_STICKERS];
+    uint8_t rot_[TESSERACT_STICKERS];
+
+    void build();
+};
+
+#endif // MOVE_COMPILER_H
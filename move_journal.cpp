@@ -0,0 +1,74 @@
+// Move Journal Implementation
+
+#include "move_journal.h"
+
+// 21 three-bit colors per word
+static const int FACELETS_PER_WORD = 21;
+
+MoveJournal::MoveJournal(size_t checkpointInterval)
+    : interval_(checkpointInterval > 0 ? checkpointInterval : 1), cursor_(0) {}
+
+void MoveJournal::reset(const TesseractPuzzle& puzzle, const RubikCube& cube) {
+    log_.clear();
+    cursor_ = 0;
+    checkpoints_.assign(1, capture(puzzle, cube));
+}
+
+bool MoveJournal::record(uint8_t entry, const TesseractPuzzle& puzzle, const RubikCube& cube) {
+    log_.resize(cursor_);
+    checkpoints_.resize(cursor_ / interval_ + 1);
+    log_.push_back(entry);
+    cursor_++;
+    if (cursor_ % interval_ != 0) return false;
+    checkpoints_.push_back(capture(puzzle, cube));
+    return true;
+}
+
+bool MoveJournal::undo(uint8_t& entry) {
+    if (!canUndo()) return false;
+    entry = log_[--cursor_];
+    return true;
+}
+
+bool MoveJournal::redo(uint8_t& entry) {
+    if (!canRedo()) return false;
+    entry = log_[cursor_++];
+    return true;
+}
+
+bool MoveJournal::seek(size_t target, TesseractPuzzle& puzzle, RubikCube& cube,
+                       const std::function<void(uint8_t)>& onReplay) {
+    if (target > log_.size() || checkpoints_.empty()) return false;
+    size_t k = target / interval_;
+    restore(checkpoints_[k], puzzle, cube);
+    for (size_t i = k * interval_; i < target; i++) {
+        applyEntry(log_[i], puzzle, cube);
+        if (onReplay) onReplay(log_[i]);
+    }
+    cursor_ = target;
+    return true;
+}
+
+void MoveJournal::applyEntry(uint8_t entry, TesseractPuzzle& puzzle, RubikCube& cube) {
+    if (isRubikEntry(entry)) cube.apply(entryRubikOp(entry));
+    else puzzle.apply(entryTesseractOp(entry));
+}
+
+JournalCheckpoint MoveJournal::capture(const TesseractPuzzle& puzzle, const RubikCube& cube) {
+    JournalCheckpoint cp;
+    cp.tesseract = puzzle.getState();
+    uint8_t colors[RUBIK_FACELETS];
+    cube.getFacelets(colors);
+    for (int w = 0; w < 3; w++) cp.facelets[w] = 0;
+    for (int i = 0; i < RUBIK_FACELETS; i++)
+        cp.facelets[i / FACELETS_PER_WORD] |= uint64_t(colors[i]) << (3 * (i % FACELETS_PER_WORD));
+    return cp;
+}
+
+void MoveJournal::restore(const JournalCheckpoint& cp, TesseractPuzzle& puzzle, RubikCube& cube) {
+    puzzle.setState(cp.tesseract);
+    uint8_t colors[RUBIK_FACELETS];
+    for (int i = 0; i < RUBIK_FACELETS; i++)
+        colors[i] = static_cast<uint8_t>((cp.facelets[i / FACELETS_PER_WORD] >> (3 * (i % FACELETS_PER_WORD))) & 7);
+    cube.setFacelets(colors);
+}
@@ -0,0 +1,75 @@
+// Move Journal
+// Undo/redo history of committed moves as 1-byte entries, with packed-state checkpoints for seeking
+
+#ifndef MOVE_JOURNAL_H
+#define MOVE_JOURNAL_H
+
+#include "tesseract_model.h"
+#include "rubik_cube.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Journal entry: a TesseractOp code (0..47) or JOURNAL_RUBIK_BASE + RubikOp code
+constexpr uint8_t JOURNAL_RUBIK_BASE = TESSERACT_OP_COUNT;
+
+inline uint8_t journalEntry(TesseractOp op) { return op.code; }
+inline uint8_t journalEntry(RubikOp op) { return static_cast<uint8_t>(JOURNAL_RUBIK_BASE + op.code); }
+inline bool isRubikEntry(uint8_t entry) { return entry >= JOURNAL_RUBIK_BASE; }
+inline TesseractOp entryTesseractOp(uint8_t entry) { return TesseractOp{entry}; }
+inline RubikOp entryRubikOp(uint8_t entry) { return RubikOp{static_cast<uint8_t>(entry - JOURNAL_RUBIK_BASE)}; }
+inline uint8_t inverseEntry(uint8_t entry) {
+    return isRubikEntry(entry) ? journalEntry(inverseOp(entryRubikOp(entry)))
+                               : journalEntry(inverseOp(entryTesseractOp(entry)));
+}
+
+// Both puzzles at one journal position: 24 + 24 bytes (facelet colors packed 3 bits each)
+struct JournalCheckpoint {
+    TesseractState tesseract;
+    uint64_t facelets[3];
+};
+
+// Entries before the cursor are applied, entries after it can be redone. Recording a move
+// drops the redo tail. A checkpoint is kept at every multiple of the interval, so
+// seek() restores the nearest one at or below the target and replays fewer than
+// interval entries, however long the session.
+class MoveJournal {
+public:
+    explicit MoveJournal(size_t checkpointInterval = 1024);
+
+    // Forget all history; the current puzzles become position 0. Call before the first record()
+    void reset(const TesseractPuzzle& puzzle, const RubikCube& cube);
+    // Append a move the caller has just applied. Returns true if it landed on a
+    // checkpoint (position() % checkpointInterval() == 0)
+    bool record(uint8_t entry, const TesseractPuzzle& puzzle, const RubikCube& cube);
+
+    bool canUndo() const { return cursor_ > 0; }
+    bool canRedo() const { return cursor_ < log_.size(); }
+    // Step the cursor; entry is the move to undo (apply inverseEntry) or redo (apply as is)
+    bool undo(uint8_t& entry);
+    bool redo(uint8_t& entry);
+
+    // Load checkpoint target / checkpointInterval() into the puzzles and replay up to target,
+    // calling onReplay after each replayed entry. Returns false if target > size()
+    bool seek(size_t target, TesseractPuzzle& puzzle, RubikCube& cube,
+              const std::function<void(uint8_t)>& onReplay = nullptr);
+
+    size_t position() const { return cursor_; }
+    size_t size() const { return log_.size(); }
+    size_t checkpointInterval() const { return interval_; }
+    size_t checkpointCount() const { return checkpoints_.size(); }
+    uint8_t entry(size_t i) const { return log_[i]; }
+
+    static void applyEntry(uint8_t entry, TesseractPuzzle& puzzle, RubikCube& cube);
+    static JournalCheckpoint capture(const TesseractPuzzle& puzzle, const RubikCube& cube);
+    static void restore(const JournalCheckpoint& cp, TesseractPuzzle& puzzle, RubikCube& cube);
+
+private:
+    size_t interval_;
+    std::vector<uint8_t> log_;
+    size_t cursor_;
+    std::vector<JournalCheckpoint> checkpoints_;  // checkpoints_[k] = state at k * interval_
+};
+
+#endif // MOVE_JOURNAL_H
@@ -0,0 +1,216 @@
+// Move Log File Implementation
+
+#include "move_log.h"
+#include <cstring>
+
+static const char MOVE_LOG_MAGIC[8] = {'T', '4', 'M', 'L', 'O', 'G', 0, 0};
+static const size_t FOOTER_BYTES = 16;
+
+static void setError(std::string* error, const std::string& msg) {
+    if (error) *error = msg;
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static size_t codeBytes(size_t codes) {
+    return (codes * 6 + 7) / 8;
+}
+
+void applyMoveLogCode(uint8_t code, TesseractPuzzle& puzzle, RubikCube& cube) {
+    if (code < MOVE_LOG_RUBIK_BASE) puzzle.apply(TesseractOp{code});
+    else if (code < MOVE_LOG_CODES) cube.apply(makeRubikOp((code - MOVE_LOG_RUBIK_BASE) / 2, code & 1));
+    // 60..63 are reserved
+}
+
+// ---------------------------------------------------------------------------
+// MoveLogWriter
+
+MoveLogWriter::MoveLogWriter() : file_(nullptr), interval_(0), moves_(0), offset_(0), ok_(false) {}
+
+MoveLogWriter::~MoveLogWriter() {
+    if (!file_) return;
+    std::fclose(file_);
+    std::remove((path_ + ".tmp").c_str());
+}
+
+bool MoveLogWriter::open(const std::string& path, const TesseractPuzzle& start, const RubikCube& startCube,
+                         size_t checkpointInterval, std::string* error) {
+    if (file_) { std::fclose(file_); std::remove((path_ + ".tmp").c_str()); }
+    path_ = path;
+    file_ = std::fopen((path + ".tmp").c_str(), "wb");
+    if (!file_) { setError(error, "cannot create " + path + ".tmp"); return false; }
+    interval_ = checkpointInterval < 4 ? 4 : (checkpointInterval + 3) / 4 * 4;
+    moves_ = 0;
+    offset_ = 0;
+    ok_ = true;
+    puzzle_ = start;
+    cube_ = startCube;
+    blockStart_ = MoveJournal::capture(puzzle_, cube_);
+    codes_.clear();
+    codes_.reserve(interval_);
+    blockOffsets_.clear();
+
+    std::vector<uint8_t> header(MOVE_LOG_MAGIC, MOVE_LOG_MAGIC + 8);
+    putVarint(header, MOVE_LOG_VERSION);
+    putVarint(header, interval_);
+    write(header.data(), header.size());
+    return ok_;
+}
+
+void MoveLogWriter::append(TesseractOp op) {
+    puzzle_.apply(op);
+    appendCode(moveLogCode(op));
+}
+
+void MoveLogWriter::append(RubikOp op) {
+    int quarters = opTurn(op) == 2 ? 2 : 1;
+    RubikOp quarter = opTurn(op) == 2 ? makeRubikOp(opFace(op), 0) : op;
+    for (int i = 0; i < quarters; i++) {
+        cube_.apply(quarter);
+        appendCode(moveLogCode(quarter));
+    }
+}
+
+void MoveLogWriter::appendCode(uint8_t code) {
+    codes_.push_back(code);
+    moves_++;
+    if (codes_.size() == interval_) flushBlock();
+}
+
+void MoveLogWriter::flushBlock() {
+    std::vector<uint8_t> packed(codeBytes(codes_.size()), 0);
+    for (size_t i = 0; i < codes_.size(); i++) {
+        size_t bit = i * 6;
+        unsigned v = static_cast<unsigned>(codes_[i]) << (bit & 7);
+        packed[bit >> 3] |= static_cast<uint8_t>(v);
+        if (v >> 8) packed[(bit >> 3) + 1] |= static_cast<uint8_t>(v >> 8);
+    }
+    blockOffsets_.push_back(offset_);
+    write(&blockStart_, sizeof(blockStart_));
+    write(packed.data(), packed.size());
+    codes_.clear();
+    blockStart_ = MoveJournal::capture(puzzle_, cube_);
+}
+
+void MoveLogWriter::write(const void* data, size_t bytes) {
+    if (ok_ && bytes > 0) ok_ = std::fwrite(data, 1, bytes, file_) == bytes;
+    offset_ += bytes;
+}
+
+bool MoveLogWriter::close(std::string* error) {
+    if (!file_) { setError(error, "log is not open"); return false; }
+    // The last block holds the remaining moves; it is empty (just the final checkpoint)
+    // when the count is a multiple of the interval
+    flushBlock();
+    uint64_t indexOffset = offset_;
+    std::vector<uint8_t> index;
+    putVarint(index, moves_);
+    putVarint(index, blockOffsets_.size());
+    uint64_t prev = 0;
+    for (uint64_t off : blockOffsets_) {
+        putVarint(index, off - prev);
+        prev = off;
+    }
+    uint64_t footer[2] = {indexOffset, pdbChecksum(index.data(), index.size())};
+    write(index.data(), index.size());
+    write(footer, sizeof(footer));
+
+    std::string tmp = path_ + ".tmp";
+    bool ok = (std::fclose(file_) == 0) && ok_;
+    file_ = nullptr;
+    if (!ok) { std::remove(tmp.c_str()); setError(error, "write failed for " + tmp); return false; }
+    std::remove(path_.c_str());
+    if (std::rename(tmp.c_str(), path_.c_str()) != 0) { setError(error, "cannot rename to " + path_); return false; }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// MoveLogReader
+
+bool MoveLogReader::open(const std::string& path, std::string* error) {
+    close();
+    if (!mapped_.open(path)) { setError(error, "cannot map " + path); return false; }
+    const uint8_t* base = mapped_.data();
+    size_t size = mapped_.size();
+    if (size < 8 + FOOTER_BYTES || std::memcmp(base, MOVE_LOG_MAGIC, 8) != 0) {
+        close(); setError(error, "not a move log"); return false;
+    }
+    const uint8_t* p = base + 8;
+    uint64_t version = 0, interval = 0;
+    if (!getVarint(p, base + size, version) || version != MOVE_LOG_VERSION) {
+        close(); setError(error, "unsupported move log version"); return false;
+    }
+    if (!getVarint(p, base + size, interval) || interval == 0 || interval % 4 != 0) {
+        close(); setError(error, "bad checkpoint interval"); return false;
+    }
+    uint64_t dataStart = static_cast<uint64_t>(p - base);
+
+    uint64_t footer[2];
+    std::memcpy(footer, base + size - FOOTER_BYTES, sizeof(footer));
+    uint64_t indexEnd = size - FOOTER_BYTES;
+    if (footer[0] < dataStart || footer[0] > indexEnd ||
+        pdbChecksum(base + footer[0], static_cast<size_t>(indexEnd - footer[0])) != footer[1]) {
+        close(); setError(error, "index checksum mismatch (truncated or unclosed log?)"); return false;
+    }
+
+    const uint8_t* q = base + footer[0];
+    const uint8_t* end = base + indexEnd;
+    uint64_t moves = 0, blocks = 0;
+    if (!getVarint(q, end, moves) || !getVarint(q, end, blocks) || blocks != moves / interval + 1) {
+        close(); setError(error, "bad index header"); return false;
+    }
+    uint64_t off = 0;
+    for (uint64_t b = 0; b < blocks; b++) {
+        uint64_t delta;
+        if (!getVarint(q, end, delta)) { close(); setError(error, "truncated index"); return false; }
+        off += delta;
+        uint64_t n = b + 1 < blocks ? interval : moves - b * interval;
+        uint64_t bytes = sizeof(JournalCheckpoint) + codeBytes(static_cast<size_t>(n));
+        if (off < dataStart || off + bytes > footer[0]) {
+            close(); setError(error, "block " + std::to_string(b) + " out of range"); return false;
+        }
+        blocks_.push_back(off);
+    }
+    interval_ = static_cast<size_t>(interval);
+    moves_ = moves;
+    return true;
+}
+
+uint8_t MoveLogReader::code(uint64_t i) const {
+    const uint8_t* data = mapped_.data() + blocks_[i / interval_] + sizeof(JournalCheckpoint);
+    size_t bit = static_cast<size_t>(i % interval_) * 6;
+    unsigned v = data[bit >> 3] >> (bit & 7);
+    if ((bit & 7) > 2) v |= static_cast<unsigned>(data[(bit >> 3) + 1]) << (8 - (bit & 7));
+    return static_cast<uint8_t>(v & 63);
+}
+
+bool MoveLogReader::seek(uint64_t n, TesseractPuzzle& puzzle, RubikCube& cube) const {
+    if (!isOpen() || n > moves_) return false;
+    uint64_t block = n / interval_;
+    JournalCheckpoint cp;
+    std::memcpy(&cp, mapped_.data() + blocks_[block], sizeof(cp));
+    MoveJournal::restore(cp, puzzle, cube);
+    forEach(block * interval_, n - block * interval_, [&](uint8_t c) { applyMoveLogCode(c, puzzle, cube); });
+    return true;
+}
+
+void MoveLogReader::forEach(uint64_t first, uint64_t count, const std::function<void(uint8_t)>& fn) const {
+    uint64_t end = first + count < moves_ ? first + count : moves_;
+    for (uint64_t i = first; i < end; i++) fn(code(i));
+}
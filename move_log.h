@@ -0,0 +1,98 @@
+// Move Log File
+// Compact binary session logs: 6-bit move codes with packed-state checkpoints and an offset index
+
+#ifndef MOVE_LOG_H
+#define MOVE_LOG_H
+
+#include "move_journal.h"
+#include "pdb_file.h"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Layout:
+//   magic "T4MLOG" + 2 zero bytes | varint version | varint checkpoint interval
+//   block[k] for k = 0 .. moves / interval:
+//       JournalCheckpoint (48 bytes: both puzzles after k * interval moves)
+//       the block's moves (interval, fewer in the last block) as 6-bit codes, LSB first
+//   index: varint moves | varint blocks | varint offset delta per block
+//   footer: uint64 index offset | uint64 pdbChecksum of the index (host byte order)
+// The index and footer are written last, so a log is only readable once it is closed.
+constexpr uint32_t MOVE_LOG_VERSION = 1;
+
+// Move code: 0..47 = TesseractOp code, 48..59 = Rubik quarter turn 48 + face * 2 + prime.
+// Rubik half turns are stored as two clockwise quarter turns.
+constexpr uint8_t MOVE_LOG_RUBIK_BASE = TESSERACT_OP_COUNT;
+constexpr uint8_t MOVE_LOG_CODES = MOVE_LOG_RUBIK_BASE + 12;
+
+inline uint8_t moveLogCode(TesseractOp op) { return op.code; }
+// Quarter turns only (turn 0 or 1)
+inline uint8_t moveLogCode(RubikOp op) {
+    return static_cast<uint8_t>(MOVE_LOG_RUBIK_BASE + opFace(op) * 2 + opTurn(op));
+}
+void applyMoveLogCode(uint8_t code, TesseractPuzzle& puzzle, RubikCube& cube);
+
+// Streaming writer: moves are buffered one block at a time, the file goes to path + ".tmp"
+// and is renamed into place by close()
+class MoveLogWriter {
+public:
+    MoveLogWriter();
+    ~MoveLogWriter();  // discards an unclosed log
+    MoveLogWriter(const MoveLogWriter&) = delete;
+    MoveLogWriter& operator=(const MoveLogWriter&) = delete;
+
+    // checkpointInterval is rounded up to a multiple of 4 (4 codes = 3 bytes)
+    bool open(const std::string& path, const TesseractPuzzle& start, const RubikCube& startCube,
+              size_t checkpointInterval = 4096, std::string* error = nullptr);
+    void append(TesseractOp op);
+    void append(RubikOp op);
+    bool close(std::string* error = nullptr);
+
+    uint64_t moveCount() const { return moves_; }
+
+private:
+    FILE* file_;
+    std::string path_;
+    size_t interval_;
+    uint64_t moves_;
+    uint64_t offset_;
+    bool ok_;
+    TesseractPuzzle puzzle_;
+    RubikCube cube_;
+    JournalCheckpoint blockStart_;
+    std::vector<uint8_t> codes_;
+    std::vector<uint64_t> blockOffsets_;
+
+    void appendCode(uint8_t code);
+    void flushBlock();
+    void write(const void* data, size_t bytes);
+};
+
+// Read-only mmap of a closed log. seek() restores the nearest checkpoint and decodes
+// fewer than interval codes, so any position costs the same however long the log is.
+class MoveLogReader {
+public:
+    bool open(const std::string& path, std::string* error = nullptr);
+    void close() { mapped_.close(); blocks_.clear(); moves_ = 0; }
+    bool isOpen() const { return mapped_.data() != nullptr; }
+
+    uint64_t moveCount() const { return moves_; }
+    size_t checkpointInterval() const { return interval_; }
+    size_t checkpointCount() const { return blocks_.size(); }
+
+    uint8_t code(uint64_t i) const;
+    // Both puzzles as they were after n moves; false if n > moveCount()
+    bool seek(uint64_t n, TesseractPuzzle& puzzle, RubikCube& cube) const;
+    // Visit codes [first, first + count) in order (clamped to moveCount())
+    void forEach(uint64_t first, uint64_t count, const std::function<void(uint8_t)>& fn) const;
+
+private:
+    MappedFile mapped_;
+    size_t interval_ = 0;
+    uint64_t moves_ = 0;
+    std::vector<uint64_t> blocks_;  // file offset of each block's checkpoint
+};
+
+#endif // MOVE_LOG_H
@@ -0,0 +1,150 @@
+// Move Simplifier Implementation
+
+#include "move_simplifier.h"
+#include "tesseract_model.h"
+#include "rubik_cube.h"
+
+static const int TESSERACT_SLICES = TESSERACT_OP_COUNT / 2;
+static const int RUBIK_FACES = 6;
+
+// Two gathers commute when src_a[src_b[i]] == src_b[src_a[i]] everywhere
+template <int N>
+static bool gathersCommute(const uint8_t (&a)[N], const uint8_t (&b)[N]) {
+    for (int i = 0; i < N; i++)
+        if (a[b[i]] != b[a[i]]) return false;
+    return true;
+}
+
+// commute[s][t] per slice / face, from the clockwise quarter turns (the other turns are
+// powers of it, so they commute exactly when it does)
+struct CommuteTables {
+    bool tesseract[TESSERACT_SLICES][TESSERACT_SLICES];
+    bool rubik[RUBIK_FACES][RUBIK_FACES];
+    uint64_t tesseractNext[TESSERACT_OP_COUNT];
+    uint32_t rubikNext[RUBIK_OP_COUNT];
+
+    CommuteTables() {
+        uint8_t slices[TESSERACT_SLICES][TESSERACT_STICKERS];
+        for (int s = 0; s < TESSERACT_SLICES; s++)
+            TesseractPuzzle::slicePermutation(s / 4, s % 4, true, slices[s]);
+        for (int s = 0; s < TESSERACT_SLICES; s++)
+            for (int t = 0; t < TESSERACT_SLICES; t++) tesseract[s][t] = gathersCommute(slices[s], slices[t]);
+
+        uint8_t faces[RUBIK_FACES][RUBIK_FACELETS];
+        for (int f = 0; f < RUBIK_FACES; f++) RubikCube::movePermutation(makeRubikOp(f, 0), faces[f]);
+        for (int f = 0; f < RUBIK_FACES; f++)
+            for (int g = 0; g < RUBIK_FACES; g++) rubik[f][g] = gathersCommute(faces[f], faces[g]);
+
+        for (int last = 0; last < TESSERACT_OP_COUNT; last++) {
+            uint64_t next = 0;
+            for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+                int s = m >> 1, t = last >> 1;
+                if (s == t ? m != last || (m & 1) : tesseract[s][t] && s < t) continue;
+                next |= uint64_t(1) << m;
+            }
+            tesseractNext[last] = next;
+        }
+        for (int last = 0; last < RUBIK_OP_COUNT; last++) {
+            uint32_t next = 0;
+            for (int m = 0; m < RUBIK_OP_COUNT; m++) {
+                int f = m / 3, g = last / 3;
+                if (f == g || (rubik[f][g] && f < g)) continue;
+                next |= uint32_t(1) << m;
+            }
+            rubikNext[last] = next;
+        }
+    }
+};
+
+static const CommuteTables& commuteTables() {
+    static const CommuteTables tables;
+    return tables;
+}
+
+bool movesCommute(TesseractOp a, TesseractOp b) {
+    return commuteTables().tesseract[a.code >> 1][b.code >> 1];
+}
+
+bool movesCommute(RubikOp a, RubikOp b) {
+    return commuteTables().rubik[opFace(a)][opFace(b)];
+}
+
+uint64_t canonicalSuccessors(TesseractOp last) {
+    return commuteTables().tesseractNext[last.code];
+}
+
+uint32_t canonicalSuccessors(RubikOp last) {
+    return commuteTables().rubikNext[last.code];
+}
+
+// ---------------------------------------------------------------------------
+// Simplification on (slice, quarter turns mod 4) groups
+
+namespace {
+
+struct Group {
+    int slice;
+    int quarters;  // 1..3 clockwise quarter turns
+};
+
+template <int N>
+size_t simplifyGroups(std::vector<Group>& groups, const bool (&commute)[N][N]) {
+    size_t before = groups.size();
+    // Cancelling a group can make its neighbours mergeable or out of order, so repeat
+    // until a pass removes nothing (each repeat shrinks the sequence)
+    for (size_t last = groups.size() + 1; groups.size() < last;) {
+        last = groups.size();
+        std::vector<Group> input;
+        input.swap(groups);
+        for (const Group& g : input) {
+            // Merge into the same slice if every move after it commutes with g
+            bool merged = false;
+            for (size_t j = groups.size(); j-- > 0;) {
+                if (groups[j].slice == g.slice) {
+                    groups[j].quarters = (groups[j].quarters + g.quarters) & 3;
+                    if (groups[j].quarters == 0) groups.erase(groups.begin() + static_cast<long>(j));
+                    merged = true;
+                    break;
+                }
+                if (!commute[groups[j].slice][g.slice]) break;
+            }
+            if (merged) continue;
+            // Otherwise insert before the higher commuting slices at the end
+            size_t i = groups.size();
+            while (i > 0 && groups[i - 1].slice > g.slice && commute[groups[i - 1].slice][g.slice]) i--;
+            groups.insert(groups.begin() + static_cast<long>(i), g);
+        }
+    }
+    return before - groups.size();
+}
+
+}  // namespace
+
+size_t simplifyMoves(std::vector<TesseractOp>& ops) {
+    size_t before = ops.size();
+    std::vector<Group> groups;
+    groups.reserve(ops.size());
+    for (TesseractOp op : ops) groups.push_back(Group{op.code >> 1, opClockwise(op) ? 1 : 3});
+    simplifyGroups(groups, commuteTables().tesseract);
+    // Half turns stay as two clockwise quarter turns
+    ops.clear();
+    for (const Group& g : groups) {
+        TesseractOp cw{static_cast<uint8_t>(g.slice * 2)};
+        if (g.quarters == 3) ops.push_back(inverseOp(cw));
+        else ops.insert(ops.end(), static_cast<size_t>(g.quarters), cw);
+    }
+    return before - ops.size();
+}
+
+size_t simplifyMoves(std::vector<RubikOp>& ops) {
+    static const int quartersOfTurn[3] = {1, 3, 2};
+    static const int turnOfQuarters[4] = {-1, 0, 2, 1};
+    size_t before = ops.size();
+    std::vector<Group> groups;
+    groups.reserve(ops.size());
+    for (RubikOp op : ops) groups.push_back(Group{opFace(op), quartersOfTurn[opTurn(op)]});
+    simplifyGroups(groups, commuteTables().rubik);
+    ops.clear();
+    for (const Group& g : groups) ops.push_back(makeRubikOp(g.slice, turnOfQuarters[g.quarters]));
+    return before - ops.size();
+}
@@ -0,0 +1,35 @@
+// Move Simplifier
+// Cancels, merges and canonically orders move sequences using precomputed commutation tables
+
+#ifndef MOVE_SIMPLIFIER_H
+#define MOVE_SIMPLIFIER_H
+
+#include "move_tokens.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Whether two moves give the same result in either order. Built once from the sticker
+// and facelet permutations: every tesseract slice commutes with 11 of the other 23,
+// Rubik faces only with the opposite face.
+bool movesCommute(TesseractOp a, TesseractOp b);
+bool movesCommute(RubikOp a, RubikOp b);
+
+// Canonical order: within a run of commuting moves slices appear in increasing order
+// (slice = opcode / 2 for the tesseract, the face for the cube), and a slice never
+// follows itself except as a repeated quarter turn (tesseract cw cw = half turn).
+// Bit m set = opcode m may follow last. For search: every sequence has a canonical
+// one at most as long, so pruning the other successors keeps IDA* optimal.
+// Tesseract: excludes last's inverse and lower commuting slices; includes last itself
+// only when it is clockwise (the caller allows one repeat).
+uint64_t canonicalSuccessors(TesseractOp last);
+// Rubik: excludes last's face and lower commuting faces
+uint32_t canonicalSuccessors(RubikOp last);
+
+// Rewrite ops into canonical order, cancelling inverses and merging turns of one slice
+// across commuting moves (XY0 XY0 XY0 -> XY0'; R L R' -> L). The result has the
+// same effect on the puzzle and is never longer. Returns how many moves were removed.
+size_t simplifyMoves(std::vector<TesseractOp>& ops);
+size_t simplifyMoves(std::vector<RubikOp>& ops);
+
+#endif // MOVE_SIMPLIFIER_H
@@ -0,0 +1,151 @@
+// Move Tokenizer Implementation
+
+#include "move_tokens.h"
+
+static const char* const PLANE_NAMES[6] = {"XY", "XZ", "XW", "YZ", "YW", "ZW"};
+static const char FACE_NAMES[6] = {'R', 'L', 'U', 'D', 'F', 'B'};
+
+static inline bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',';
+}
+
+static inline bool isPrime(char c) {
+    return c == '\'' || c == '`';
+}
+
+static int planeFromChars(char a, char b) {
+    switch (a) {
+        case 'X': return b == 'Y' ? 0 : b == 'Z' ? 1 : b == 'W' ? 2 : -1;
+        case 'Y': return b == 'Z' ? 3 : b == 'W' ? 4 : -1;
+        case 'Z': return b == 'W' ? 5 : -1;
+        default: return -1;
+    }
+}
+
+static int faceFromChar(char c) {
+    switch (c) {
+        case 'R': return 0;
+        case 'L': return 1;
+        case 'U': return 2;
+        case 'D': return 3;
+        case 'F': return 4;
+        case 'B': return 5;
+        default: return -1;
+    }
+}
+
+bool parseTesseractOp(std::string_view token, TesseractOp& op) {
+    if (token.size() < 3 || token.size() > 4) return false;
+    int plane = planeFromChars(token[0], token[1]);
+    int layer = token[2] - '0';
+    if (plane < 0 || layer < 0 || layer > 3) return false;
+    bool cw = true;
+    if (token.size() == 4) {
+        if (!isPrime(token[3])) return false;
+        cw = false;
+    }
+    op = makeTesseractOp(plane, layer, cw);
+    return true;
+}
+
+bool parseRubikOp(std::string_view token, RubikOp& op) {
+    if (token.empty() || token.size() > 2) return false;
+    int face = faceFromChar(token[0]);
+    if (face < 0) return false;
+    int turn = 0;
+    if (token.size() == 2) {
+        if (isPrime(token[1])) turn = 1;
+        else if (token[1] == '2') turn = 2;
+        else return false;
+    }
+    op = makeRubikOp(face, turn);
+    return true;
+}
+
+// Shared scan loop: split on separators and hand each token to parseOne
+template <typename Op, typename ParseOne>
+static bool parseSequence(std::string_view text, Op* out, size_t capacity,
+                          size_t& count, size_t& consumed, ParseOne parseOne) {
+    count = 0;
+    size_t i = 0;
+    const size_t n = text.size();
+    while (true) {
+        while (i < n && isSeparator(text[i])) i++;
+        if (i == n || count == capacity) break;
+        size_t start = i;
+        while (i < n && !isSeparator(text[i])) i++;
+        if (!parseOne(text.substr(start, i - start), out[count])) {
+            consumed = start;
+            return false;
+        }
+        count++;
+    }
+    consumed = i;
+    return true;
+}
+
+bool parseTesseractMoves(std::string_view text, TesseractOp* out, size_t capacity,
+                         size_t& count, size_t& consumed) {
+    return parseSequence(text, out, capacity, count, consumed,
+                         [](std::string_view t, TesseractOp& op) { return parseTesseractOp(t, op); });
+}
+
+bool parseRubikMoves(std::string_view text, RubikOp* out, size_t capacity,
+                     size_t& count, size_t& consumed) {
+    return parseSequence(text, out, capacity, count, consumed,
+                         [](std::string_view t, RubikOp& op) { return parseRubikOp(t, op); });
+}
+
+template <typename Op, typename ParseChunk>
+static bool parseAll(std::string_view text, std::vector<Op>& out, ParseChunk parseChunk) {
+    out.clear();
+    Op chunk[256];
+    while (true) {
+        size_t count = 0, consumed = 0;
+        bool ok = parseChunk(text, chunk, 256, count, consumed);
+        out.insert(out.end(), chunk, chunk + count);
+        if (!ok) return false;
+        if (count < 256) return true;
+        text.remove_prefix(consumed);
+    }
+}
+
+bool parseTesseractMoves(std::string_view text, std::vector<TesseractOp>& out) {
+    return parseAll(text, out, [](std::string_view t, TesseractOp* o, size_t cap, size_t& c, size_t& u) {
+        return parseTesseractMoves(t, o, cap, c, u);
+    });
+}
+
+bool parseRubikMoves(std::string_view text, std::vector<RubikOp>& out) {
+    return parseAll(text, out, [](std::string_view t, RubikOp* o, size_t cap, size_t& c, size_t& u) {
+        return parseRubikMoves(t, o, cap, c, u);
+    });
+}
+
+void appendMove(std::string& out, TesseractOp op) {
+    if (!out.empty()) out += ' ';
+    out += PLANE_NAMES[opPlane(op)];
+    out += static_cast<char>('0' + opLayer(op));
+    if (!opClockwise(op)) out += '\'';
+}
+
+void appendMove(std::string& out, RubikOp op) {
+    if (!out.empty()) out += ' ';
+    out += FACE_NAMES[opFace(op)];
+    if (opTurn(op) == 1) out += '\'';
+    else if (opTurn(op) == 2) out += '2';
+}
+
+std::string formatMoves(const TesseractOp* ops, size_t n) {
+    std::string s;
+    s.reserve(n * 5);
+    for (size_t i = 0; i < n; i++) appendMove(s, ops[i]);
+    return s;
+}
+
+std::string formatMoves(const RubikOp* ops, size_t n) {
+    std::string s;
+    s.reserve(n * 3);
+    for (size_t i = 0; i < n; i++) appendMove(s, ops[i]);
+    return s;
+}
@@ -0,0 +1,67 @@
+// Move Tokenizer
+// Parses move text into compact 1-byte opcodes for TesseractPuzzle and RubikCube
+
+#ifndef MOVE_TOKENS_H
+#define MOVE_TOKENS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Tesseract opcode: plane * 8 + layer * 2 + (counter-clockwise ? 1 : 0), range 0..47
+struct TesseractOp {
+    uint8_t code;
+};
+
+// Rubik opcode: face * 3 + turn (0 = clockwise, 1 = prime, 2 = half), range 0..17
+struct RubikOp {
+    uint8_t code;
+};
+
+constexpr int TESSERACT_OP_COUNT = 48;
+constexpr int RUBIK_OP_COUNT = 18;
+
+inline TesseractOp makeTesseractOp(int plane, int layer, bool clockwise) {
+    return TesseractOp{static_cast<uint8_t>(plane * 8 + layer * 2 + (clockwise ? 0 : 1))};
+}
+inline int opPlane(TesseractOp op) { return op.code >> 3; }
+inline int opLayer(TesseractOp op) { return (op.code >> 1) & 3; }
+inline bool opClockwise(TesseractOp op) { return (op.code & 1) == 0; }
+inline TesseractOp inverseOp(TesseractOp op) { return TesseractOp{static_cast<uint8_t>(op.code ^ 1)}; }
+
+inline RubikOp makeRubikOp(int face, int turn) {
+    return RubikOp{static_cast<uint8_t>(face * 3 + turn)};
+}
+inline int opFace(RubikOp op) { return op.code / 3; }
+inline int opTurn(RubikOp op) { return op.code % 3; }
+inline RubikOp inverseOp(RubikOp op) {
+    static const uint8_t inv[3] = {1, 0, 2};
+    return RubikOp{static_cast<uint8_t>(op.code - opTurn(op) + inv[opTurn(op)])};
+}
+
+// Parse a single token ("XY0", "ZW3'", "R", "U'", "F2"); no surrounding whitespace
+bool parseTesseractOp(std::string_view token, TesseractOp& op);
+bool parseRubikOp(std::string_view token, RubikOp& op);
+
+// Parse a move sequence separated by whitespace or commas into out[0..capacity).
+// Never allocates. Returns false on a malformed token; count is the number of ops
+// written and consumed the offset where parsing stopped (at the bad token, or at the
+// next unread token when capacity runs out, so the caller can resume from there).
+bool parseTesseractMoves(std::string_view text, TesseractOp* out, size_t capacity,
+                         size_t& count, size_t& consumed);
+bool parseRubikMoves(std::string_view text, RubikOp* out, size_t capacity,
+                     size_t& count, size_t& consumed);
+
+// Convenience wrappers for non-hot paths
+bool parseTesseractMoves(std::string_view text, std::vector<TesseractOp>& out);
+bool parseRubikMoves(std::string_view text, std::vector<RubikOp>& out);
+
+// Append move text in the existing notation ("XY0'", "R2"), space-separated
+void appendMove(std::string& out, TesseractOp op);
+void appendMove(std::string& out, RubikOp op);
+std::string formatMoves(const TesseractOp* ops, size_t n);
+std::string formatMoves(const RubikOp* ops, size_t n);
+
+#endif // MOVE_TOKENS_H
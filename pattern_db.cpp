@@ -0,0 +1,444 @@
+// Pattern Database Implementation
+// Tables are built by a level-synchronous BFS: each pass scans the table in chunks for
+// entries at depth d and claims their unvisited neighbours at d + 1 with a CAS on the
+// packed word, so chunks can be spread over a WorkStealingPool without locks.
+
+#include "pattern_db.h"
+#include "bit_ops.h"
+#include "work_stealing_pool.h"
+#include <atomic>
+#include <memory>
+
+static const int MAX_TRACKED = 8;
+static const int UNVISITED = 0xF;
+static const uint64_t CHUNK = uint64_t(1) << 16;
+
+// ---------------------------------------------------------------------------
+// Shared BFS machinery
+
+// Nibble table under construction: 8 entries per atomic word, all starting UNVISITED
+class NibbleBuilder {
+public:
+    explicit NibbleBuilder(uint64_t size)
+        : size_(size), words_(new std::atomic<uint32_t>[(size + 7) / 8]) {
+        for (uint64_t i = 0; i < (size + 7) / 8; i++) words_[i].store(0xFFFFFFFFu, std::memory_order_relaxed);
+    }
+
+    int get(uint64_t i) const {
+        return (words_[i >> 3].load(std::memory_order_relaxed) >> ((i & 7) * 4)) & 0xF;
+    }
+
+    // Set entry i to d if it is still unvisited; true if this call set it
+    bool claim(uint64_t i, int d) {
+        std::atomic<uint32_t>& w = words_[i >> 3];
+        int shift = static_cast<int>(i & 7) * 4;
+        uint32_t cur = w.load(std::memory_order_relaxed);
+        while (((cur >> shift) & 0xF) == UNVISITED) {
+            uint32_t next = (cur & ~(0xFu << shift)) | (static_cast<uint32_t>(d) << shift);
+            if (w.compare_exchange_weak(cur, next, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+
+    void exportBytes(std::vector<uint8_t>& out) const {
+        out.assign((size_ + 1) / 2, 0);
+        for (uint64_t i = 0; i < out.size(); i++) {
+            uint32_t w = words_[i >> 2].load(std::memory_order_relaxed);
+            out[i] = static_cast<uint8_t>(w >> ((i & 3) * 8));
+        }
+    }
+
+private:
+    uint64_t size_;
+    std::unique_ptr<std::atomic<uint32_t>[]> words_;
+};
+
+// expand(builder, begin, end, depth) expands every entry at `depth` in [begin, end)
+// and returns how many new entries it claimed
+template <typename Expand>
+static void bfsBuild(uint64_t size, const std::vector<uint64_t>& goals, WorkStealingPool* pool,
+                     Expand expand, DistanceTable& out) {
+    NibbleBuilder nb(size);
+    std::vector<uint64_t> depthCounts(1, 0);
+    for (uint64_t g : goals)
+        if (nb.claim(g, 0)) depthCounts[0]++;
+    size_t chunks = static_cast<size_t>((size + CHUNK - 1) / CHUNK);
+    for (int d = 0; d < UNVISITED - 1; d++) {
+        std::atomic<uint64_t> added(0);
+        auto work = [&](size_t c, int) {
+            uint64_t begin = c * CHUNK;
+            uint64_t end = begin + CHUNK < size ? begin + CHUNK : size;
+            added.fetch_add(expand(nb, begin, end, d), std::memory_order_relaxed);
+        };
+        if (pool) pool->run(chunks, work);
+        else for (size_t c = 0; c < chunks; c++) work(c, 0);
+        if (added.load() == 0) break;
+        depthCounts.push_back(added.load());
+    }
+    std::vector<uint8_t> bytes;
+    nb.exportBytes(bytes);
+    out.adopt(bytes, size, depthCounts);
+}
+
+void DistanceTable::attach(const uint8_t* data, uint64_t size, int maxDistance) {
+    owned_.clear();
+    depthCounts_.clear();
+    data_ = data;
+    size_ = size;
+    maxDistance_ = maxDistance;
+}
+
+void DistanceTable::adopt(std::vector<uint8_t>& bytes, uint64_t size, std::vector<uint64_t>& depthCounts) {
+    owned_.swap(bytes);
+    depthCounts_.swap(depthCounts);
+    data_ = owned_.data();
+    size_ = size;
+    maxDistance_ = static_cast<int>(depthCounts_.size()) - 1;
+}
+
+// ---------------------------------------------------------------------------
+// Tesseract sticker subsets
+
+struct BinomialTable {
+    uint64_t c[TESSERACT_STICKERS + 1][MAX_TRACKED + 1];
+    BinomialTable() {
+        for (int n = 0; n <= TESSERACT_STICKERS; n++) {
+            c[n][0] = 1;
+            for (int k = 1; k <= MAX_TRACKED; k++)
+                c[n][k] = n == 0 ? 0 : c[n - 1][k - 1] + c[n - 1][k];
+        }
+    }
+};
+
+static const BinomialTable& binomials() {
+    static const BinomialTable table;
+    return table;
+}
+
+// Next larger integer with the same popcount (Gosper's hack); colex successor
+static inline uint64_t nextSubset(uint64_t x) {
+    uint64_t c = x & (0 - x);
+    uint64_t r = x + c;
+    return c == 0 || r == 0 ? 0 : (((r ^ x) >> 2) / c) | r;
+}
+
+TesseractPatternDb::TesseractPatternDb() : color_(-1), tracked_(0) {}
+
+uint64_t TesseractPatternDb::binomial(int n, int k) {
+    if (n < 0 || k < 0 || k > MAX_TRACKED || n > TESSERACT_STICKERS) return 0;
+    return binomials().c[n][k];
+}
+
+uint64_t TesseractPatternDb::rank(uint64_t positions) {
+    const BinomialTable& b = binomials();
+    uint64_t r = 0;
+    for (int i = 1; positions; i++) {
+        r += b.c[lowestBit(positions)][i];
+        positions &= positions - 1;
+    }
+    return r;
+}
+
+uint64_t TesseractPatternDb::unrank(uint64_t r, int k) {
+    const BinomialTable& b = binomials();
+    uint64_t mask = 0;
+    int p = TESSERACT_STICKERS - 1;
+    for (int i = k; i >= 1; i--) {
+        while (b.c[p][i] > r) p--;
+        mask |= uint64_t(1) << p;
+        r -= b.c[p][i];
+        p--;
+    }
+    return mask;
+}
+
+uint64_t TesseractPatternDb::homeMask(int color) {
+    const TesseractState& solved = TesseractPuzzle::solvedState();
+    uint64_t mask = 0;
+    for (int i = 0; i < TESSERACT_STICKERS; i++)
+        if (solved.getColor(i) == color) mask |= uint64_t(1) << i;
+    return mask;
+}
+
+void TesseractPatternDb::build(int color, int tracked, WorkStealingPool* pool) {
+    if (tracked < 1) tracked = 1;
+    if (tracked > MAX_TRACKED) tracked = MAX_TRACKED;
+    color_ = color;
+    tracked_ = tracked;
+
+    // Goals: every tracked-subset of the color's home cells
+    std::vector<uint64_t> goals;
+    uint64_t home = homeMask(color);
+    for (uint64_t sub = home; sub; sub = (sub - 1) & home)
+        if (popCount(sub) == tracked) goals.push_back(rank(sub));
+
+    // Moves are closed under inverse, so the backward search uses the same moves
+    bfsBuild(binomial(TESSERACT_STICKERS, tracked), goals, pool,
+             [tracked](NibbleBuilder& nb, uint64_t begin, uint64_t end, int d) {
+                 uint64_t added = 0;
+                 uint64_t mask = unrank(begin, tracked);
+                 for (uint64_t r = begin; r < end; r++, mask = nextSubset(mask)) {
+                     if (nb.get(r) != d) continue;
+                     for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+                         TesseractOp op{static_cast<uint8_t>(m)};
+                         if (nb.claim(rank(TesseractPuzzle::permuteMask(mask, op)), d + 1)) added++;
+                     }
+                 }
+                 return added;
+             },
+             table_);
+}
+
+bool TesseractPatternDb::attach(const PdbFile& file, int color, int tracked) {
+    const PdbTableEntry* e = file.find(PDB_TESSERACT_STICKERS, static_cast<uint32_t>(color), static_cast<uint32_t>(tracked));
+    if (!e || e->entries != binomial(TESSERACT_STICKERS, tracked) || e->bytes != (e->entries + 1) / 2) return false;
+    color_ = color;
+    tracked_ = tracked;
+    table_.attach(file.tableData(*e), e->entries, static_cast<int>(e->maxDistance));
+    return true;
+}
+
+PdbTableSource TesseractPatternDb::source() const {
+    PdbTableSource s;
+    s.entry = PdbTableEntry();
+    s.entry.kind = PDB_TESSERACT_STICKERS;
+    s.entry.param = static_cast<uint32_t>(color_);
+    s.entry.tracked = static_cast<uint32_t>(tracked_);
+    s.entry.maxDistance = static_cast<uint32_t>(table_.maxDistance());
+    s.entry.entries = table_.size();
+    s.entry.bytes = table_.bytes();
+    s.data = table_.data();
+    return s;
+}
+
+void TesseractHeuristic::build(int tracked, WorkStealingPool* pool) {
+    for (int c = 0; c < 8; c++) dbs_[c].build(c, tracked, pool);
+}
+
+bool TesseractHeuristic::attach(const PdbFile& file, int tracked) {
+    for (int c = 0; c < 8; c++)
+        if (!dbs_[c].attach(file, c, tracked)) {
+            for (int j = 0; j < 8; j++) dbs_[j] = TesseractPatternDb();
+            return false;
+        }
+    return true;
+}
+
+void TesseractHeuristic::initGroups(const TesseractState& state, uint64_t groups[HEURISTIC_GROUPS]) const {
+    int k = tracked();
+    for (int c = 0; c < 8; c++) {
+        int stickers[8];
+        int n = 0;
+        for (int i = 0; i < TESSERACT_STICKERS && n < 8; i++)
+            if (state.getColor(i) == c) stickers[n++] = i;
+        // First k and last k stickers of this color; they overlap when k > 4
+        uint64_t lo = 0, hi = 0;
+        for (int j = 0; j < k && j < n; j++) lo |= uint64_t(1) << stickers[j];
+        for (int j = n - k; j < n; j++) if (j >= 0) hi |= uint64_t(1) << stickers[j];
+        groups[c * 2] = lo;
+        groups[c * 2 + 1] = hi;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Rubik corner / edge subsets
+
+// Piece geometry derived from the facelet layout: facelets sharing a cubie form a
+// piece, slots are numbered in order of their lowest facelet, and a facelet's
+// orientation is its rank within its slot. Piece i is the one whose home is slot i,
+// and its reference sticker is the one on orientation 0 when solved.
+struct RubikPieces {
+    int slotCount[2];
+    int oriCount[2];
+    int slotFacelets[2][12][3];
+    int faceletKind[RUBIK_FACELETS];   // -1 for centers
+    int faceletSlot[RUBIK_FACELETS];
+    int faceletOri[RUBIK_FACELETS];
+    uint8_t forward[RUBIK_OP_COUNT][RUBIK_FACELETS];  // facelet p moves to forward[op][p]
+    int pieceByColors[2][64];  // color-set bitmask -> piece
+
+    RubikPieces() {
+        slotCount[0] = 8;  oriCount[0] = 3;
+        slotCount[1] = 12; oriCount[1] = 2;
+        int found[2] = {0, 0};
+        int slotPos[2][12][3];
+        for (int f = 0; f < RUBIK_FACELETS; f++) {
+            int x, y, z;
+            RubikCube::faceletCubie(f, x, y, z);
+            int nonzero = (x != 0) + (y != 0) + (z != 0);
+            faceletKind[f] = nonzero == 3 ? RUBIK_CORNER_PIECES : nonzero == 2 ? RUBIK_EDGE_PIECES : -1;
+            faceletSlot[f] = faceletOri[f] = -1;
+            if (faceletKind[f] < 0) continue;
+            int k = faceletKind[f];
+            int s = 0;
+            while (s < found[k] && !(slotPos[k][s][0] == x && slotPos[k][s][1] == y && slotPos[k][s][2] == z)) s++;
+            if (s == found[k]) {
+                slotPos[k][s][0] = x; slotPos[k][s][1] = y; slotPos[k][s][2] = z;
+                for (int o = 0; o < 3; o++) slotFacelets[k][s][o] = -1;
+                found[k]++;
+            }
+            int o = 0;
+            while (slotFacelets[k][s][o] >= 0) o++;
+            slotFacelets[k][s][o] = f;
+            faceletSlot[f] = s;
+            faceletOri[f] = o;
+        }
+        for (int m = 0; m < RUBIK_OP_COUNT; m++) {
+            uint8_t src[RUBIK_FACELETS];
+            RubikCube::movePermutation(RubikOp{static_cast<uint8_t>(m)}, src);
+            for (int dst = 0; dst < RUBIK_FACELETS; dst++) forward[m][src[dst]] = static_cast<uint8_t>(dst);
+        }
+        RubikCube solved;
+        for (int k = 0; k < 2; k++) {
+            for (int i = 0; i < 64; i++) pieceByColors[k][i] = -1;
+            for (int s = 0; s < slotCount[k]; s++) {
+                int set = 0;
+                for (int o = 0; o < oriCount[k]; o++) {
+                    int f = slotFacelets[k][s][o];
+                    set |= 1 << solved.getColor(f / 9, (f / 3) % 3, f % 3);
+                }
+                pieceByColors[k][set] = s;
+            }
+        }
+    }
+};
+
+static const RubikPieces& rubikPieces() {
+    static const RubikPieces pieces;
+    return pieces;
+}
+
+RubikPatternDb::RubikPatternDb() : kind_(RUBIK_CORNER_PIECES), mask_(0), tracked_(0) {
+    for (int i = 0; i < 12; i++) pieces_[i] = -1;
+}
+
+uint64_t RubikPatternDb::sizeFor(int kind, int tracked) {
+    const RubikPieces& rp = rubikPieces();
+    uint64_t n = 1;
+    for (int j = 0; j < tracked; j++) n *= static_cast<uint64_t>(rp.slotCount[kind] - j) * rp.oriCount[kind];
+    return n;
+}
+
+void RubikPatternDb::locate(const RubikCube& cube, uint8_t facelets[12]) const {
+    const RubikPieces& rp = rubikPieces();
+    RubikCube solved;
+    for (int s = 0; s < rp.slotCount[kind_]; s++) {
+        int set = 0;
+        for (int o = 0; o < rp.oriCount[kind_]; o++) {
+            int f = rp.slotFacelets[kind_][s][o];
+            set |= 1 << cube.getColor(f / 9, (f / 3) % 3, f % 3);
+        }
+        int piece = rp.pieceByColors[kind_][set];
+        if (piece < 0 || !((mask_ >> piece) & 1)) continue;
+        int ref = rp.slotFacelets[kind_][piece][0];
+        int refColor = solved.getColor(ref / 9, (ref / 3) % 3, ref % 3);
+        int j = 0;
+        while (pieces_[j] != piece) j++;
+        for (int o = 0; o < rp.oriCount[kind_]; o++) {
+            int f = rp.slotFacelets[kind_][s][o];
+            if (cube.getColor(f / 9, (f / 3) % 3, f % 3) == refColor) facelets[j] = static_cast<uint8_t>(f);
+        }
+    }
+}
+
+uint64_t RubikPatternDb::rank(const uint8_t facelets[12]) const {
+    const RubikPieces& rp = rubikPieces();
+    int n = rp.slotCount[kind_], o = rp.oriCount[kind_];
+    uint64_t perm = 0, ori = 0;
+    uint32_t used = 0;
+    for (int j = 0; j < tracked_; j++) {
+        int slot = rp.faceletSlot[facelets[j]];
+        int digit = popCount(~used & ((1u << slot) - 1));
+        perm = perm * static_cast<uint64_t>(n - j) + static_cast<uint64_t>(digit);
+        ori = ori * static_cast<uint64_t>(o) + static_cast<uint64_t>(rp.faceletOri[facelets[j]]);
+        used |= 1u << slot;
+    }
+    uint64_t oriSize = 1;
+    for (int j = 0; j < tracked_; j++) oriSize *= static_cast<uint64_t>(o);
+    return perm * oriSize + ori;
+}
+
+void RubikPatternDb::unrank(uint64_t r, uint8_t facelets[12]) const {
+    const RubikPieces& rp = rubikPieces();
+    int n = rp.slotCount[kind_], o = rp.oriCount[kind_];
+    uint64_t oriSize = 1;
+    for (int j = 0; j < tracked_; j++) oriSize *= static_cast<uint64_t>(o);
+    uint64_t perm = r / oriSize, ori = r % oriSize;
+    int digits[12], oris[12];
+    for (int j = tracked_ - 1; j >= 0; j--) {
+        digits[j] = static_cast<int>(perm % static_cast<uint64_t>(n - j));
+        perm /= static_cast<uint64_t>(n - j);
+        oris[j] = static_cast<int>(ori % static_cast<uint64_t>(o));
+        ori /= static_cast<uint64_t>(o);
+    }
+    uint32_t used = 0;
+    for (int j = 0; j < tracked_; j++) {
+        int slot = 0, seen = -1;
+        for (; slot < n; slot++)
+            if (!((used >> slot) & 1) && ++seen == digits[j]) break;
+        used |= 1u << slot;
+        facelets[j] = static_cast<uint8_t>(rp.slotFacelets[kind_][slot][oris[j]]);
+    }
+}
+
+void RubikPatternDb::build(int kind, uint32_t pieceMask, WorkStealingPool* pool) {
+    const RubikPieces& rp = rubikPieces();
+    kind_ = kind;
+    mask_ = pieceMask & ((1u << rp.slotCount[kind]) - 1);
+    tracked_ = 0;
+    for (int p = 0; p < rp.slotCount[kind]; p++)
+        if ((mask_ >> p) & 1) pieces_[tracked_++] = p;
+
+    uint8_t home[12];
+    for (int j = 0; j < tracked_; j++) home[j] = static_cast<uint8_t>(rp.slotFacelets[kind][pieces_[j]][0]);
+    std::vector<uint64_t> goals(1, rank(home));
+
+    bfsBuild(sizeFor(kind, tracked_), goals, pool,
+             [this, &rp](NibbleBuilder& nb, uint64_t begin, uint64_t end, int d) {
+                 uint64_t added = 0;
+                 uint8_t cur[12], next[12];
+                 for (uint64_t r = begin; r < end; r++) {
+                     if (nb.get(r) != d) continue;
+                     unrank(r, cur);
+                     for (int m = 0; m < RUBIK_OP_COUNT; m++) {
+                         for (int j = 0; j < tracked_; j++) next[j] = rp.forward[m][cur[j]];
+                         if (nb.claim(rank(next), d + 1)) added++;
+                     }
+                 }
+                 return added;
+             },
+             table_);
+}
+
+bool RubikPatternDb::attach(const PdbFile& file, int kind, uint32_t pieceMask) {
+    uint32_t tableKind = kind == RUBIK_CORNER_PIECES ? PDB_RUBIK_CORNERS : PDB_RUBIK_EDGES;
+    const RubikPieces& rp = rubikPieces();
+    kind_ = kind;
+    mask_ = pieceMask & ((1u << rp.slotCount[kind]) - 1);
+    tracked_ = 0;
+    for (int p = 0; p < rp.slotCount[kind]; p++)
+        if ((mask_ >> p) & 1) pieces_[tracked_++] = p;
+    const PdbTableEntry* e = file.find(tableKind, mask_, static_cast<uint32_t>(tracked_));
+    if (!e || e->entries != sizeFor(kind, tracked_) || e->bytes != (e->entries + 1) / 2) return false;
+    table_.attach(file.tableData(*e), e->entries, static_cast<int>(e->maxDistance));
+    return true;
+}
+
+PdbTableSource RubikPatternDb::source() const {
+    PdbTableSource s;
+    s.entry = PdbTableEntry();
+    s.entry.kind = kind_ == RUBIK_CORNER_PIECES ? PDB_RUBIK_CORNERS : PDB_RUBIK_EDGES;
+    s.entry.param = mask_;
+    s.entry.tracked = static_cast<uint32_t>(tracked_);
+    s.entry.maxDistance = static_cast<uint32_t>(table_.maxDistance());
+    s.entry.entries = table_.size();
+    s.entry.bytes = table_.bytes();
+    s.data = table_.data();
+    return s;
+}
+
+int RubikPatternDb::lookup(const RubikCube& cube) const {
+    uint8_t facelets[12];
+    locate(cube, facelets);
+    return table_.get(rank(facelets));
+}
@@ -0,0 +1,146 @@
+// Pattern Databases
+// Admissible lower bounds from sticker/piece-subset abstractions, for TesseractPuzzle
+// (sticker subsets of one color) and RubikCube (corner / edge subsets)
+
+#ifndef PATTERN_DB_H
+#define PATTERN_DB_H
+
+#include "tesseract_model.h"
+#include "rubik_cube.h"
+#include "pdb_file.h"
+#include <cstdint>
+#include <vector>
+
+class WorkStealingPool;
+
+// Nibble-packed distance table (entry i in byte i / 2, low nibble first, max 15).
+// Owns its bytes after build(), or points into a memory-mapped PdbFile after attach().
+class DistanceTable {
+public:
+    DistanceTable() : data_(nullptr), size_(0), maxDistance_(0) {}
+
+    bool empty() const { return data_ == nullptr; }
+    uint64_t size() const { return size_; }
+    uint64_t bytes() const { return (size_ + 1) / 2; }
+    const uint8_t* data() const { return data_; }
+    int maxDistance() const { return maxDistance_; }
+    // Entries per depth from the last build (empty for attached tables)
+    const std::vector<uint64_t>& depthCounts() const { return depthCounts_; }
+
+    int get(uint64_t i) const { return (data_[i >> 1] >> ((i & 1) * 4)) & 0xF; }
+
+    void attach(const uint8_t* data, uint64_t size, int maxDistance);
+    void adopt(std::vector<uint8_t>& bytes, uint64_t size, std::vector<uint64_t>& depthCounts);
+
+private:
+    std::vector<uint8_t> owned_;
+    const uint8_t* data_;
+    uint64_t size_;
+    int maxDistance_;
+    std::vector<uint64_t> depthCounts_;
+};
+
+// Distance table for one abstraction: the positions of `tracked` stickers of one color,
+// as a 64-bit mask ranked colexicographically (C(64, tracked) entries). Distance is the
+// fewest moves that bring every tracked sticker onto a home cell of its color, so it is
+// a lower bound for solving the full puzzle.
+class TesseractPatternDb {
+public:
+    TesseractPatternDb();
+
+    // pool == nullptr builds on the calling thread
+    void build(int color, int tracked, WorkStealingPool* pool = nullptr);
+    bool attach(const PdbFile& file, int color, int tracked);
+    PdbTableSource source() const;
+
+    bool empty() const { return table_.empty(); }
+    int color() const { return color_; }
+    int tracked() const { return tracked_; }
+    uint64_t size() const { return table_.size(); }
+    int maxDistance() const { return table_.maxDistance(); }
+    const DistanceTable& table() const { return table_; }
+
+    int lookup(uint64_t positions) const { return table_.get(rank(positions)); }
+
+    // Colex rank of a k-subset of 0..63 given as a mask, and its inverse
+    static uint64_t rank(uint64_t positions);
+    static uint64_t unrank(uint64_t r, int k);
+    static uint64_t binomial(int n, int k);
+    // Home cells of a color in the solved state
+    static uint64_t homeMask(int color);
+
+private:
+    int color_;
+    int tracked_;
+    DistanceTable table_;
+};
+
+// Max over per-color pattern databases. Each color's 8 stickers are split into two
+// tracked groups (overlapping when tracked > 4), giving 16 masks that are moved
+// alongside the search state.
+constexpr int HEURISTIC_GROUPS = 16;
+
+class TesseractHeuristic {
+public:
+    void build(int tracked = 4, WorkStealingPool* pool = nullptr);
+    // Use the 8 color tables of a mapped file; false if any is missing
+    bool attach(const PdbFile& file, int tracked);
+    bool ready() const { return !dbs_[0].empty(); }
+    int tracked() const { return dbs_[0].tracked(); }
+    const TesseractPatternDb& db(int color) const { return dbs_[color]; }
+
+    void initGroups(const TesseractState& state, uint64_t groups[HEURISTIC_GROUPS]) const;
+    static void applyMove(uint64_t groups[HEURISTIC_GROUPS], TesseractOp op) {
+        for (int g = 0; g < HEURISTIC_GROUPS; g++) groups[g] = TesseractPuzzle::permuteMask(groups[g], op);
+    }
+    int estimate(const uint64_t groups[HEURISTIC_GROUPS]) const {
+        int h = 0;
+        for (int g = 0; g < HEURISTIC_GROUPS; g++) {
+            int d = dbs_[g >> 1].lookup(groups[g]);
+            if (d > h) h = d;
+        }
+        return h;
+    }
+
+private:
+    TesseractPatternDb dbs_[8];
+};
+
+// RubikCube corner or edge subset: each tracked piece is located by the facelet its
+// reference sticker sits on, i.e. (slot, orientation). Ranked as a partial permutation
+// of slots times orientation digits: n!/(n-k)! * o^k entries (7 corners = 8! * 3^7).
+enum RubikPieceKind { RUBIK_CORNER_PIECES = 0, RUBIK_EDGE_PIECES = 1 };
+
+class RubikPatternDb {
+public:
+    RubikPatternDb();
+
+    void build(int kind, uint32_t pieceMask, WorkStealingPool* pool = nullptr);
+    bool attach(const PdbFile& file, int kind, uint32_t pieceMask);
+    PdbTableSource source() const;
+
+    bool empty() const { return table_.empty(); }
+    int kind() const { return kind_; }
+    uint32_t pieceMask() const { return mask_; }
+    int tracked() const { return tracked_; }
+    uint64_t size() const { return table_.size(); }
+    int maxDistance() const { return table_.maxDistance(); }
+    const DistanceTable& table() const { return table_; }
+
+    int lookup(const RubikCube& cube) const;
+
+    // Reference-sticker facelets of the tracked pieces in cube (ascending piece order)
+    void locate(const RubikCube& cube, uint8_t facelets[12]) const;
+    uint64_t rank(const uint8_t facelets[12]) const;
+    void unrank(uint64_t r, uint8_t facelets[12]) const;
+    static uint64_t sizeFor(int kind, int tracked);
+
+private:
+    int kind_;
+    uint32_t mask_;
+    int tracked_;
+    int pieces_[12];
+    DistanceTable table_;
+};
+
+#endif // PATTERN_DB_H
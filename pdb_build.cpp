@@ -0,0 +1,126 @@
+// Pattern Database Builder
+// Builds Tesseract / Rubik distance tables offline and writes one mmap-able file:
+//   pdb_build [-o FILE] [--tracked K] [--no-tesseract] [--corners MASK] [--edges MASK]
+//             [--rubik] [--threads N]
+//   pdb_build --verify FILE
+
+#include "pattern_db.h"
+#include "pdb_file.h"
+#include "work_stealing_pool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+static const char* tableName(uint32_t kind) {
+    switch (kind) {
+        case PDB_TESSERACT_STICKERS: return "tesseract";
+        case PDB_RUBIK_CORNERS: return "corners";
+        case PDB_RUBIK_EDGES: return "edges";
+        case PDB_KOCIEMBA: return "kociemba";
+        default: return "unknown";
+    }
+}
+
+static void printHistogram(const DistanceTable& table, double seconds) {
+    const std::vector<uint64_t>& counts = table.depthCounts();
+    for (size_t d = 0; d < counts.size(); d++)
+        std::printf("    %2zu: %llu\n", d, static_cast<unsigned long long>(counts[d]));
+    std::printf("    %llu entries, %llu bytes, max %d, %.2f s\n",
+                static_cast<unsigned long long>(table.size()), static_cast<unsigned long long>(table.bytes()),
+                table.maxDistance(), seconds);
+}
+
+static int verifyFile(const std::string& path) {
+    PdbFile file;
+    std::string error;
+    if (!file.open(path, &error)) { std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str()); return 1; }
+    for (size_t i = 0; i < file.tableCount(); i++) {
+        const PdbTableEntry& e = file.table(i);
+        std::printf("%-9s param 0x%03x tracked %u: %llu entries, max %u\n", tableName(e.kind), e.param,
+                    e.tracked, static_cast<unsigned long long>(e.entries), e.maxDistance);
+    }
+    if (!file.verify(&error)) { std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str()); return 1; }
+    std::printf("%s: %zu tables OK\n", path.c_str(), file.tableCount());
+    return 0;
+}
+
+static void usage() {
+    std::fprintf(stderr,
+                 "usage: pdb_build [-o FILE] [--tracked K] [--no-tesseract] [--corners MASK]\n"
+                 "                 [--edges MASK] [--rubik] [--threads N]\n"
+                 "       pdb_build --verify FILE\n");
+}
+
+int main(int argc, char** argv) {
+    std::string output = "tesseract.pdb";
+    int tracked = 4;
+    int threads = 0;
+    bool tesseract = true;
+    std::vector<uint32_t> corners, edges;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--verify" && hasValue) return verifyFile(argv[++i]);
+        else if ((arg == "-o" || arg == "--output") && hasValue) output = argv[++i];
+        else if (arg == "--tracked" && hasValue) tracked = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) threads = std::atoi(argv[++i]);
+        else if (arg == "--no-tesseract") tesseract = false;
+        else if (arg == "--corners" && hasValue) corners.push_back(static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)));
+        else if (arg == "--edges" && hasValue) edges.push_back(static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)));
+        else if (arg == "--rubik") {
+            // 7 corners fix the 8th, so this is the full corner table; edges split 6 + 6
+            corners.push_back(0x7F);
+            edges.push_back(0x03F);
+            edges.push_back(0xFC0);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (tracked < 1 || tracked > 8) { std::fprintf(stderr, "--tracked must be 1..8\n"); return 2; }
+
+    WorkStealingPool pool(threads);
+    std::printf("building with %d threads\n", pool.size());
+    typedef std::chrono::steady_clock Clock;
+
+    // Tables must stay alive until the file is written
+    std::vector<std::unique_ptr<TesseractPatternDb>> tesseractDbs;
+    std::vector<std::unique_ptr<RubikPatternDb>> rubikDbs;
+    std::vector<PdbTableSource> sources;
+
+    if (tesseract) {
+        for (int c = 0; c < 8; c++) {
+            auto t0 = Clock::now();
+            tesseractDbs.emplace_back(new TesseractPatternDb());
+            tesseractDbs.back()->build(c, tracked, &pool);
+            std::printf("  tesseract color %d, %d stickers\n", c, tracked);
+            printHistogram(tesseractDbs.back()->table(),
+                           std::chrono::duration<double>(Clock::now() - t0).count());
+            sources.push_back(tesseractDbs.back()->source());
+        }
+    }
+    for (int kind = RUBIK_CORNER_PIECES; kind <= RUBIK_EDGE_PIECES; kind++) {
+        for (uint32_t mask : kind == RUBIK_CORNER_PIECES ? corners : edges) {
+            auto t0 = Clock::now();
+            rubikDbs.emplace_back(new RubikPatternDb());
+            rubikDbs.back()->build(kind, mask, &pool);
+            std::printf("  rubik %s 0x%03x\n", kind == RUBIK_CORNER_PIECES ? "corners" : "edges",
+                        rubikDbs.back()->pieceMask());
+            printHistogram(rubikDbs.back()->table(), std::chrono::duration<double>(Clock::now() - t0).count());
+            sources.push_back(rubikDbs.back()->source());
+        }
+    }
+
+    std::string error;
+    if (!writePdbFile(output, sources, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::printf("wrote %zu tables to %s\n", sources.size(), output.c_str());
+    return 0;
+}
@@ -0,0 +1,216 @@
+// Pattern Database File Implementation
+
+#include "pdb_file.h"
+#include "bit_ops.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char PDB_MAGIC[8] = {'T', '4', 'P', 'D', 'B', 0, 0, 0};
+
+static void setError(std::string* error, const std::string& msg) {
+    if (error) *error = msg;
+}
+
+uint64_t pdbChecksum(const uint8_t* data, size_t bytes) {
+    const uint64_t k = 0x9E3779B97F4A7C15ull;
+    uint64_t h = 0xCBF29CE484222325ull ^ (static_cast<uint64_t>(bytes) * k);
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h = rotl64(h ^ (w * k), 31) * 0xBF58476D1CE4E5B9ull;
+    }
+    uint64_t tail = 0;
+    for (size_t j = 0; i + j < bytes; j++) tail |= static_cast<uint64_t>(data[i + j]) << (8 * j);
+    h = rotl64(h ^ (tail * k), 31) * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 29;
+    h *= 0x94D049BB133111EBull;
+    return h ^ (h >> 32);
+}
+
+// ---------------------------------------------------------------------------
+// MappedFile
+
+MappedFile::MappedFile() : data_(nullptr), size_(0) {
+#if defined(_WIN32)
+    file_ = nullptr;
+    mapping_ = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { CloseHandle(file); return false; }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { CloseHandle(file); return false; }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+    file_ = file;
+    mapping_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file referenced
+    if (p == MAP_FAILED) return false;
+    data_ = static_cast<const uint8_t*>(p);
+    size_ = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+    if (!data_) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    CloseHandle(static_cast<HANDLE>(file_));
+    file_ = nullptr;
+    mapping_ = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// PdbFile
+
+bool PdbFile::open(const std::string& path, std::string* error) {
+    entries_ = nullptr;
+    count_ = 0;
+    if (!mapped_.open(path)) { setError(error, "cannot map " + path); return false; }
+    const uint8_t* base = mapped_.data();
+    size_t size = mapped_.size();
+    PdbFileHeader header;
+    if (size < sizeof(header)) { mapped_.close(); setError(error, "file too small"); return false; }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, PDB_MAGIC, 8) != 0) {
+        mapped_.close(); setError(error, "not a pattern database file"); return false;
+    }
+    if (header.version != PDB_FILE_VERSION) {
+        mapped_.close(); setError(error, "unsupported version " + std::to_string(header.version)); return false;
+    }
+    size_t dirBytes = static_cast<size_t>(header.tableCount) * sizeof(PdbTableEntry);
+    if (header.fileSize != size || sizeof(header) + dirBytes > size) {
+        mapped_.close(); setError(error, "truncated file"); return false;
+    }
+    const uint8_t* dir = base + sizeof(header);
+    if (pdbChecksum(dir, dirBytes) != header.directoryChecksum) {
+        mapped_.close(); setError(error, "directory checksum mismatch"); return false;
+    }
+    entries_ = reinterpret_cast<const PdbTableEntry*>(dir);
+    count_ = header.tableCount;
+    for (size_t i = 0; i < count_; i++) {
+        const PdbTableEntry& e = entries_[i];
+        if (e.offset % PDB_TABLE_ALIGN != 0 || e.bytes > size || e.offset > size - e.bytes) {
+            entries_ = nullptr; count_ = 0; mapped_.close();
+            setError(error, "table " + std::to_string(i) + " out of range");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PdbFile::verify(std::string* error) const {
+    for (size_t i = 0; i < count_; i++) {
+        const PdbTableEntry& e = entries_[i];
+        if (pdbChecksum(tableData(e), static_cast<size_t>(e.bytes)) != e.checksum) {
+            setError(error, "table " + std::to_string(i) + " checksum mismatch");
+            return false;
+        }
+    }
+    return true;
+}
+
+const PdbTableEntry* PdbFile::find(uint32_t kind, uint32_t param, uint32_t tracked) const {
+    for (size_t i = 0; i < count_; i++)
+        if (entries_[i].kind == kind && entries_[i].param == param && entries_[i].tracked == tracked)
+            return &entries_[i];
+    return nullptr;
+}
+
+// A temporary name next to path, unique per process and call, so concurrent writers of the
+// same cache never share one
+static std::string tempPath(const std::string& path) {
+    static std::atomic<unsigned> counter(0);
+#if defined(_WIN32)
+    unsigned long pid = GetCurrentProcessId();
+#else
+    unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    return path + "." + std::to_string(pid) + "." + std::to_string(counter++) + ".tmp";
+}
+
+bool writePdbFile(const std::string& path, const std::vector<PdbTableSource>& tables, std::string* error) {
+    std::vector<PdbTableEntry> dir;
+    uint64_t offset = sizeof(PdbFileHeader) + tables.size() * sizeof(PdbTableEntry);
+    for (const PdbTableSource& t : tables) {
+        PdbTableEntry e = t.entry;
+        offset = (offset + PDB_TABLE_ALIGN - 1) / PDB_TABLE_ALIGN * PDB_TABLE_ALIGN;
+        e.offset = offset;
+        e.checksum = pdbChecksum(t.data, static_cast<size_t>(e.bytes));
+        offset += e.bytes;
+        dir.push_back(e);
+    }
+    PdbFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PDB_MAGIC, 8);
+    header.version = PDB_FILE_VERSION;
+    header.tableCount = static_cast<uint32_t>(dir.size());
+    header.fileSize = offset;
+    header.directoryChecksum = pdbChecksum(reinterpret_cast<const uint8_t*>(dir.data()),
+                                           dir.size() * sizeof(PdbTableEntry));
+
+    // Write to a temporary name and rename over path, so readers never map a half-written file
+    std::string tmp = tempPath(path);
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) { setError(error, "cannot create " + tmp); return false; }
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    if (!dir.empty()) ok = ok && std::fwrite(dir.data(), sizeof(PdbTableEntry), dir.size(), f) == dir.size();
+    uint64_t pos = sizeof(header) + dir.size() * sizeof(PdbTableEntry);
+    static const uint8_t zeros[PDB_TABLE_ALIGN] = {0};
+    for (size_t i = 0; i < dir.size() && ok; i++) {
+        if (dir[i].offset > pos) ok = std::fwrite(zeros, 1, static_cast<size_t>(dir[i].offset - pos), f) == dir[i].offset - pos;
+        ok = ok && std::fwrite(tables[i].data, 1, static_cast<size_t>(dir[i].bytes), f) == dir[i].bytes;
+        pos = dir[i].offset + dir[i].bytes;
+    }
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) { std::remove(tmp.c_str()); setError(error, "write failed for " + tmp); return false; }
+#if defined(_WIN32)
+    std::remove(path.c_str());  // Windows rename does not replace an existing file
+#endif
+    // POSIX rename replaces path atomically: readers see the old file or the new one
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        setError(error, "cannot rename to " + path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,101 @@
+// Pattern Database File
+// Versioned, checksummed on-disk tables, memory-mapped read-only at load time
+
+#ifndef PDB_FILE_H
+#define PDB_FILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Layout (little-endian host byte order):
+//   PdbFileHeader | PdbTableEntry[tableCount] | padding | table data, each page-aligned.
+// open() only checks the header and directory, so loading is a single mmap and the
+// pages are shared through the page cache by every process that maps the file.
+// verify() walks the table data and checks each table's checksum.
+constexpr uint32_t PDB_FILE_VERSION = 1;
+constexpr uint64_t PDB_TABLE_ALIGN = 4096;
+
+enum PdbTableKind {
+    PDB_TESSERACT_STICKERS = 1,  // param = color, tracked = stickers per group
+    PDB_RUBIK_CORNERS = 2,       // param = tracked corner mask (bit per corner)
+    PDB_RUBIK_EDGES = 3,         // param = tracked edge mask (bit per edge)
+    PDB_KOCIEMBA = 4             // param = KociembaTable id (move or pruning table)
+};
+
+struct PdbFileHeader {
+    char magic[8];               // "T4PDB" + 3 zero bytes
+    uint32_t version;
+    uint32_t tableCount;
+    uint64_t fileSize;
+    uint64_t directoryChecksum;  // over the PdbTableEntry array
+    uint8_t reserved[32];
+};
+
+struct PdbTableEntry {
+    uint32_t kind;
+    uint32_t param;
+    uint32_t tracked;
+    uint32_t maxDistance;
+    uint64_t entries;    // logical entries (nibbles for distance tables)
+    uint64_t offset;     // from the start of the file
+    uint64_t bytes;
+    uint64_t checksum;   // over the table bytes
+};
+
+static_assert(sizeof(PdbFileHeader) == 64, "PdbFileHeader layout");
+static_assert(sizeof(PdbTableEntry) == 48, "PdbTableEntry layout");
+
+// 64-bit checksum over a byte range (word-at-a-time multiply/rotate mix)
+uint64_t pdbChecksum(const uint8_t* data, size_t bytes);
+
+// Read-only memory mapping of a whole file (mmap / MapViewOfFile)
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+#if defined(_WIN32)
+    void* file_;
+    void* mapping_;
+#endif
+};
+
+class PdbFile {
+public:
+    bool open(const std::string& path, std::string* error = nullptr);
+    bool verify(std::string* error = nullptr) const;
+    bool isOpen() const { return mapped_.data() != nullptr; }
+    void close() { mapped_.close(); entries_ = nullptr; count_ = 0; }
+
+    size_t tableCount() const { return count_; }
+    const PdbTableEntry& table(size_t i) const { return entries_[i]; }
+    const PdbTableEntry* find(uint32_t kind, uint32_t param, uint32_t tracked) const;
+    const uint8_t* tableData(const PdbTableEntry& e) const { return mapped_.data() + e.offset; }
+
+private:
+    MappedFile mapped_;
+    const PdbTableEntry* entries_ = nullptr;
+    size_t count_ = 0;
+};
+
+// One table to write; offset and checksum are filled in by writePdbFile
+struct PdbTableSource {
+    PdbTableEntry entry;
+    const uint8_t* data;
+};
+
+bool writePdbFile(const std::string& path, const std::vector<PdbTableSource>& tables, std::string* error = nullptr);
+
+#endif // PDB_FILE_H
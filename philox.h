@@ -0,0 +1,69 @@
+// Philox Random Numbers
+// Counter-based Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"):
+// each 128-bit output block is a pure function of (key, counter), so stream k of a seed can
+// be generated on any thread, in any order, with the same result on every platform.
+
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+inline void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+        uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+        uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<uint32_t>(p1);
+        c3 = static_cast<uint32_t>(p0);
+        c0 = n0;
+        c2 = n2;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+// 32-bit draws from stream `stream` of `seed`: counter = (block, 0, stream lo, stream hi)
+class PhiloxStream {
+public:
+    PhiloxStream(uint64_t seed, uint64_t stream) : block_(0), used_(4) {
+        key_[0] = static_cast<uint32_t>(seed);
+        key_[1] = static_cast<uint32_t>(seed >> 32);
+        stream_[0] = static_cast<uint32_t>(stream);
+        stream_[1] = static_cast<uint32_t>(stream >> 32);
+    }
+
+    uint32_t next() {
+        if (used_ == 4) {
+            uint32_t counter[4] = {block_++, 0, stream_[0], stream_[1]};
+            philox4x32(counter, key_, out_);
+            used_ = 0;
+        }
+        return out_[used_++];
+    }
+
+    // Uniform in [0, n) by multiply-shift (bias below n / 2^32)
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>((static_cast<uint64_t>(next()) * n) >> 32); }
+
+private:
+    uint32_t key_[2];
+    uint32_t stream_[2];
+    uint32_t block_;
+    uint32_t out_[4];
+    int used_;
+};
+
+// Seed for calls that do not pass one (random_device mixed with the clock, since some
+// standard libraries implement random_device deterministically)
+inline uint64_t freshSeed() {
+    std::random_device rd;
+    uint64_t s = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    return s ^ static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+}
+
+#endif // PHILOX_H
@@ -11,3 +11,15 @@ Vec4 project4Dto3D(const Vec4& p, float wDistance) {
     float scale = wDistance / denom;
     return Vec4(p.x * scale, p.y * scale, p.z * scale, 0.0f);
 }
+
+void projectPoints(const Vec4SoA& in, const Vec4SoA& out, size_t n, float wDistance) {
+    for (size_t i = 0; i < n; i++) {
+        float denom = wDistance + in.w[i];
+        denom = std::fabs(denom) < 1e-6f ? 1e-6f : denom;
+        float scale = wDistance / denom;
+        out.x[i] = in.x[i] * scale;
+        out.y[i] = in.y[i] * scale;
+        out.z[i] = in.z[i] * scale;
+        out.w[i] = 0.0f;
+    }
+}
@@ -11,4 +11,8 @@
 // Returns (x,y,z) in 3D; caller uses x,y,z for rendering
 Vec4 project4Dto3D(const Vec4& p, float wDistance);
 
+// project4Dto3D over n SoA points (in == out is allowed); out.w is set to 0 likewise.
+// Branch-free, so the compiler vectorizes it.
+void projectPoints(const Vec4SoA& in, const Vec4SoA& out, size_t n, float wDistance);
+
 #endif // PROJECTION_4D_H
@@ -0,0 +1,425 @@
+// Puzzle Gallery Implementation
+
+#include "puzzle_gallery.h"
+#include <SFML/Window/Context.hpp>
+#include <algorithm>
+#include <cstring>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// GL 2.0 - 3.3 enums, spelled out so no glext.h is needed
+enum {
+    GALLERY_ARRAY_BUFFER = 0x8892,
+    GALLERY_STATIC_DRAW = 0x88E4,
+    GALLERY_DYNAMIC_DRAW = 0x88E8,
+    GALLERY_VERTEX_SHADER = 0x8B31,
+    GALLERY_FRAGMENT_SHADER = 0x8B30,
+    GALLERY_COMPILE_STATUS = 0x8B81,
+    GALLERY_LINK_STATUS = 0x8B82,
+    GALLERY_FRAMEBUFFER = 0x8D40,
+    GALLERY_DRAW_FRAMEBUFFER = 0x8CA9,
+    GALLERY_COLOR_ATTACHMENT0 = 0x8CE0,
+    GALLERY_FRAMEBUFFER_COMPLETE = 0x8CD5,
+    GALLERY_TIME_ELAPSED = 0x88BF,
+    GALLERY_QUERY_RESULT = 0x8866,
+    GALLERY_QUERY_RESULT_AVAILABLE = 0x8867,
+};
+
+// Vertex attribute locations
+enum { ATTR_CORNER = 0, ATTR_SLOT = 1, ATTR_PLACEMENT = 2, ATTR_STICKERS = 3 };
+
+// Entry points past GL 1.1, by signature
+static struct {
+    void(APIENTRY* genBuffers)(GLsizei, GLuint*);
+    void(APIENTRY* bindBuffer)(GLenum, GLuint);
+    void(APIENTRY* bufferData)(GLenum, std::ptrdiff_t, const void*, GLenum);
+    void(APIENTRY* bufferSubData)(GLenum, std::ptrdiff_t, std::ptrdiff_t, const void*);
+    GLuint(APIENTRY* createShader)(GLenum);
+    void(APIENTRY* shaderSource)(GLuint, GLsizei, const char* const*, const GLint*);
+    void(APIENTRY* compileShader)(GLuint);
+    void(APIENTRY* getShaderiv)(GLuint, GLenum, GLint*);
+    void(APIENTRY* getShaderInfoLog)(GLuint, GLsizei, GLsizei*, char*);
+    void(APIENTRY* deleteShader)(GLuint);
+    GLuint(APIENTRY* createProgram)();
+    void(APIENTRY* attachShader)(GLuint, GLuint);
+    void(APIENTRY* bindAttribLocation)(GLuint, GLuint, const char*);
+    void(APIENTRY* linkProgram)(GLuint);
+    void(APIENTRY* getProgramiv)(GLuint, GLenum, GLint*);
+    void(APIENTRY* getProgramInfoLog)(GLuint, GLsizei, GLsizei*, char*);
+    void(APIENTRY* deleteProgram)(GLuint);
+    void(APIENTRY* useProgram)(GLuint);
+    GLint(APIENTRY* getUniformLocation)(GLuint, const char*);
+    void(APIENTRY* uniform2f)(GLint, GLfloat, GLfloat);
+    void(APIENTRY* uniform3fv)(GLint, GLsizei, const GLfloat*);
+    void(APIENTRY* enableVertexAttribArray)(GLuint);
+    void(APIENTRY* disableVertexAttribArray)(GLuint);
+    void(APIENTRY* vertexAttribPointer)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+    void(APIENTRY* vertexAttribDivisor)(GLuint, GLuint);
+    void(APIENTRY* drawArraysInstanced)(GLenum, GLint, GLsizei, GLsizei);
+    void(APIENTRY* genFramebuffers)(GLsizei, GLuint*);
+    void(APIENTRY* bindFramebuffer)(GLenum, GLuint);
+    void(APIENTRY* framebufferTexture2D)(GLenum, GLenum, GLenum, GLuint, GLint);
+    GLenum(APIENTRY* checkFramebufferStatus)(GLenum);
+    void(APIENTRY* blitFramebuffer)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum);
+    // Timer queries are optional: without them the redraw limit stays at tilesPerFrame
+    void(APIENTRY* genQueries)(GLsizei, GLuint*);
+    void(APIENTRY* beginQuery)(GLenum, GLuint);
+    void(APIENTRY* endQuery)(GLenum);
+    void(APIENTRY* getQueryObjectiv)(GLuint, GLenum, GLint*);
+    void(APIENTRY* getQueryObjectui64v)(GLuint, GLenum, uint64_t*);
+} gl;
+
+// The core name, else the extension's
+template <typename Fn>
+static bool loadFunction(Fn& fn, const char* name, const char* alternative = nullptr) {
+    fn = reinterpret_cast<Fn>(sf::Context::getFunction(name));
+    if (!fn && alternative) fn = reinterpret_cast<Fn>(sf::Context::getFunction(alternative));
+    return fn != nullptr;
+}
+
+static bool loadGalleryFunctions() {
+    bool ok = loadFunction(gl.genBuffers, "glGenBuffers") && loadFunction(gl.bindBuffer, "glBindBuffer") &&
+              loadFunction(gl.bufferData, "glBufferData") && loadFunction(gl.bufferSubData, "glBufferSubData") &&
+              loadFunction(gl.createShader, "glCreateShader") && loadFunction(gl.shaderSource, "glShaderSource") &&
+              loadFunction(gl.compileShader, "glCompileShader") && loadFunction(gl.getShaderiv, "glGetShaderiv") &&
+              loadFunction(gl.getShaderInfoLog, "glGetShaderInfoLog") &&
+              loadFunction(gl.deleteShader, "glDeleteShader") && loadFunction(gl.createProgram, "glCreateProgram") &&
+              loadFunction(gl.attachShader, "glAttachShader") &&
+              loadFunction(gl.bindAttribLocation, "glBindAttribLocation") &&
+              loadFunction(gl.linkProgram, "glLinkProgram") && loadFunction(gl.getProgramiv, "glGetProgramiv") &&
+              loadFunction(gl.getProgramInfoLog, "glGetProgramInfoLog") &&
+              loadFunction(gl.deleteProgram, "glDeleteProgram") && loadFunction(gl.useProgram, "glUseProgram") &&
+              loadFunction(gl.getUniformLocation, "glGetUniformLocation") &&
+              loadFunction(gl.uniform2f, "glUniform2f") && loadFunction(gl.uniform3fv, "glUniform3fv") &&
+              loadFunction(gl.enableVertexAttribArray, "glEnableVertexAttribArray") &&
+              loadFunction(gl.disableVertexAttribArray, "glDisableVertexAttribArray") &&
+              loadFunction(gl.vertexAttribPointer, "glVertexAttribPointer") &&
+              loadFunction(gl.vertexAttribDivisor, "glVertexAttribDivisor", "glVertexAttribDivisorARB") &&
+              loadFunction(gl.drawArraysInstanced, "glDrawArraysInstanced", "glDrawArraysInstancedARB") &&
+              loadFunction(gl.genFramebuffers, "glGenFramebuffers", "glGenFramebuffersEXT") &&
+              loadFunction(gl.bindFramebuffer, "glBindFramebuffer", "glBindFramebufferEXT") &&
+              loadFunction(gl.framebufferTexture2D, "glFramebufferTexture2D", "glFramebufferTexture2DEXT") &&
+              loadFunction(gl.checkFramebufferStatus, "glCheckFramebufferStatus", "glCheckFramebufferStatusEXT") &&
+              loadFunction(gl.blitFramebuffer, "glBlitFramebuffer", "glBlitFramebufferEXT");
+    bool timers = loadFunction(gl.genQueries, "glGenQueries") && loadFunction(gl.beginQuery, "glBeginQuery") &&
+                  loadFunction(gl.endQuery, "glEndQuery") &&
+                  loadFunction(gl.getQueryObjectiv, "glGetQueryObjectiv") &&
+                  loadFunction(gl.getQueryObjectui64v, "glGetQueryObjectui64v", "glGetQueryObjectui64vEXT");
+    if (!timers) gl.genQueries = nullptr;
+    return ok;
+}
+
+// Each vertex picks its sticker's color out of the instance's four by the one-hot slot mask
+static const char* VERTEX_SHADER =
+    "#version 120\n"
+    "attribute vec2 corner;\n"     // position inside the cubie, 0..1
+    "attribute vec4 slot;\n"       // one-hot sticker slot
+    "attribute vec3 placement;\n"  // per cubie: top-left corner and size, in pixels
+    "attribute vec4 stickers;\n"   // per cubie: CellColor of slots 0..3
+    "uniform vec2 viewport;\n"
+    "uniform vec3 palette[8];\n"
+    "varying vec3 color;\n"
+    "void main() {\n"
+    "    color = palette[int(dot(stickers, slot) + 0.5)];\n"
+    "    vec2 p = (placement.xy + corner * placement.z) / viewport;\n"
+    "    gl_Position = vec4(p.x * 2.0 - 1.0, 1.0 - p.y * 2.0, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* FRAGMENT_SHADER =
+    "#version 120\n"
+    "varying vec3 color;\n"
+    "void main() { gl_FragColor = vec4(color, 1.0); }\n";
+
+// CellColor RGB, as in the 3D view
+static const float PALETTE[8][3] = {
+    {1.0f, 0.0f, 0.0f}, {1.0f, 0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 0.0f},
+    {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f},
+};
+
+static const int MESH_VERTICES = 24;  // two triangles per sticker slot
+static const int CUBIES = 16;
+static const float BACKGROUND = 0.08f;
+static const float STICKER_GAP = 0.06f;  // fraction of a cubie between stickers
+static const float TILE_MARGIN = 0.08f;  // fraction of a tile around its cubies
+
+static GLuint compileShader(GLenum type, const char* source, std::string* error) {
+    GLuint shader = gl.createShader(type);
+    gl.shaderSource(shader, 1, &source, nullptr);
+    gl.compileShader(shader);
+    GLint ok = 0;
+    gl.getShaderiv(shader, GALLERY_COMPILE_STATUS, &ok);
+    if (ok) return shader;
+    char log[512] = "";
+    gl.getShaderInfoLog(shader, sizeof(log), nullptr, log);
+    if (error) *error = std::string("gallery shader: ") + log;
+    gl.deleteShader(shader);
+    return 0;
+}
+
+// Attribute pointer at a byte offset into the bound buffer
+static const void* bufferOffset(size_t offset) { return reinterpret_cast<const void*>(offset); }
+
+PuzzleGallery::PuzzleGallery(const GalleryOptions& options)
+    : options_(options), count_(0), slots_(0), pending_(0), width_(0), height_(0), program_(0),
+      viewportLocation_(-1), meshBuffer_(0), placementBuffer_(0), colorBuffer_(0), colorCapacity_(0),
+      framebuffer_(0), texture_(0), nextQuery_(0), msPerTile_(0.0) {
+    for (int q = 0; q < QUERIES; q++) {
+        queries_[q] = 0;
+        queryTiles_[q] = 0;
+    }
+    stats_.tilesPerFrame = options_.tilesPerFrame;
+}
+
+bool PuzzleGallery::initialize(std::string* error) {
+    if (!loadGalleryFunctions()) {
+        if (error) *error = "gallery needs GL 3.3 or instanced arrays and framebuffer objects";
+        return false;
+    }
+    GLuint vertex = compileShader(GALLERY_VERTEX_SHADER, VERTEX_SHADER, error);
+    if (!vertex) return false;
+    GLuint fragment = compileShader(GALLERY_FRAGMENT_SHADER, FRAGMENT_SHADER, error);
+    if (!fragment) {
+        gl.deleteShader(vertex);
+        return false;
+    }
+    GLuint program = gl.createProgram();
+    gl.attachShader(program, vertex);
+    gl.attachShader(program, fragment);
+    // corner on location 0: compatibility contexts draw nothing without attribute 0 enabled
+    gl.bindAttribLocation(program, ATTR_CORNER, "corner");
+    gl.bindAttribLocation(program, ATTR_SLOT, "slot");
+    gl.bindAttribLocation(program, ATTR_PLACEMENT, "placement");
+    gl.bindAttribLocation(program, ATTR_STICKERS, "stickers");
+    gl.linkProgram(program);
+    gl.deleteShader(vertex);
+    gl.deleteShader(fragment);
+    GLint linked = 0;
+    gl.getProgramiv(program, GALLERY_LINK_STATUS, &linked);
+    if (!linked) {
+        char log[512] = "";
+        gl.getProgramInfoLog(program, sizeof(log), nullptr, log);
+        if (error) *error = std::string("gallery shader: ") + log;
+        gl.deleteProgram(program);
+        return false;
+    }
+    gl.useProgram(program);
+    gl.uniform3fv(gl.getUniformLocation(program, "palette"), 8, &PALETTE[0][0]);
+    gl.useProgram(0);
+    viewportLocation_ = gl.getUniformLocation(program, "viewport");
+
+    // Sticker slot s of a cubie: column s % 2, row s / 2
+    float mesh[MESH_VERTICES][6];
+    static const float QUAD[6][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}};
+    for (int s = 0; s < 4; s++)
+        for (int k = 0; k < 6; k++) {
+            float* v = mesh[s * 6 + k];
+            float size = 0.5f - 2.0f * STICKER_GAP;
+            v[0] = (s % 2) * 0.5f + STICKER_GAP + QUAD[k][0] * size;
+            v[1] = (s / 2) * 0.5f + STICKER_GAP + QUAD[k][1] * size;
+            for (int j = 0; j < 4; j++) v[2 + j] = j == s ? 1.0f : 0.0f;
+        }
+    gl.genBuffers(1, &meshBuffer_);
+    gl.genBuffers(1, &placementBuffer_);
+    gl.genBuffers(1, &colorBuffer_);
+    gl.bindBuffer(GALLERY_ARRAY_BUFFER, meshBuffer_);
+    gl.bufferData(GALLERY_ARRAY_BUFFER, sizeof(mesh), mesh, GALLERY_STATIC_DRAW);
+    gl.bindBuffer(GALLERY_ARRAY_BUFFER, 0);
+    gl.genFramebuffers(1, &framebuffer_);
+    glGenTextures(1, &texture_);
+    if (gl.genQueries) gl.genQueries(QUERIES, queries_);
+    program_ = program;
+    return true;
+}
+
+void PuzzleGallery::resize(size_t count) {
+    const TesseractState& solved = TesseractPuzzle::solvedState();
+    uint8_t tile[TESSERACT_STICKERS];
+    for (int s = 0; s < TESSERACT_STICKERS; s++) tile[s] = static_cast<uint8_t>(solved.getColor(s));
+    colors_.resize(count * TESSERACT_STICKERS);
+    dirty_.resize(count, 1);
+    for (size_t i = count_; i < count; i++) std::memcpy(&colors_[i * TESSERACT_STICKERS], tile, sizeof(tile));
+    size_t slots = 1;
+    while (slots < count) slots *= 2;
+    // A new layout, or vacated tiles to clear: redraw everything on the next render
+    if (slots != slots_ || count < count_) width_ = height_ = 0;
+    if (count > count_) pending_ += count - count_;
+    slots_ = slots;
+    count_ = count;
+    if (!width_) markAllDirty();
+    stats_.tiles = count_;
+    stats_.pending = pending_;
+}
+
+void PuzzleGallery::setPuzzle(size_t index, const TesseractState& state) {
+    if (index >= count_) return;
+    uint8_t* tile = &colors_[index * TESSERACT_STICKERS];
+    bool changed = false;
+    for (int s = 0; s < TESSERACT_STICKERS; s++) {
+        uint8_t c = static_cast<uint8_t>(state.getColor(s));
+        changed |= tile[s] != c;
+        tile[s] = c;
+    }
+    if (changed && !dirty_[index]) {
+        dirty_[index] = 1;
+        pending_++;
+        stats_.pending = pending_;
+    }
+}
+
+void PuzzleGallery::markAllDirty() {
+    std::fill(dirty_.begin(), dirty_.end(), 1);
+    pending_ = count_;
+}
+
+// Square tiles in the column count that makes them largest, then per-cubie placements
+void PuzzleGallery::layout(int width, int height) {
+    width_ = width;
+    height_ = height;
+    size_t columns = 1;
+    float tile = 0.0f;
+    for (size_t c = 1; c <= slots_; c++) {
+        size_t rows = (slots_ + c - 1) / c;
+        float size = std::min(static_cast<float>(width) / c, static_cast<float>(height) / rows);
+        if (size > tile) {
+            tile = size;
+            columns = c;
+        }
+    }
+    float margin = tile * TILE_MARGIN;
+    float cubie = (tile - 2.0f * margin) / 4.0f;
+    std::vector<float> placement(slots_ * CUBIES * 3);
+    for (size_t t = 0; t < slots_; t++) {
+        float x = (t % columns) * tile + margin, y = (t / columns) * tile + margin;
+        for (int v = 0; v < CUBIES; v++) {
+            // Vertex index ix*8 + iy*4 + iz*2 + iw: row (ix, iy), column (iz, iw)
+            float* p = &placement[(t * CUBIES + v) * 3];
+            p[0] = x + (v & 3) * cubie;
+            p[1] = y + (v >> 2) * cubie;
+            p[2] = cubie;
+        }
+    }
+    gl.bindBuffer(GALLERY_ARRAY_BUFFER, placementBuffer_);
+    gl.bufferData(GALLERY_ARRAY_BUFFER, static_cast<std::ptrdiff_t>(placement.size() * sizeof(float)),
+                  placement.data(), GALLERY_STATIC_DRAW);
+    if (colorCapacity_ < slots_) {
+        colorCapacity_ = slots_;
+        gl.bindBuffer(GALLERY_ARRAY_BUFFER, colorBuffer_);
+        gl.bufferData(GALLERY_ARRAY_BUFFER, static_cast<std::ptrdiff_t>(colorCapacity_ * TESSERACT_STICKERS),
+                      nullptr, GALLERY_DYNAMIC_DRAW);
+    }
+    gl.bindBuffer(GALLERY_ARRAY_BUFFER, 0);
+
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    gl.bindFramebuffer(GALLERY_FRAMEBUFFER, framebuffer_);
+    gl.framebufferTexture2D(GALLERY_FRAMEBUFFER, GALLERY_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_, 0);
+    glPushAttrib(GL_COLOR_BUFFER_BIT);
+    glClearColor(BACKGROUND, BACKGROUND, BACKGROUND, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glPopAttrib();
+    bool complete = gl.checkFramebufferStatus(GALLERY_FRAMEBUFFER) == GALLERY_FRAMEBUFFER_COMPLETE;
+    gl.bindFramebuffer(GALLERY_FRAMEBUFFER, 0);
+    if (!complete) program_ = 0;  // no image to draw into at this size: the gallery is unavailable
+    markAllDirty();
+}
+
+// Upload the colors of tiles [first, first + count) and draw their 16 cubies each
+void PuzzleGallery::drawTiles(size_t first, size_t count) {
+    gl.bindBuffer(GALLERY_ARRAY_BUFFER, colorBuffer_);
+    gl.bufferSubData(GALLERY_ARRAY_BUFFER, static_cast<std::ptrdiff_t>(first * TESSERACT_STICKERS),
+                     static_cast<std::ptrdiff_t>(count * TESSERACT_STICKERS), &colors_[first * TESSERACT_STICKERS]);
+    // Instance attributes start at the run's first cubie, so every run draws from instance 0
+    gl.vertexAttribPointer(ATTR_STICKERS, 4, GL_UNSIGNED_BYTE, GL_FALSE, 4, bufferOffset(first * TESSERACT_STICKERS));
+    gl.bindBuffer(GALLERY_ARRAY_BUFFER, placementBuffer_);
+    gl.vertexAttribPointer(ATTR_PLACEMENT, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float),
+                           bufferOffset(first * CUBIES * 3 * sizeof(float)));
+    gl.drawArraysInstanced(GL_TRIANGLES, 0, MESH_VERTICES, static_cast<GLsizei>(count * CUBIES));
+}
+
+// Read back finished timer queries and size the redraw limit to the budget
+void PuzzleGallery::collectTimings() {
+    if (!gl.genQueries) return;
+    for (int q = 0; q < QUERIES; q++) {
+        if (!queryTiles_[q]) continue;
+        GLint available = 0;
+        gl.getQueryObjectiv(queries_[q], GALLERY_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        uint64_t ns = 0;
+        gl.getQueryObjectui64v(queries_[q], GALLERY_QUERY_RESULT, &ns);
+        stats_.gpuMs = ns * 1e-6;
+        double perTile = stats_.gpuMs / queryTiles_[q];
+        msPerTile_ = msPerTile_ > 0.0 ? 0.75 * msPerTile_ + 0.25 * perTile : perTile;
+        queryTiles_[q] = 0;
+    }
+    if (msPerTile_ <= 0.0) return;
+    // At most doubling per frame, so one short measurement cannot blow the next frame
+    size_t fit = static_cast<size_t>(options_.frameBudgetMs / msPerTile_);
+    stats_.tilesPerFrame = std::max<size_t>(1, std::min(fit, 2 * stats_.tilesPerFrame));
+}
+
+void PuzzleGallery::render(int windowWidth, int windowHeight) {
+    if (!program_ || windowWidth <= 0 || windowHeight <= 0) return;
+    if (windowWidth != width_ || windowHeight != height_) {
+        layout(windowWidth, windowHeight);
+        if (!program_) return;
+    }
+    collectTimings();
+
+    gl.bindFramebuffer(GALLERY_FRAMEBUFFER, framebuffer_);
+    if (pending_ > 0) {
+        glPushAttrib(GL_ENABLE_BIT | GL_VIEWPORT_BIT);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_LIGHTING);
+        glDisable(GL_CULL_FACE);
+        glDisable(GL_BLEND);
+        glViewport(0, 0, width_, height_);
+        gl.useProgram(program_);
+        gl.uniform2f(viewportLocation_, static_cast<GLfloat>(width_), static_cast<GLfloat>(height_));
+        gl.bindBuffer(GALLERY_ARRAY_BUFFER, meshBuffer_);
+        gl.vertexAttribPointer(ATTR_CORNER, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), bufferOffset(0));
+        gl.vertexAttribPointer(ATTR_SLOT, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), bufferOffset(2 * sizeof(float)));
+        for (GLuint a = ATTR_CORNER; a <= ATTR_STICKERS; a++) gl.enableVertexAttribArray(a);
+        gl.vertexAttribDivisor(ATTR_PLACEMENT, 1);
+        gl.vertexAttribDivisor(ATTR_STICKERS, 1);
+
+        int query = -1;
+        if (gl.genQueries && !queryTiles_[nextQuery_]) {
+            query = nextQuery_;
+            nextQuery_ = (nextQuery_ + 1) % QUERIES;
+            gl.beginQuery(GALLERY_TIME_ELAPSED, queries_[query]);
+        }
+        // Runs of consecutive out-of-date tiles, in index order, up to the limit
+        size_t budget = stats_.tilesPerFrame, drawn = 0;
+        for (size_t i = 0; i < count_ && drawn < budget; i++) {
+            if (!dirty_[i]) continue;
+            size_t run = 0;
+            while (i + run < count_ && dirty_[i + run] && drawn + run < budget) dirty_[i + run++] = 0;
+            drawTiles(i, run);
+            drawn += run;
+            i += run;
+        }
+        pending_ -= drawn;
+        if (query >= 0) {
+            gl.endQuery(GALLERY_TIME_ELAPSED);
+            queryTiles_[query] = drawn;
+        }
+
+        // Leave attribute state as SFML expects it
+        gl.vertexAttribDivisor(ATTR_PLACEMENT, 0);
+        gl.vertexAttribDivisor(ATTR_STICKERS, 0);
+        for (GLuint a = ATTR_CORNER; a <= ATTR_STICKERS; a++) gl.disableVertexAttribArray(a);
+        gl.bindBuffer(GALLERY_ARRAY_BUFFER, 0);
+        gl.useProgram(0);
+        glPopAttrib();
+    }
+
+    gl.bindFramebuffer(GALLERY_DRAW_FRAMEBUFFER, 0);
+    gl.blitFramebuffer(0, 0, width_, height_, 0, 0, width_, height_, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    gl.bindFramebuffer(GALLERY_FRAMEBUFFER, 0);
+    stats_.pending = pending_;
+}
@@ -0,0 +1,85 @@
+// Puzzle Gallery
+// Grids of thousands of tesseract states drawn with instanced draws into a cached image
+
+#ifndef PUZZLE_GALLERY_H
+#define PUZZLE_GALLERY_H
+
+#include <SFML/OpenGL.hpp>
+#include "tesseract_model.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct GalleryOptions {
+    double frameBudgetMs;  // GPU time per frame for redrawing tiles
+    size_t tilesPerFrame;  // redraw limit until timer queries have measured one (or without them)
+    GalleryOptions() : frameBudgetMs(4.0), tilesPerFrame(1024) {}
+};
+
+struct GalleryStats {
+    size_t tiles;          // puzzles shown
+    size_t pending;        // tiles whose image is out of date
+    size_t tilesPerFrame;  // current redraw limit
+    double gpuMs;          // last measured redraw time; 0 without timer queries
+    GalleryStats() : tiles(0), pending(0), tilesPerFrame(0), gpuMs(0.0) {}
+};
+
+// Each puzzle is a square tile of its 16 cubies (rows ix iy, columns iz iw), each cubie a
+// 2x2 square of its four sticker slots. Tiles are drawn with one instanced draw per run of
+// changed tiles: a 24-vertex sticker mesh, with per-cubie placement and sticker colors as
+// instance attributes. They are drawn into an offscreen image that is copied to the window
+// every frame. Only tiles whose colors changed are redrawn, and at most as many per frame
+// as the budget allows (from GPU timer queries), so frame time stays flat however many
+// puzzles are shown; a wholesale change, such as a new population, fills in over a few frames.
+class PuzzleGallery {
+public:
+    explicit PuzzleGallery(const GalleryOptions& options = GalleryOptions());
+
+    // Load the GL functions, compile the shader and upload the sticker mesh; the context
+    // must be active. Needs instanced arrays, framebuffer objects and GLSL 1.20 (GL 3.3, or
+    // 2.1 with the ARB extensions); otherwise false with the reason, and render() does nothing.
+    bool initialize(std::string* error = nullptr);
+    bool isAvailable() const { return program_ != 0; }
+
+    // Number of tiles. New tiles show the solved state and existing ones keep theirs. The
+    // grid is laid out for the next power of two, so appending one tile at a time
+    // redraws everything only when that capacity doubles.
+    void resize(size_t count);
+    size_t size() const { return count_; }
+    // Show state in tile index; a no-op when the tile already shows it
+    void setPuzzle(size_t index, const TesseractState& state);
+
+    // Redraw out-of-date tiles within the budget and copy the gallery to the window
+    void render(int windowWidth, int windowHeight);
+    const GalleryStats& stats() const { return stats_; }
+
+private:
+    static const int QUERIES = 4;  // timer queries in flight, read back a few frames later
+
+    GalleryOptions options_;
+    GalleryStats stats_;
+    size_t count_;
+    size_t slots_;                  // tiles the layout has room for
+    std::vector<uint8_t> colors_;   // 64 sticker colors per tile, in TesseractState order
+    std::vector<uint8_t> dirty_;    // per tile: its image is out of date
+    size_t pending_;
+    int width_, height_;            // size of the layout and the image
+
+    GLuint program_;
+    GLint viewportLocation_;
+    GLuint meshBuffer_, placementBuffer_, colorBuffer_;
+    size_t colorCapacity_;          // tiles colorBuffer_ has room for
+    GLuint framebuffer_, texture_;
+    GLuint queries_[QUERIES];
+    size_t queryTiles_[QUERIES];    // tiles drawn under each query; 0 = free
+    int nextQuery_;
+    double msPerTile_;              // running estimate; 0 until measured
+
+    void layout(int width, int height);
+    void markAllDirty();
+    void drawTiles(size_t first, size_t count);
+    void collectTimings();
+};
+
+#endif // PUZZLE_GALLERY_H
@@ -3,10 +3,10 @@
 
 #include "renderer.h"
 #include "projection_4d.h"
+#include "rotor_4d.h"
+#include "philox.h"
 #include <cmath>
 #include <algorithm>
-#include <cstdlib>
-#include <ctime>
 #include <cfloat>
 
 #ifndef M_PI
@@ -33,8 +33,8 @@ static int vindex(int ix, int iy, int iz, int iw) {
     return ix*8 + iy*4 + iz*2 + iw;
 }
 
-// Build 3D rotation for Rubik face (90°). Plane: XY=0, XZ=1, YZ=3.
-static Mat4x4 rubikFaceRotation(int face, bool clockwise) {
+// Quarter-turn rotor for a Rubik face (90°). Plane: XY=0, XZ=1, YZ=3.
+static Rotor4 rubikFaceRotor(int face, bool clockwise) {
     int plane4d = -1;
     float angle = clockwise ? 90.0f : -90.0f;
     switch (face) {
@@ -44,29 +44,29 @@ static Mat4x4 rubikFaceRotation(int face, bool clockwise) {
         case 3: plane4d = 1; angle = -angle; break;  // D
         case 4: plane4d = 0; break;  // F: XY
         case 5: plane4d = 0; angle = -angle; break;  // B
-        default: return Mat4x4::identity();
+        default: return Rotor4::identity();
     }
-    return rotate4D(plane4d, angle);
+    return Rotor4::plane(plane4d, angle);
 }
 
-// Apply in-progress Rubik animation rotation to vertex if in slice
-static Vec4 applyRubikAnimToVertex(const Vec4& p, int ix, int iy, int iz, int iw, const RubikAnimState& anim) {
-    if (!anim.isAnimating || anim.face < 0) return p;
-    bool inSlice = false;
-    int plane4d = -1;
-    float angle = anim.clockwise ? anim.currentAngle : -anim.currentAngle;
-    switch (anim.face) {
-        case 0: if (ix == 1) { inSlice = true; plane4d = 3; } break;
-        case 1: if (ix == 0) { inSlice = true; plane4d = 3; angle = -angle; } break;
-        case 2: if (iy == 1) { inSlice = true; plane4d = 1; } break;
-        case 3: if (iy == 0) { inSlice = true; plane4d = 1; angle = -angle; } break;
-        case 4: if (iz == 1) { inSlice = true; plane4d = 0; } break;
-        case 5: if (iz == 0) { inSlice = true; plane4d = 0; angle = -angle; } break;
-        default: break;
+// Outer vertices that turn with a Rubik face
+static bool inRubikFace(int face, int ix, int iy, int iz) {
+    switch (face) {
+        case 0: return ix == 1;
+        case 1: return ix == 0;
+        case 2: return iy == 1;
+        case 3: return iy == 0;
+        case 4: return iz == 1;
+        case 5: return iz == 0;
+        default: return false;
     }
-    if (!inSlice || plane4d < 0) return p;
-    Mat4x4 rot = rotate4D(plane4d, angle);
-    return matMul(rot, p);
+}
+
+// Fraction of a quarter turn done, as an interpolated rotor: no trig per vertex, and the
+// last frame lands exactly on the rotation that is committed afterwards
+static Mat4x4 quarterTurnProgress(const Rotor4& quarterTurn, float currentAngle) {
+    float t = std::fabs(currentAngle) / 90.0f;
+    return slerp(Rotor4::identity(), quarterTurn, t > 1.0f ? 1.0f : t).toMatrix();
 }
 
 Renderer::Renderer() {
@@ -84,28 +84,33 @@ Renderer::Renderer() {
                 }
 }
 
+// Background stars: fixed points on a sphere of radius 50, uploaded once. The first
+// STAR_COUNT are small white stars, the rest BRIGHT_STAR_COUNT larger yellowish ones.
+static const int STAR_COUNT = 150;
+static const int BRIGHT_STAR_COUNT = 15;
+
+void Renderer::buildStars() {
+    PhiloxStream rng(42, 0);
+    stars_.clear();
+    for (int i = 0; i < STAR_COUNT + BRIGHT_STAR_COUNT; i++) {
+        float theta = static_cast<float>(rng.below(628)) / 100.0f;
+        float phi = static_cast<float>(rng.below(314)) / 100.0f;
+        float r = 50.0f;
+        BatchVertex v = {r * std::sin(phi) * std::cos(theta), r * std::sin(phi) * std::sin(theta), r * std::cos(phi),
+                         0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+        if (i >= STAR_COUNT) v.b = 0.9f;
+        stars_.add(v);
+    }
+    stars_.upload(false);
+}
+
 void Renderer::drawStars() {
     glDisable(GL_LIGHTING);
     glDisable(GL_DEPTH_TEST);
     glPointSize(2.0f);
-    glBegin(GL_POINTS);
-    glColor3f(1.0f, 1.0f, 1.0f);
-    std::srand(42);
-    for (int i = 0; i < 150; i++) {
-        float theta = (float)(std::rand() % 628) / 100.0f;
-        float phi = (float)(std::rand() % 314) / 100.0f;
-        float r = 50.0f;
-        glVertex3f(r * sin(phi) * cos(theta), r * sin(phi) * sin(theta), r * cos(phi));
-    }
+    stars_.draw(GL_POINTS, 0, STAR_COUNT);
     glPointSize(3.0f);
-    glColor3f(1.0f, 1.0f, 0.9f);
-    for (int i = 0; i < 15; i++) {
-        float theta = (float)(std::rand() % 628) / 100.0f;
-        float phi = (float)(std::rand() % 314) / 100.0f;
-        float r = 50.0f;
-        glVertex3f(r * sin(phi) * cos(theta), r * sin(phi) * sin(theta), r * cos(phi));
-    }
-    glEnd();
+    stars_.draw(GL_POINTS, STAR_COUNT);
     glEnable(GL_LIGHTING);
     glEnable(GL_DEPTH_TEST);
 }
@@ -128,380 +133,239 @@ void Renderer::initialize() {
     glLightfv(GL_LIGHT0, GL_SPECULAR, lightSpecular);
     glShadeModel(GL_SMOOTH);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    loadVertexBufferFunctions();
+    buildStars();
 }
 
-void Renderer::setColor(int cellColor) {
-    switch (cellColor) {
-        case C_X_POS: glColor3f(1.0f, 0.0f, 0.0f); break;
-        case C_X_NEG: glColor3f(1.0f, 0.5f, 0.0f); break;
-        case C_Y_POS: glColor3f(1.0f, 1.0f, 1.0f); break;
-        case C_Y_NEG: glColor3f(1.0f, 1.0f, 0.0f); break;
-        case C_Z_POS: glColor3f(0.0f, 1.0f, 0.0f); break;
-        case C_Z_NEG: glColor3f(0.0f, 0.0f, 1.0f); break;
-        case C_W_POS: glColor3f(1.0f, 0.0f, 1.0f); break;
-        case C_W_NEG: glColor3f(0.0f, 1.0f, 1.0f); break;
-        default: glColor3f(0.2f, 0.2f, 0.2f); break;
-    }
-}
+// CellColor RGB; entry 8 is the grey of hidden outer faces
+static const float CELL_RGB[9][3] = {
+    {1.0f, 0.0f, 0.0f}, {1.0f, 0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f}, {0.2f, 0.2f, 0.2f},
+};
 
-void Renderer::setColorTranslucent(int cellColor, float alpha) {
-    switch (cellColor) {
-        case C_X_POS: glColor4f(1.0f, 0.0f, 0.0f, alpha); break;
-        case C_X_NEG: glColor4f(1.0f, 0.5f, 0.0f, alpha); break;
-        case C_Y_POS: glColor4f(1.0f, 1.0f, 1.0f, alpha); break;
-        case C_Y_NEG: glColor4f(1.0f, 1.0f, 0.0f, alpha); break;
-        case C_Z_POS: glColor4f(0.0f, 1.0f, 0.0f, alpha); break;
-        case C_Z_NEG: glColor4f(0.0f, 0.0f, 1.0f, alpha); break;
-        case C_W_POS: glColor4f(1.0f, 0.0f, 1.0f, alpha); break;
-        case C_W_NEG: glColor4f(0.0f, 1.0f, 1.0f, alpha); break;
-        default: glColor4f(0.2f, 0.2f, 0.2f, alpha); break;
-    }
-}
+// FaceColor RGB; entry 6 is grey for out-of-range colors
+static const float RUBIK_RGB[7][3] = {
+    {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.5f, 0.0f},
+    {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.2f, 0.2f, 0.2f},
+};
 
-void Renderer::setColorRubik(int faceColor) {
-    switch (faceColor) {
-        case WHITE: glColor3f(1.0f, 1.0f, 1.0f); break;
-        case YELLOW: glColor3f(1.0f, 1.0f, 0.0f); break;
-        case RED: glColor3f(1.0f, 0.0f, 0.0f); break;
-        case ORANGE: glColor3f(1.0f, 0.5f, 0.0f); break;
-        case GREEN: glColor3f(0.0f, 1.0f, 0.0f); break;
-        case BLUE: glColor3f(0.0f, 0.0f, 1.0f); break;
-        default: glColor3f(0.2f, 0.2f, 0.2f); break;
-    }
+static void setRGBA(float out[4], const float rgb[3], float alpha) {
+    out[0] = rgb[0];
+    out[1] = rgb[1];
+    out[2] = rgb[2];
+    out[3] = alpha;
 }
 
-void Renderer::drawFaceRubik(float x, float y, float z, float size, int faceIndex, int faceColor) {
-    float s = size / 2.0f;
-    float offset = 0.01f;
-    GLfloat matSpecular[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    GLfloat matShininess[] = {128.0f};
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, matShininess);
-    setColorRubik(faceColor);
-    glFlush();  // Ensure no pending commands before glBegin (avoids crash on some drivers)
-    glBegin(GL_TRIANGLES);  // GL_QUADS can crash on some drivers; use triangles
-    switch (faceIndex) {
-        case 0:
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(x + s + offset, y - s, z - s);
-            glVertex3f(x + s + offset, y + s, z - s);
-            glVertex3f(x + s + offset, y + s, z + s);
-            glVertex3f(x + s + offset, y - s, z - s);
-            glVertex3f(x + s + offset, y + s, z + s);
-            glVertex3f(x + s + offset, y - s, z + s);
-            break;
-        case 1:
-            glNormal3f(-1.0f, 0.0f, 0.0f);
-            glVertex3f(x - s - offset, y - s, z + s);
-            glVertex3f(x - s - offset, y + s, z + s);
-            glVertex3f(x - s - offset, y + s, z - s);
-            glVertex3f(x - s - offset, y - s, z + s);
-            glVertex3f(x - s - offset, y + s, z - s);
-            glVertex3f(x - s - offset, y - s, z - s);
-            break;
-        case 2:
-            glNormal3f(0.0f, 1.0f, 0.0f);
-            glVertex3f(x - s, y + s + offset, z - s);
-            glVertex3f(x + s, y + s + offset, z - s);
-            glVertex3f(x + s, y + s + offset, z + s);
-            glVertex3f(x - s, y + s + offset, z - s);
-            glVertex3f(x + s, y + s + offset, z + s);
-            glVertex3f(x - s, y + s + offset, z + s);
-            break;
-        case 3:
-            glNormal3f(0.0f, -1.0f, 0.0f);
-            glVertex3f(x - s, y - s - offset, z + s);
-            glVertex3f(x + s, y - s - offset, z + s);
-            glVertex3f(x + s, y - s - offset, z - s);
-            glVertex3f(x - s, y - s - offset, z + s);
-            glVertex3f(x + s, y - s - offset, z - s);
-            glVertex3f(x - s, y - s - offset, z - s);
-            break;
-        case 4:
-            glNormal3f(0.0f, 0.0f, 1.0f);
-            glVertex3f(x - s, y - s, z + s + offset);
-            glVertex3f(x - s, y + s, z + s + offset);
-            glVertex3f(x + s, y + s, z + s + offset);
-            glVertex3f(x - s, y - s, z + s + offset);
-            glVertex3f(x + s, y + s, z + s + offset);
-            glVertex3f(x + s, y - s, z + s + offset);
-            break;
-        case 5:
-            glNormal3f(0.0f, 0.0f, -1.0f);
-            glVertex3f(x + s, y - s, z - s - offset);
-            glVertex3f(x + s, y + s, z - s - offset);
-            glVertex3f(x - s, y + s, z - s - offset);
-            glVertex3f(x + s, y - s, z - s - offset);
-            glVertex3f(x - s, y + s, z - s - offset);
-            glVertex3f(x - s, y - s, z - s - offset);
-            break;
+// Cube geometry from Rubik 1974 AD: 6 faces (+X, -X, +Y, -Y, +Z, -Z) pushed out by a small
+// offset, and 12 outline edges; corners are given as signs of the half size
+static const float FACE_NORMAL[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+static const float FACE_CORNER[6][4][3] = {
+    {{1, -1, -1}, {1, 1, -1}, {1, 1, 1}, {1, -1, 1}},
+    {{-1, -1, 1}, {-1, 1, 1}, {-1, 1, -1}, {-1, -1, -1}},
+    {{-1, 1, -1}, {1, 1, -1}, {1, 1, 1}, {-1, 1, 1}},
+    {{-1, -1, 1}, {1, -1, 1}, {1, -1, -1}, {-1, -1, -1}},
+    {{-1, -1, 1}, {-1, 1, 1}, {1, 1, 1}, {1, -1, 1}},
+    {{1, -1, -1}, {1, 1, -1}, {-1, 1, -1}, {-1, -1, -1}},
+};
+static const float EDGE_CORNER[12][2][3] = {
+    {{-1, -1, -1}, {1, -1, -1}}, {{1, -1, -1}, {1, -1, 1}}, {{1, -1, 1}, {-1, -1, 1}}, {{-1, -1, 1}, {-1, -1, -1}},
+    {{-1, 1, -1}, {1, 1, -1}}, {{1, 1, -1}, {1, 1, 1}}, {{1, 1, 1}, {-1, 1, 1}}, {{-1, 1, 1}, {-1, 1, -1}},
+    {{-1, -1, -1}, {-1, 1, -1}}, {{1, -1, -1}, {1, 1, -1}}, {{1, -1, 1}, {1, 1, 1}}, {{-1, -1, 1}, {-1, 1, 1}},
+};
+
+// Vertex at p with normal n, both turned by the row-major 3x3 rot when given
+static void addVertex(VertexBatch& batch, const float p[3], const float n[3], const float rgba[4], const float* rot) {
+    BatchVertex v;
+    if (rot) {
+        v.x = rot[0] * p[0] + rot[1] * p[1] + rot[2] * p[2];
+        v.y = rot[3] * p[0] + rot[4] * p[1] + rot[5] * p[2];
+        v.z = rot[6] * p[0] + rot[7] * p[1] + rot[8] * p[2];
+        v.nx = rot[0] * n[0] + rot[1] * n[1] + rot[2] * n[2];
+        v.ny = rot[3] * n[0] + rot[4] * n[1] + rot[5] * n[2];
+        v.nz = rot[6] * n[0] + rot[7] * n[1] + rot[8] * n[2];
+    } else {
+        v.x = p[0]; v.y = p[1]; v.z = p[2];
+        v.nx = n[0]; v.ny = n[1]; v.nz = n[2];
     }
-    glEnd();
+    v.r = rgba[0]; v.g = rgba[1]; v.b = rgba[2]; v.a = rgba[3];
+    batch.add(v);
 }
 
-void Renderer::drawCubieRubik(float x, float y, float z, float size, const RubikCube& cube, int cx, int cy, int cz, const RubikAnimState& anim) {
-    const auto& faces = cube.getFaces();
-    bool isRotating = false;
-    float rotationAngle = 0.0f;
-    int rotationAxis = 0;
-    float faceCenterX = 0.0f, faceCenterY = 0.0f, faceCenterZ = 0.0f;
-
-    if (anim.isAnimating) {
-        switch (anim.face) {
-            case RIGHT:
-                if (cx == 1) { isRotating = true; rotationAxis = 0; rotationAngle = anim.currentAngle; faceCenterX = 1.0f; }
-                break;
-            case LEFT:
-                if (cx == -1) { isRotating = true; rotationAxis = 0; rotationAngle = -anim.currentAngle; faceCenterX = -1.0f; }
-                break;
-            case UP:
-                if (cy == 1) { isRotating = true; rotationAxis = 1; rotationAngle = anim.currentAngle; faceCenterY = 1.0f; }
-                break;
-            case DOWN:
-                if (cy == -1) { isRotating = true; rotationAxis = 1; rotationAngle = -anim.currentAngle; faceCenterY = -1.0f; }
-                break;
-            case FRONT:
-                if (cz == 1) { isRotating = true; rotationAxis = 2; rotationAngle = anim.currentAngle; faceCenterZ = 1.0f; }
-                break;
-            case BACK:
-                if (cz == -1) { isRotating = true; rotationAxis = 2; rotationAngle = -anim.currentAngle; faceCenterZ = -1.0f; }
-                break;
+// One cubie centered at c: its faces as triangles into tris, its outline into lines.
+// The outline keeps the -Z normal it was lit with when drawn right after the last face.
+static void addCubie(VertexBatch& tris, VertexBatch& lines, const float c[3], float size, const float faceRGBA[6][4],
+                     const float lineRGBA[4], const float* rot) {
+    const float s = size / 2.0f, offset = 0.01f;
+    static const int TRIANGLES[6] = {0, 1, 2, 0, 2, 3};
+    for (int f = 0; f < 6; f++)
+        for (int k : TRIANGLES) {
+            const float* corner = FACE_CORNER[f][k];
+            const float* n = FACE_NORMAL[f];
+            float p[3] = {c[0] + corner[0] * s + n[0] * offset, c[1] + corner[1] * s + n[1] * offset,
+                          c[2] + corner[2] * s + n[2] * offset};
+            addVertex(tris, p, n, faceRGBA[f], rot);
         }
-    }
-
-    if (isRotating) {
-        glPushMatrix();
-        glTranslatef(faceCenterX, faceCenterY, faceCenterZ);
-        switch (rotationAxis) {
-            case 0: glRotatef(rotationAngle, 1.0f, 0.0f, 0.0f); break;
-            case 1: glRotatef(rotationAngle, 0.0f, 1.0f, 0.0f); break;
-            case 2: glRotatef(rotationAngle, 0.0f, 0.0f, 1.0f); break;
+    for (int e = 0; e < 12; e++)
+        for (int k = 0; k < 2; k++) {
+            const float* corner = EDGE_CORNER[e][k];
+            float p[3] = {c[0] + corner[0] * s, c[1] + corner[1] * s, c[2] + corner[2] * s};
+            addVertex(lines, p, FACE_NORMAL[5], lineRGBA, rot);
         }
-        glTranslatef(-faceCenterX, -faceCenterY, -faceCenterZ);
-        glTranslatef(x, y, z);
-    } else {
-        glPushMatrix();
-        glTranslatef(x, y, z);
-    }
-
-    auto safeColor = [&faces](int f, int r, int c) -> int {
-        if (f < 0 || f >= 6 || r < 0 || r > 2 || c < 0 || c > 2) return 0;
-        return faces[f][r][c];
-    };
-    int row = 1 - cy, col = 1 - cz;
-    drawFaceRubik(0, 0, 0, size, 0, safeColor(RIGHT, row, col));
-    row = 1 - cy; col = cz + 1;
-    drawFaceRubik(0, 0, 0, size, 1, safeColor(LEFT, row, col));
-    row = cz + 1; col = cx + 1;
-    drawFaceRubik(0, 0, 0, size, 2, safeColor(UP, row, col));
-    row = 1 - cz; col = cx + 1;
-    drawFaceRubik(0, 0, 0, size, 3, safeColor(DOWN, row, col));
-    row = 1 - cy; col = cx + 1;
-    drawFaceRubik(0, 0, 0, size, 4, safeColor(FRONT, row, col));
-    row = 1 - cy; col = 1 - cx;
-    drawFaceRubik(0, 0, 0, size, 5, safeColor(BACK, row, col));
-    drawCube(0, 0, 0, size);
-    glPopMatrix();
 }
 
-// Cube geometry from Rubik 1974 AD: 6 faces with offset, 12 edges
-void Renderer::drawFace(float x, float y, float z, float size, int faceIndex, int color) {
-    float s = size / 2.0f;
-    float offset = 0.01f;
-    GLfloat matSpecular[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    GLfloat matShininess[] = {128.0f};
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, matShininess);
-    glBegin(GL_QUADS);
-    setColor(color);
-    switch (faceIndex) {
-        case 0: // Right (+X)
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(x + s + offset, y - s, z - s);
-            glVertex3f(x + s + offset, y + s, z - s);
-            glVertex3f(x + s + offset, y + s, z + s);
-            glVertex3f(x + s + offset, y - s, z + s);
-            break;
-        case 1: // Left (-X)
-            glNormal3f(-1.0f, 0.0f, 0.0f);
-            glVertex3f(x - s - offset, y - s, z + s);
-            glVertex3f(x - s - offset, y + s, z + s);
-            glVertex3f(x - s - offset, y + s, z - s);
-            glVertex3f(x - s - offset, y - s, z - s);
-            break;
-        case 2: // Up (+Y)
-            glNormal3f(0.0f, 1.0f, 0.0f);
-            glVertex3f(x - s, y + s + offset, z - s);
-            glVertex3f(x + s, y + s + offset, z - s);
-            glVertex3f(x + s, y + s + offset, z + s);
-            glVertex3f(x - s, y + s + offset, z + s);
-            break;
-        case 3: // Down (-Y)
-            glNormal3f(0.0f, -1.0f, 0.0f);
-            glVertex3f(x - s, y - s - offset, z + s);
-            glVertex3f(x + s, y - s - offset, z + s);
-            glVertex3f(x + s, y - s - offset, z - s);
-            glVertex3f(x - s, y - s - offset, z - s);
-            break;
-        case 4: // Front (+Z)
-            glNormal3f(0.0f, 0.0f, 1.0f);
-            glVertex3f(x - s, y - s, z + s + offset);
-            glVertex3f(x - s, y + s, z + s + offset);
-            glVertex3f(x + s, y + s, z + s + offset);
-            glVertex3f(x + s, y - s, z + s + offset);
-            break;
-        case 5: // Back (-Z)
-            glNormal3f(0.0f, 0.0f, -1.0f);
-            glVertex3f(x + s, y - s, z - s - offset);
-            glVertex3f(x + s, y + s, z - s - offset);
-            glVertex3f(x - s, y + s, z - s - offset);
-            glVertex3f(x - s, y - s, z - s - offset);
-            break;
+// Turn of the inner cubie at (cx, cy, cz) during a face animation, as a row-major rotation
+// about the face axis (glRotatef convention); false when the cubie is not on the face
+static bool rubikCubieTurn(const RubikAnimState& anim, int cx, int cy, int cz, float rot[9]) {
+    if (!anim.isAnimating) return false;
+    int axis;
+    float angle;
+    switch (anim.face) {
+        case RIGHT: if (cx != 1) return false; axis = 0; angle = anim.currentAngle; break;
+        case LEFT: if (cx != -1) return false; axis = 0; angle = -anim.currentAngle; break;
+        case UP: if (cy != 1) return false; axis = 1; angle = anim.currentAngle; break;
+        case DOWN: if (cy != -1) return false; axis = 1; angle = -anim.currentAngle; break;
+        case FRONT: if (cz != 1) return false; axis = 2; angle = anim.currentAngle; break;
+        case BACK: if (cz != -1) return false; axis = 2; angle = -anim.currentAngle; break;
+        default: return false;
     }
-    glEnd();
+    float rad = angle * (float)(M_PI / 180.0);
+    float c = std::cos(rad), s = std::sin(rad);
+    int a = (axis + 1) % 3, b = (axis + 2) % 3;  // the plane turned, in right-hand order
+    for (int i = 0; i < 9; i++) rot[i] = (i % 4 == 0) ? 1.0f : 0.0f;
+    rot[a * 3 + a] = c;
+    rot[a * 3 + b] = -s;
+    rot[b * 3 + a] = s;
+    rot[b * 3 + b] = c;
+    return true;
 }
 
-void Renderer::drawFaceTranslucent(float x, float y, float z, float size, int faceIndex, int color, float alpha) {
-    float s = size / 2.0f;
-    float offset = 0.01f;
-    GLfloat matSpecular[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    GLfloat matShininess[] = {128.0f};
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, matShininess);
-    glBegin(GL_QUADS);
-    setColorTranslucent(color, alpha);
-    switch (faceIndex) {
-        case 0:
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(x + s + offset, y - s, z - s);
-            glVertex3f(x + s + offset, y + s, z - s);
-            glVertex3f(x + s + offset, y + s, z + s);
-            glVertex3f(x + s + offset, y - s, z + s);
-            break;
-        case 1:
-            glNormal3f(-1.0f, 0.0f, 0.0f);
-            glVertex3f(x - s - offset, y - s, z + s);
-            glVertex3f(x - s - offset, y + s, z + s);
-            glVertex3f(x - s - offset, y + s, z - s);
-            glVertex3f(x - s - offset, y - s, z - s);
-            break;
-        case 2:
-            glNormal3f(0.0f, 1.0f, 0.0f);
-            glVertex3f(x - s, y + s + offset, z - s);
-            glVertex3f(x + s, y + s + offset, z - s);
-            glVertex3f(x + s, y + s + offset, z + s);
-            glVertex3f(x - s, y + s + offset, z + s);
-            break;
-        case 3:
-            glNormal3f(0.0f, -1.0f, 0.0f);
-            glVertex3f(x - s, y - s - offset, z + s);
-            glVertex3f(x + s, y - s - offset, z + s);
-            glVertex3f(x + s, y - s - offset, z - s);
-            glVertex3f(x - s, y - s - offset, z - s);
-            break;
-        case 4:
-            glNormal3f(0.0f, 0.0f, 1.0f);
-            glVertex3f(x - s, y - s, z + s + offset);
-            glVertex3f(x - s, y + s, z + s + offset);
-            glVertex3f(x + s, y + s, z + s + offset);
-            glVertex3f(x + s, y - s, z + s + offset);
-            break;
-        case 5:
-            glNormal3f(0.0f, 0.0f, -1.0f);
-            glVertex3f(x + s, y - s, z - s - offset);
-            glVertex3f(x + s, y + s, z - s - offset);
-            glVertex3f(x - s, y + s, z - s - offset);
-            glVertex3f(x - s, y - s, z - s - offset);
-            break;
+// The 27 inner cubies at their projected centers. A turning cubie rotates about the face
+// axis through the origin, which also holds the face center it used to be turned about.
+void Renderer::addInnerCube(const RubikCube& cube, const RubikAnimState& anim, float cubieSize) {
+    const auto& faces = cube.getFaces();
+    auto color = [&faces](int f, int r, int c) -> const float* {
+        if (r < 0 || r > 2 || c < 0 || c > 2) return RUBIK_RGB[6];
+        int v = faces[f][r][c];
+        return RUBIK_RGB[v >= 0 && v < 6 ? v : 6];
+    };
+    static const float LINE_RGBA[4] = {0.1f, 0.1f, 0.1f, 1.0f};
+    for (int k = 0; k < FRAME_VERTICES - OUTER_VERTICES; k++) {
+        int i = OUTER_VERTICES + k;
+        if (!std::isfinite(frameX_[i]) || !std::isfinite(frameY_[i]) || !std::isfinite(frameZ_[i])) continue;
+        int cx = k / 9 - 1, cy = k / 3 % 3 - 1, cz = k % 3 - 1;
+        float faceRGBA[6][4];
+        setRGBA(faceRGBA[0], color(RIGHT, 1 - cy, 1 - cz), 1.0f);
+        setRGBA(faceRGBA[1], color(LEFT, 1 - cy, cz + 1), 1.0f);
+        setRGBA(faceRGBA[2], color(UP, cz + 1, cx + 1), 1.0f);
+        setRGBA(faceRGBA[3], color(DOWN, 1 - cz, cx + 1), 1.0f);
+        setRGBA(faceRGBA[4], color(FRONT, 1 - cy, cx + 1), 1.0f);
+        setRGBA(faceRGBA[5], color(BACK, 1 - cy, 1 - cx), 1.0f);
+        float rot[9];
+        bool turning = rubikCubieTurn(anim, cx, cy, cz, rot);
+        float center[3] = {frameX_[i], frameY_[i], frameZ_[i]};
+        addCubie(triangles_, lines_, center, cubieSize, faceRGBA, LINE_RGBA, turning ? rot : nullptr);
     }
-    glEnd();
-}
-
-void Renderer::drawCube(float x, float y, float z, float size) {
-    float s = size / 2.0f;
-    glColor3f(0.1f, 0.1f, 0.1f);
-    glLineWidth(2.0f);
-    glBegin(GL_LINES);
-    glVertex3f(x - s, y - s, z - s); glVertex3f(x + s, y - s, z - s);
-    glVertex3f(x + s, y - s, z - s); glVertex3f(x + s, y - s, z + s);
-    glVertex3f(x + s, y - s, z + s); glVertex3f(x - s, y - s, z + s);
-    glVertex3f(x - s, y - s, z + s); glVertex3f(x - s, y - s, z - s);
-    glVertex3f(x - s, y + s, z - s); glVertex3f(x + s, y + s, z - s);
-    glVertex3f(x + s, y + s, z - s); glVertex3f(x + s, y + s, z + s);
-    glVertex3f(x + s, y + s, z + s); glVertex3f(x - s, y + s, z + s);
-    glVertex3f(x - s, y + s, z + s); glVertex3f(x - s, y + s, z - s);
-    glVertex3f(x - s, y - s, z - s); glVertex3f(x - s, y + s, z - s);
-    glVertex3f(x + s, y - s, z - s); glVertex3f(x + s, y + s, z - s);
-    glVertex3f(x + s, y - s, z + s); glVertex3f(x + s, y + s, z + s);
-    glVertex3f(x - s, y - s, z + s); glVertex3f(x - s, y + s, z + s);
-    glEnd();
-}
-
-void Renderer::drawCubeTranslucent(float x, float y, float z, float size, float alpha) {
-    float s = size / 2.0f;
-    glColor4f(0.1f, 0.1f, 0.1f, alpha);
-    glLineWidth(2.0f);
-    glBegin(GL_LINES);
-    glVertex3f(x - s, y - s, z - s); glVertex3f(x + s, y - s, z - s);
-    glVertex3f(x + s, y - s, z - s); glVertex3f(x + s, y - s, z + s);
-    glVertex3f(x + s, y - s, z + s); glVertex3f(x - s, y - s, z + s);
-    glVertex3f(x - s, y - s, z + s); glVertex3f(x - s, y - s, z - s);
-    glVertex3f(x - s, y + s, z - s); glVertex3f(x + s, y + s, z - s);
-    glVertex3f(x + s, y + s, z - s); glVertex3f(x + s, y + s, z + s);
-    glVertex3f(x + s, y + s, z + s); glVertex3f(x - s, y + s, z + s);
-    glVertex3f(x - s, y + s, z + s); glVertex3f(x - s, y + s, z - s);
-    glVertex3f(x - s, y - s, z - s); glVertex3f(x - s, y + s, z - s);
-    glVertex3f(x + s, y - s, z - s); glVertex3f(x + s, y + s, z - s);
-    glVertex3f(x + s, y - s, z + s); glVertex3f(x + s, y + s, z + s);
-    glVertex3f(x - s, y - s, z + s); glVertex3f(x - s, y + s, z + s);
-    glEnd();
 }
 
 Mat4x4 Renderer::getViewRotation4D() const {
     // Combine XY and ZW rotations for 4D viewing
-    Mat4x4 r1 = rotate4D(PLANE_XY, cameraAngleY * 0.5f);
-    Mat4x4 r2 = rotate4D(PLANE_ZW, viewAngleW_);
-    return matMul(r2, r1);
+    Rotor4 r1 = Rotor4::plane(PLANE_XY, cameraAngleY * 0.5f);
+    Rotor4 r2 = Rotor4::plane(PLANE_ZW, viewAngleW_);
+    return compose(r2, r1).toMatrix();
 }
 
 Mat4x4 Renderer::getAnimationRotation(const AnimationState& anim) const {
-    if (!anim.isAnimating || anim.plane < 0) return Mat4x4::identity();
-    return rotate4D(anim.plane, anim.currentAngle);
+    if (!anim.isAnimating || anim.plane < 0 || anim.plane > 5) return Mat4x4::identity();
+    // Quarter turns per plane and direction, built once
+    static const struct QuarterTurns {
+        Rotor4 r[6][2];
+        QuarterTurns() {
+            for (int p = 0; p < 6; p++) {
+                r[p][0] = Rotor4::plane(p, 90.0f);
+                r[p][1] = Rotor4::plane(p, -90.0f);
+            }
+        }
+    } turns;
+    return quarterTurnProgress(turns.r[anim.plane][anim.targetAngle < 0.0f], anim.currentAngle);
 }
 
-void Renderer::drawEdge(const Vec4& a, const Vec4& b, const Mat4x4& viewRot, float wDist) {
-    Vec4 pa = project4Dto3D(matMul(viewRot, a), wDist);
-    Vec4 pb = project4Dto3D(matMul(viewRot, b), wDist);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glColor4f(0.4f, 0.4f, 0.5f, 0.5f);
-    glLineWidth(2.0f);
-    glBegin(GL_LINES);
-    glVertex3f(pa.x, pa.y, pa.z);
-    glVertex3f(pb.x, pb.y, pb.z);
-    glEnd();
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
+// Fuse view x slice animation x face animation into one matrix per vertex group, composed
+// once per frame, then transform and project every vertex exactly once
+void Renderer::buildFrameVertices(const AnimationState& anim, const RubikAnimState& rubikAnim, float innerSpacing) {
+    Mat4x4 viewRot = getViewRotation4D();
+    bool sliceTurning = anim.isAnimating && anim.plane >= 0;
+    bool rubikTurning = rubikAnim.isAnimating && rubikAnim.face >= 0;
+    // Group bit 0: in the animated 4D slice, bit 1: on the turning Rubik face
+    Mat4x4 group[4];
+    Mat4x4 animRot = sliceTurning ? getAnimationRotation(anim) : Mat4x4::identity();
+    group[0] = viewRot;
+    group[1] = matMul(viewRot, animRot);
+    if (rubikTurning) {
+        Mat4x4 rubikRot = quarterTurnProgress(rubikFaceRotor(rubikAnim.face, rubikAnim.clockwise), rubikAnim.currentAngle);
+        group[2] = matMul(viewRot, rubikRot);
+        group[3] = matMul(group[2], animRot);
+    }
+
+    Vec4 transformed[OUTER_VERTICES];
+    for (int ix = 0; ix < 2; ix++)
+        for (int iy = 0; iy < 2; iy++)
+            for (int iz = 0; iz < 2; iz++)
+                for (int iw = 0; iw < 2; iw++) {
+                    int idx = vindex(ix, iy, iz, iw);
+                    int g = (sliceTurning && TesseractPuzzle::isVertexInSlice(idx, anim.plane, anim.layer)) |
+                            (rubikTurning && inRubikFace(rubikAnim.face, ix, iy, iz)) << 1;
+                    transformed[idx] = matMul(group[g], outerPositions_[idx]);
+                }
+    for (int i = 0; i < OUTER_VERTICES; i++) {
+        frameX_[i] = transformed[i].x;
+        frameY_[i] = transformed[i].y;
+        frameZ_[i] = transformed[i].z;
+        frameW_[i] = transformed[i].w;
+    }
+
+    // Inner cubie centers sit at w = 0 and only follow the view rotation
+    const int inner = FRAME_VERTICES - OUTER_VERTICES;
+    for (int k = 0; k < inner; k++) {
+        frameX_[OUTER_VERTICES + k] = (k / 9 - 1) * innerSpacing;
+        frameY_[OUTER_VERTICES + k] = (k / 3 % 3 - 1) * innerSpacing;
+        frameZ_[OUTER_VERTICES + k] = (k % 3 - 1) * innerSpacing;
+        frameW_[OUTER_VERTICES + k] = 0.0f;
+    }
+    Vec4SoA innerPoints = {frameX_ + OUTER_VERTICES, frameY_ + OUTER_VERTICES, frameZ_ + OUTER_VERTICES,
+                           frameW_ + OUTER_VERTICES};
+    transformPoints(viewRot, innerPoints, innerPoints, inner);
+
+    Vec4SoA all = {frameX_, frameY_, frameZ_, frameW_};
+    projectPoints(all, all, FRAME_VERTICES, wDistance_);
+}
+
+// All 32 outer edges, endpoints read from the frame buffer
+void Renderer::addEdges() {
+    static const float RGBA[4] = {0.4f, 0.4f, 0.5f, 0.5f};
+    for (int i = 0; i < 32; i++)
+        for (int k = 0; k < 2; k++) {
+            int v = EDGES[i][k];
+            float p[3] = {frameX_[v], frameY_[v], frameZ_[v]};
+            addVertex(lines_, p, FACE_NORMAL[5], RGBA, nullptr);
+        }
 }
 
-void Renderer::drawVertex(const Vec4& pos, const Vertex4D& v, const Mat4x4& viewRot, float wDist) {
-    Vec4 p = project4Dto3D(matMul(viewRot, pos), wDist);
-    float size = 0.38f;  // Rubik-style cubie (chunkier, like inner cube)
+// The 16 translucent outer cubies: sticker colors on +X, +Y, +Z, -Z (slots 0..3), grey
+// on -X and -Y
+void Renderer::addOuterCubies(const TesseractPuzzle& puzzle) {
+    const float size = 0.38f;   // Rubik-style cubie (chunkier, like inner cube)
     const float alpha = 0.35f;  // Translucent outer cube
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glPushMatrix();
-    glTranslatef(p.x, p.y, p.z);
-    drawFaceTranslucent(0, 0, 0, size, 0, v.colors[0], alpha);
-    drawFaceTranslucent(0, 0, 0, size, 1, 8, alpha);
-    drawFaceTranslucent(0, 0, 0, size, 2, v.colors[1], alpha);
-    drawFaceTranslucent(0, 0, 0, size, 3, 8, alpha);
-    drawFaceTranslucent(0, 0, 0, size, 4, v.colors[2], alpha);
-    drawFaceTranslucent(0, 0, 0, size, 5, v.colors[3], alpha);
-    drawCubeTranslucent(0, 0, 0, size, alpha);
-    glPopMatrix();
-    glDisable(GL_BLEND);
+    static const int GREY = 8;
+    const float lineRGBA[4] = {0.1f, 0.1f, 0.1f, alpha};
+    for (int i = 0; i < OUTER_VERTICES; i++) {
+        Vertex4D v = puzzle.getVertex(i / 8, (i / 4) % 2, (i / 2) % 2, i % 2);
+        const int colors[6] = {v.colors[0], GREY, v.colors[1], GREY, v.colors[2], v.colors[3]};
+        float faceRGBA[6][4];
+        for (int f = 0; f < 6; f++)
+            setRGBA(faceRGBA[f], CELL_RGB[colors[f] >= 0 && colors[f] < 8 ? colors[f] : GREY], alpha);
+        float center[3] = {frameX_[i], frameY_[i], frameZ_[i]};
+        addCubie(triangles_, lines_, center, size, faceRGBA, lineRGBA, nullptr);
+    }
 }
 
 void Renderer::render(const TesseractPuzzle& puzzle, const RubikCube* innerCube, int windowWidth, int windowHeight,
@@ -558,52 +422,44 @@ void Renderer::render(const TesseractPuzzle& puzzle, const RubikCube* innerCube,
 
     drawStars();
 
-    Mat4x4 viewRot = getViewRotation4D();
-    Mat4x4 animRot = getAnimationRotation(anim);
+    float innerScale = 0.6f;
+    buildFrameVertices(anim, rubikAnim, 1.0f * innerScale);
+
+    // Every cubie face and outline of the frame goes into two vertex batches, uploaded once
+    // and drawn in state-sorted ranges: inner faces and outlines, edges, outer faces and outlines
+    triangles_.clear();
+    lines_.clear();
+    if (innerCube) addInnerCube(*innerCube, rubikAnim, 0.95f * innerScale);
+    size_t innerTriangles = triangles_.size(), innerLines = lines_.size();
+    addEdges();
+    size_t edgesEnd = lines_.size();
+    addOuterCubies(puzzle);
+    triangles_.upload(true);
+    lines_.upload(true);
+
+    GLfloat matSpecular[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    GLfloat matShininess[] = {128.0f};
+    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
+    glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, matShininess);
+    glLineWidth(2.0f);
 
     // Inner cube drawn first (before blending/translucent outer) to avoid GL state conflicts
-    if (innerCube) {
+    if (innerTriangles > 0) {
         glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT);
         glDisable(GL_BLEND);
-        glMatrixMode(GL_MODELVIEW);
-        float innerScale = 0.6f;
-        float cubieSize = 0.95f * innerScale;
-        float spacing = 1.0f * innerScale;
-        for (int x = -1; x <= 1; x++) {
-            for (int y = -1; y <= 1; y++) {
-                for (int z = -1; z <= 1; z++) {
-                    Vec4 pos4(x * spacing, y * spacing, z * spacing, 0.0f);
-                    Vec4 proj = project4Dto3D(matMul(viewRot, pos4), wDistance_);
-                    if (std::isfinite(proj.x) && std::isfinite(proj.y) && std::isfinite(proj.z))
-                        drawCubieRubik(proj.x, proj.y, proj.z, cubieSize, *innerCube, x, y, z, rubikAnim);
-                }
-            }
-        }
+        triangles_.draw(GL_TRIANGLES, 0, innerTriangles);
+        lines_.draw(GL_LINES, 0, innerLines);
         glPopAttrib();
     }
 
-    Vec4 positions[16];
-    for (int ix = 0; ix < 2; ix++)
-        for (int iy = 0; iy < 2; iy++)
-            for (int iz = 0; iz < 2; iz++)
-                for (int iw = 0; iw < 2; iw++) {
-                    int idx = vindex(ix, iy, iz, iw);
-                    Vec4 p = outerPositions_[idx];
-                    bool inSlice = anim.isAnimating && TesseractPuzzle::isVertexInSlice(idx, anim.plane, anim.layer);
-                    p = inSlice ? matMul(animRot, p) : p;
-                    p = applyRubikAnimToVertex(p, ix, iy, iz, iw, rubikAnim);
-                    positions[idx] = p;
-                }
-
-    for (int i = 0; i < 32; i++) {
-        int a = EDGES[i][0], b = EDGES[i][1];
-        drawEdge(positions[a], positions[b], viewRot, wDistance_);
-    }
-
-    for (int i = 0; i < 16; i++) {
-        const Vertex4D& vert = puzzle.getVertex(i/8, (i/4)%2, (i/2)%2, i%2);
-        drawVertex(positions[i], vert, viewRot, wDistance_);
-    }
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_LIGHTING);
+    lines_.draw(GL_LINES, innerLines, edgesEnd - innerLines);
+    glEnable(GL_LIGHTING);
+    triangles_.draw(GL_TRIANGLES, innerTriangles);
+    lines_.draw(GL_LINES, edgesEnd);
+    glDisable(GL_BLEND);
 }
 
 void Renderer::handleMouseDrag(int deltaX, int deltaY) {
@@ -629,25 +485,14 @@ void Renderer::resetCamera() {
 }
 
 void Renderer::commitOuterRubikRotation(int face, bool clockwise) {
-    Mat4x4 rot = rubikFaceRotation(face, clockwise);
+    Mat4x4 rot = rubikFaceRotor(face, clockwise).toMatrix();
     for (int ix = 0; ix < 2; ix++)
         for (int iy = 0; iy < 2; iy++)
             for (int iz = 0; iz < 2; iz++)
                 for (int iw = 0; iw < 2; iw++) {
-                    bool inSlice = false;
-                    switch (face) {
-                        case 0: inSlice = (ix == 1); break;
-                        case 1: inSlice = (ix == 0); break;
-                        case 2: inSlice = (iy == 1); break;
-                        case 3: inSlice = (iy == 0); break;
-                        case 4: inSlice = (iz == 1); break;
-                        case 5: inSlice = (iz == 0); break;
-                        default: break;
-                    }
-                    if (inSlice) {
-                        int idx = vindex(ix, iy, iz, iw);
-                        outerPositions_[idx] = matMul(rot, outerPositions_[idx]);
-                    }
+                    if (!inRubikFace(face, ix, iy, iz)) continue;
+                    int idx = vindex(ix, iy, iz, iw);
+                    outerPositions_[idx] = matMul(rot, outerPositions_[idx]);
                 }
 }
 
@@ -660,3 +505,11 @@ void Renderer::resetOuterPositions() {
                     getVertexPos(ix, iy, iz, iw, outerPositions_[idx]);
                 }
 }
+
+void Renderer::getOuterPositions(Vec4 out[16]) const {
+    for (int i = 0; i < 16; i++) out[i] = outerPositions_[i];
+}
+
+void Renderer::setOuterPositions(const Vec4 in[16]) {
+    for (int i = 0; i < 16; i++) outerPositions_[i] = in[i];
+}
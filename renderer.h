@@ -9,6 +9,7 @@
 #include "tesseract_model.h"
 #include "rubik_cube.h"
 #include "math_4d.h"
+#include "vertex_batch.h"
 #include <vector>
 
 // Animation state for inner 3x3x3 Rubik cube
@@ -43,18 +44,23 @@ private:
     float wDistance_;    // 4D projection distance
     Vec4 outerPositions_[16];  // Outer vertex positions (updated by inner cube moves)
 
-    void setColor(int cellColor);
-    void setColorTranslucent(int cellColor, float alpha);
+    // Per-frame vertex stage: the 16 outer vertices, then the 27 inner cubie centers, each
+    // transformed and projected once into these SoA arrays; edges and cubies index into them
+    static const int OUTER_VERTICES = 16;
+    static const int FRAME_VERTICES = OUTER_VERTICES + 27;
+    float frameX_[FRAME_VERTICES], frameY_[FRAME_VERTICES], frameZ_[FRAME_VERTICES], frameW_[FRAME_VERTICES];
+
+    // Geometry batches: stars are built once, cubies and edges every frame
+    VertexBatch stars_;
+    VertexBatch triangles_;
+    VertexBatch lines_;
+
+    void buildStars();
     void drawStars();
-    void setColorRubik(int faceColor);
-    void drawFace(float x, float y, float z, float size, int faceIndex, int color);
-    void drawFaceTranslucent(float x, float y, float z, float size, int faceIndex, int color, float alpha);
-    void drawFaceRubik(float x, float y, float z, float size, int faceIndex, int faceColor);
-    void drawCube(float x, float y, float z, float size);
-    void drawCubeTranslucent(float x, float y, float z, float size, float alpha);
-    void drawCubieRubik(float x, float y, float z, float size, const RubikCube& cube, int cx, int cy, int cz, const RubikAnimState& anim);
-    void drawEdge(const Vec4& a, const Vec4& b, const Mat4x4& viewRot, float wDist);
-    void drawVertex(const Vec4& pos, const Vertex4D& v, const Mat4x4& viewRot, float wDist);
+    void addInnerCube(const RubikCube& cube, const RubikAnimState& anim, float cubieSize);
+    void addEdges();
+    void addOuterCubies(const TesseractPuzzle& puzzle);
+    void buildFrameVertices(const AnimationState& anim, const RubikAnimState& rubikAnim, float innerSpacing);
     Mat4x4 getViewRotation4D() const;
     Mat4x4 getAnimationRotation(const AnimationState& anim) const;
 
@@ -70,6 +76,9 @@ public:
     void resetCamera();
     void commitOuterRubikRotation(int face, bool clockwise);  // Call when inner cube move completes
     void resetOuterPositions();
+    // Copy of the 16 outer vertex positions, e.g. to restore them with a journal checkpoint
+    void getOuterPositions(Vec4 out[16]) const;
+    void setOuterPositions(const Vec4 in[16]);
 };
 
 #endif // RENDERER_H
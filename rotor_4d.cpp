@@ -0,0 +1,128 @@
+// 4D Rotors Implementation
+
+#include "rotor_4d.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846f
+#endif
+
+Quat quatMul(const Quat& a, const Quat& b) {
+    return Quat(a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+                a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w);
+}
+
+static float quatDot(const Quat& a, const Quat& b) {
+    return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static Quat quatScale(const Quat& q, float s) {
+    return Quat(q.w * s, q.x * s, q.y * s, q.z * s);
+}
+
+static Quat quatNormalized(const Quat& q) {
+    float n = std::sqrt(quatDot(q, q));
+    return n > 0.0f ? quatScale(q, 1.0f / n) : Quat();
+}
+
+// Slerp weights for unit quaternions with dot product d; nlerp weights where the sine
+// ratio loses precision (ends nearly equal, or nearly opposite with no preferred arc)
+static void slerpWeights(float d, float t, float& wa, float& wb) {
+    float theta = std::acos(d < -1.0f ? -1.0f : (d > 1.0f ? 1.0f : d));
+    float s = std::sin(theta);
+    if (d > 0.9995f || s < 1e-4f) {
+        wa = 1.0f - t;
+        wb = t;
+        return;
+    }
+    wa = std::sin((1.0f - t) * theta) / s;
+    wb = std::sin(t * theta) / s;
+}
+
+static Quat quatBlend(const Quat& a, const Quat& b, float wa, float wb) {
+    return Quat(a.w * wa + b.w * wb, a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb);
+}
+
+Rotor4 Rotor4::plane(int plane, float angleDeg) {
+    // Per plane: the imaginary unit (1 = i, 2 = j, 3 = k) spanning it with 1 and the signs
+    // of its half-angle component in left and right; fixed by matching rotate4D
+    static const int table[6][3] = {
+        {3, -1, 1},  // XY
+        {2, 1, -1},  // XZ
+        {1, 1, 1},   // XW
+        {1, -1, 1},  // YZ
+        {2, 1, 1},   // YW
+        {3, 1, 1},   // ZW
+    };
+    Rotor4 r;
+    if (plane < 0 || plane > 5) return r;
+    float half = angleDeg * (float)(M_PI / 360.0);
+    float c = std::cos(half), s = std::sin(half);
+    float* left[4] = {&r.left.w, &r.left.x, &r.left.y, &r.left.z};
+    float* right[4] = {&r.right.w, &r.right.x, &r.right.y, &r.right.z};
+    *left[0] = *right[0] = c;
+    *left[table[plane][0]] = s * table[plane][1];
+    *right[table[plane][0]] = s * table[plane][2];
+    return r;
+}
+
+Vec4 Rotor4::apply(const Vec4& v) const {
+    Quat p = quatMul(quatMul(left, Quat(v.w, v.x, v.y, v.z)), right);
+    return Vec4(p.x, p.y, p.z, p.w);
+}
+
+// Product of the left- and right-multiplication matrices, in (w, x, y, z) order
+Mat4x4 Rotor4::toMatrix() const {
+    const Quat& a = left;
+    const Quat& b = right;
+    const float L[4][4] = {{a.w, -a.x, -a.y, -a.z}, {a.x, a.w, -a.z, a.y}, {a.y, a.z, a.w, -a.x}, {a.z, -a.y, a.x, a.w}};
+    const float R[4][4] = {{b.w, -b.x, -b.y, -b.z}, {b.x, b.w, b.z, -b.y}, {b.y, -b.z, b.w, b.x}, {b.z, b.y, -b.x, b.w}};
+    static const int axis[4] = {3, 0, 1, 2};  // w, x, y, z -> Vec4 component
+    Mat4x4 m;
+    for (int row = 0; row < 4; row++)
+        for (int col = 0; col < 4; col++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) sum += L[row][k] * R[k][col];
+            m.m[axis[col] * 4 + axis[row]] = sum;
+        }
+    return m;
+}
+
+Rotor4 Rotor4::inverse() const {
+    Rotor4 r;
+    r.left = Quat(left.w, -left.x, -left.y, -left.z);
+    r.right = Quat(right.w, -right.x, -right.y, -right.z);
+    return r;
+}
+
+void Rotor4::normalize() {
+    left = quatNormalized(left);
+    right = quatNormalized(right);
+}
+
+// a(b(p)) = a.left * b.left * p * b.right * a.right
+Rotor4 compose(const Rotor4& a, const Rotor4& b) {
+    Rotor4 r;
+    r.left = quatMul(a.left, b.left);
+    r.right = quatMul(b.right, a.right);
+    return r;
+}
+
+Rotor4 slerp(const Rotor4& a, const Rotor4& b, float t) {
+    // (left, right) and (-left, -right) are one rotation: flip both to stay on the short arc
+    float dl = quatDot(a.left, b.left), dr = quatDot(a.right, b.right);
+    float sign = dl < 0.0f ? -1.0f : 1.0f;
+    dl *= sign;
+    dr *= sign;
+    float wa, wb;
+    slerpWeights(dl, t, wa, wb);
+    Rotor4 r;
+    r.left = quatBlend(a.left, b.left, wa, wb * sign);
+    // The halves of a simple (single-plane) rotation turn by the same angle: reuse the weights
+    if (std::fabs(dr - dl) > 1e-6f) slerpWeights(dr, t, wa, wb);
+    r.right = quatBlend(a.right, b.right, wa, wb * sign);
+    r.normalize();  // exact for slerp, needed after an nlerp
+    return r;
+}
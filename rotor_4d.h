@@ -0,0 +1,42 @@
+// 4D Rotors
+// Rotations of R^4 as a pair of unit quaternions: compose, renormalize and slerp without matrices
+
+#ifndef ROTOR_4D_H
+#define ROTOR_4D_H
+
+#include "math_4d.h"
+
+struct Quat {
+    float w, x, y, z;
+    Quat() : w(1), x(0), y(0), z(0) {}
+    Quat(float w_, float x_, float y_, float z_) : w(w_), x(x_), y(y_), z(z_) {}
+};
+
+Quat quatMul(const Quat& a, const Quat& b);
+
+// With a point read as the quaternion p = w + x i + y j + z k, every rotation of R^4 is
+// p -> left * p * right for unit quaternions left and right (left / right isoclinic parts);
+// (-left, -right) is the same rotation. A plane rotation needs one sincos of half its angle.
+struct Rotor4 {
+    Quat left, right;
+
+    static Rotor4 identity() { return Rotor4(); }
+    // Same rotation as rotate4D(plane, angleDeg)
+    static Rotor4 plane(int plane, float angleDeg);
+
+    Vec4 apply(const Vec4& v) const;
+    // Column-major matrix of the rotation, for transforming many points
+    Mat4x4 toMatrix() const;
+    Rotor4 inverse() const;
+    // Rescale both quaternions to unit length; call after long chains of compose()
+    void normalize();
+};
+
+// a * b: apply b, then a (the matMul order)
+Rotor4 compose(const Rotor4& a, const Rotor4& b);
+
+// Rotation from a (t = 0) to b (t = 1), each half turning at constant speed; the sign of b
+// is chosen so the left half takes its short arc
+Rotor4 slerp(const Rotor4& a, const Rotor4& b, float t);
+
+#endif // ROTOR_4D_H
@@ -1,149 +1,195 @@
 // Rubik's Cube Implementation - 3x3x3 inner cube
 
 #include "rubik_cube.h"
-#include <algorithm>
-#include <random>
-#include <ctime>
+#include "zobrist.h"
+#include "philox.h"
+#include <cstring>
+
+static const uint8_t SOLVED_COLORS[6] = {RED, ORANGE, WHITE, YELLOW, GREEN, BLUE};
 
 RubikCube::RubikCube() {
-    faces.resize(6);
-    int faceColors[] = {RED, ORANGE, WHITE, YELLOW, GREEN, BLUE};
-    for (int i = 0; i < 6; i++) {
-        faces[i].resize(3);
-        for (int j = 0; j < 3; j++)
-            faces[i][j].resize(3, faceColors[i]);
-    }
+    reset();
 }
 
 void RubikCube::reset() {
-    int faceColors[] = {RED, ORANGE, WHITE, YELLOW, GREEN, BLUE};
-    for (int i = 0; i < 6; i++)
-        for (int j = 0; j < 3; j++)
-            for (int k = 0; k < 3; k++)
-                faces[i][j][k] = faceColors[i];
-}
-
-void RubikCube::rotateFaceClockwise(int face) {
-    std::vector<std::vector<int>> temp(3, std::vector<int>(3));
-    for (int i = 0; i < 3; i++)
-        for (int j = 0; j < 3; j++)
-            temp[j][2 - i] = faces[face][i][j];
-    faces[face] = temp;
-}
-
-void RubikCube::rotateFaceCounterClockwise(int face) {
-    std::vector<std::vector<int>> temp(3, std::vector<int>(3));
-    for (int i = 0; i < 3; i++)
-        for (int j = 0; j < 3; j++)
-            temp[2 - j][i] = faces[face][i][j];
-    faces[face] = temp;
-}
-
-void RubikCube::rotateR() {
-    rotateFaceClockwise(RIGHT);
-    int temp[3];
-    for (int i = 0; i < 3; i++) temp[i] = faces[UP][i][2];
-    for (int i = 0; i < 3; i++) faces[UP][i][2] = faces[FRONT][i][2];
-    for (int i = 0; i < 3; i++) faces[FRONT][i][2] = faces[DOWN][i][2];
-    for (int i = 0; i < 3; i++) faces[DOWN][i][2] = faces[BACK][2 - i][0];
-    for (int i = 0; i < 3; i++) faces[BACK][2 - i][0] = temp[i];
-}
-
-void RubikCube::rotateL() {
-    rotateFaceClockwise(LEFT);
-    int temp[3];
-    for (int i = 0; i < 3; i++) temp[i] = faces[UP][i][0];
-    for (int i = 0; i < 3; i++) faces[UP][i][0] = faces[BACK][2 - i][2];
-    for (int i = 0; i < 3; i++) faces[BACK][2 - i][2] = faces[DOWN][i][0];
-    for (int i = 0; i < 3; i++) faces[DOWN][i][0] = faces[FRONT][i][0];
-    for (int i = 0; i < 3; i++) faces[FRONT][i][0] = temp[i];
-}
-
-void RubikCube::rotateU() {
-    rotateFaceClockwise(UP);
-    int temp[3];
-    for (int i = 0; i < 3; i++) temp[i] = faces[FRONT][0][i];
-    for (int i = 0; i < 3; i++) faces[FRONT][0][i] = faces[RIGHT][0][i];
-    for (int i = 0; i < 3; i++) faces[RIGHT][0][i] = faces[BACK][0][i];
-    for (int i = 0; i < 3; i++) faces[BACK][0][i] = faces[LEFT][0][i];
-    for (int i = 0; i < 3; i++) faces[LEFT][0][i] = temp[i];
-}
-
-void RubikCube::rotateD() {
-    rotateFaceClockwise(DOWN);
-    int temp[3];
-    for (int i = 0; i < 3; i++) temp[i] = faces[FRONT][2][i];
-    for (int i = 0; i < 3; i++) faces[FRONT][2][i] = faces[LEFT][2][i];
-    for (int i = 0; i < 3; i++) faces[LEFT][2][i] = faces[BACK][2][i];
-    for (int i = 0; i < 3; i++) faces[BACK][2][i] = faces[RIGHT][2][i];
-    for (int i = 0; i < 3; i++) faces[RIGHT][2][i] = temp[i];
-}
-
-void RubikCube::rotateF() {
-    rotateFaceClockwise(FRONT);
-    int temp[3];
-    for (int i = 0; i < 3; i++) temp[i] = faces[UP][2][i];
-    for (int i = 0; i < 3; i++) faces[UP][2][i] = faces[LEFT][2 - i][2];
-    for (int i = 0; i < 3; i++) faces[LEFT][2 - i][2] = faces[DOWN][0][2 - i];
-    for (int i = 0; i < 3; i++) faces[DOWN][0][2 - i] = faces[RIGHT][i][0];
-    for (int i = 0; i < 3; i++) faces[RIGHT][i][0] = temp[i];
-}
-
-void RubikCube::rotateB() {
-    rotateFaceClockwise(BACK);
-    int temp[3];
-    for (int i = 0; i < 3; i++) temp[i] = faces[UP][0][i];
-    for (int i = 0; i < 3; i++) faces[UP][0][i] = faces[RIGHT][i][2];
-    for (int i = 0; i < 3; i++) faces[RIGHT][i][2] = faces[DOWN][2][2 - i];
-    for (int i = 0; i < 3; i++) faces[DOWN][2][2 - i] = faces[LEFT][2 - i][0];
-    for (int i = 0; i < 3; i++) faces[LEFT][2 - i][0] = temp[i];
-}
-
-void RubikCube::rotateRPrime() { rotateR(); rotateR(); rotateR(); }
-void RubikCube::rotateLPrime() { rotateL(); rotateL(); rotateL(); }
-void RubikCube::rotateUPrime() { rotateU(); rotateU(); rotateU(); }
-void RubikCube::rotateDPrime() { rotateD(); rotateD(); rotateD(); }
-void RubikCube::rotateFPrime() { rotateF(); rotateF(); rotateF(); }
-void RubikCube::rotateBPrime() { rotateB(); rotateB(); rotateB(); }
+    for (int f = 0; f < RUBIK_FACELETS; f++) facelets_[f] = SOLVED_COLORS[f / 9];
+    hash_ = computeHash();
+}
+
+// keys[facelet][color], fixed seed so hashes are reproducible across runs
+static const uint64_t (&zobristTable())[RUBIK_FACELETS][6] {
+    struct Table {
+        uint64_t keys[RUBIK_FACELETS][6];
+        Table() {
+            uint64_t seed = 0x3C0BE5ull;
+            for (int f = 0; f < RUBIK_FACELETS; f++)
+                for (int c = 0; c < 6; c++) keys[f][c] = splitMix64(seed);
+        }
+    };
+    static const Table table;
+    return table.keys;
+}
+
+uint64_t RubikCube::zobristKey(int facelet, int color) {
+    return zobristTable()[facelet][color];
+}
+
+uint64_t RubikCube::computeHash() const {
+    const uint64_t (&keys)[RUBIK_FACELETS][6] = zobristTable();
+    uint64_t h = 0;
+    for (int f = 0; f < RUBIK_FACELETS; f++) h ^= keys[f][facelets_[f]];
+    return h;
+}
+
+// Gather tables for the 18 opcodes, built from the cubie geometry: a clockwise turn
+// (looking at the face) carries the facelet at cubie position p with normal n to
+// position R p with normal R n, where R is -90 degrees about the face's outward axis.
+// moved[] lists the 20 facelets a turn of that face changes (centers never move).
+struct RubikMoveTables {
+    uint8_t src[RUBIK_OP_COUNT][RUBIK_FACELETS];
+    uint8_t moved[6][20];
+
+    RubikMoveTables() {
+        // (position, normal) -> facelet; coordinates offset by 1 into 0..2
+        int pos[RUBIK_FACELETS][3], normal[RUBIK_FACELETS][3];
+        int lookup[3][3][3][6];
+        for (int f = 0; f < RUBIK_FACELETS; f++) {
+            RubikCube::faceletCubie(f, pos[f][0], pos[f][1], pos[f][2]);
+            int face = f / 9;
+            for (int k = 0; k < 3; k++) normal[f][k] = (k == face / 2) ? (face % 2 == 0 ? 1 : -1) : 0;
+            lookup[pos[f][0] + 1][pos[f][1] + 1][pos[f][2] + 1][face] = f;
+        }
+        for (int face = 0; face < 6; face++) {
+            int axis = face / 2, sign = face % 2 == 0 ? 1 : -1;
+            // forward[f] = where facelet f goes under the clockwise quarter turn
+            uint8_t forward[RUBIK_FACELETS];
+            int n = 0;
+            for (int f = 0; f < RUBIK_FACELETS; f++) {
+                forward[f] = static_cast<uint8_t>(f);
+                if (pos[f][axis] != sign) continue;
+                int p[3], q[3];
+                rotate(pos[f], axis, sign, p);
+                rotate(normal[f], axis, sign, q);
+                int qface = 0;
+                while (!(q[qface / 2] == (qface % 2 == 0 ? 1 : -1))) qface++;
+                forward[f] = static_cast<uint8_t>(lookup[p[0] + 1][p[1] + 1][p[2] + 1][qface]);
+                if (forward[f] != f) moved[face][n++] = static_cast<uint8_t>(f);
+            }
+            // Gathers for 1, 3 (prime) and 2 (half) quarter turns
+            static const int quarters[3] = {1, 3, 2};
+            for (int turn = 0; turn < 3; turn++) {
+                uint8_t* out = src[face * 3 + turn];
+                for (int f = 0; f < RUBIK_FACELETS; f++) {
+                    int to = f;
+                    for (int k = 0; k < quarters[turn]; k++) to = forward[to];
+                    out[to] = static_cast<uint8_t>(f);
+                }
+            }
+        }
+    }
+
+    // v rotated -90 degrees about sign * unit(axis): v' = n (n . v) - n x v
+    static void rotate(const int v[3], int axis, int sign, int out[3]) {
+        int a1 = (axis + 1) % 3, a2 = (axis + 2) % 3;
+        out[axis] = v[axis];
+        out[a1] = sign * v[a2];
+        out[a2] = -sign * v[a1];
+    }
+};
+
+static const RubikMoveTables& moveTables() {
+    static const RubikMoveTables tables;
+    return tables;
+}
+
+void RubikCube::rotateR() { apply(makeRubikOp(RIGHT, 0)); }
+void RubikCube::rotateL() { apply(makeRubikOp(LEFT, 0)); }
+void RubikCube::rotateU() { apply(makeRubikOp(UP, 0)); }
+void RubikCube::rotateD() { apply(makeRubikOp(DOWN, 0)); }
+void RubikCube::rotateF() { apply(makeRubikOp(FRONT, 0)); }
+void RubikCube::rotateB() { apply(makeRubikOp(BACK, 0)); }
+void RubikCube::rotateRPrime() { apply(makeRubikOp(RIGHT, 1)); }
+void RubikCube::rotateLPrime() { apply(makeRubikOp(LEFT, 1)); }
+void RubikCube::rotateUPrime() { apply(makeRubikOp(UP, 1)); }
+void RubikCube::rotateDPrime() { apply(makeRubikOp(DOWN, 1)); }
+void RubikCube::rotateFPrime() { apply(makeRubikOp(FRONT, 1)); }
+void RubikCube::rotateBPrime() { apply(makeRubikOp(BACK, 1)); }
+
+void RubikCube::apply(RubikOp op) {
+    const RubikMoveTables& t = moveTables();
+    const uint64_t (&keys)[RUBIK_FACELETS][6] = zobristTable();
+    const uint8_t* src = t.src[op.code];
+    uint8_t old[RUBIK_FACELETS];
+    std::memcpy(old, facelets_, sizeof(old));
+    for (int f = 0; f < RUBIK_FACELETS; f++) facelets_[f] = old[src[f]];
+    for (int f : t.moved[opFace(op)]) hash_ ^= keys[f][old[f]] ^ keys[f][facelets_[f]];
+}
+
+void RubikCube::apply(const RubikOp* ops, size_t count) {
+    for (size_t i = 0; i < count; i++) apply(ops[i]);
+}
 
 bool RubikCube::applyMove(const std::string& move) {
-    if (move == "R") { rotateR(); return true; }
-    if (move == "R'") { rotateRPrime(); return true; }
-    if (move == "L") { rotateL(); return true; }
-    if (move == "L'") { rotateLPrime(); return true; }
-    if (move == "U") { rotateU(); return true; }
-    if (move == "U'") { rotateUPrime(); return true; }
-    if (move == "D") { rotateD(); return true; }
-    if (move == "D'") { rotateDPrime(); return true; }
-    if (move == "F") { rotateF(); return true; }
-    if (move == "F'") { rotateFPrime(); return true; }
-    if (move == "B") { rotateB(); return true; }
-    if (move == "B'") { rotateBPrime(); return true; }
-    return false;
-}
-
-void RubikCube::scramble(int numMoves) {
-    const char* moves[] = {"R", "R'", "L", "L'", "U", "U'", "D", "D'", "F", "F'", "B", "B'"};
-    std::mt19937 rng(42u);
-    std::uniform_int_distribution<int> dist(0, 11);
+    RubikOp op;
+    if (!parseRubikOp(move, op)) return false;
+    apply(op);
+    return true;
+}
+
+void RubikCube::scrambleMoves(uint64_t seed, uint64_t index, int numMoves, RubikOp* out) {
+    PhiloxStream rng(seed, index);
     for (int i = 0; i < numMoves; i++) {
-        applyMove(moves[dist(rng)]);
+        uint32_t m = rng.below(12);  // R, R', L, L', ... (quarter turns only)
+        out[i] = makeRubikOp(static_cast<int>(m / 2), static_cast<int>(m % 2));
+    }
+}
+
+uint64_t RubikCube::scramble(int numMoves) {
+    uint64_t seed = freshSeed();
+    scramble(numMoves, seed);
+    return seed;
+}
+
+void RubikCube::scramble(int numMoves, uint64_t seed) {
+    PhiloxStream rng(seed, 0);
+    for (int i = 0; i < numMoves; i++) {
+        uint32_t m = rng.below(12);
+        apply(makeRubikOp(static_cast<int>(m / 2), static_cast<int>(m % 2)));
     }
 }
 
 bool RubikCube::isSolved() const {
-    int faceColors[] = {RED, ORANGE, WHITE, YELLOW, GREEN, BLUE};
-    for (int face = 0; face < 6; face++)
-        for (int row = 0; row < 3; row++)
-            for (int col = 0; col < 3; col++)
-                if (faces[face][row][col] != faceColors[face]) return false;
+    for (int f = 0; f < RUBIK_FACELETS; f++)
+        if (facelets_[f] != SOLVED_COLORS[f / 9]) return false;
     return true;
 }
 
-int RubikCube::getColor(int face, int row, int col) const {
-    return faces[face][row][col];
+void RubikCube::getFacelets(uint8_t out[RUBIK_FACELETS]) const {
+    std::memcpy(out, facelets_, RUBIK_FACELETS);
+}
+
+void RubikCube::setFacelets(const uint8_t in[RUBIK_FACELETS]) {
+    std::memcpy(facelets_, in, RUBIK_FACELETS);
+    hash_ = computeHash();
+}
+
+bool RubikCube::operator==(const RubikCube& o) const {
+    return std::memcmp(facelets_, o.facelets_, RUBIK_FACELETS) == 0;
+}
+
+void RubikCube::movePermutation(RubikOp op, uint8_t src[RUBIK_FACELETS]) {
+    std::memcpy(src, moveTables().src[op.code], RUBIK_FACELETS);
 }
 
-const std::vector<std::vector<std::vector<int>>>& RubikCube::getFaces() const {
-    return faces;
+void RubikCube::faceletCubie(int facelet, int& x, int& y, int& z) {
+    int face = facelet / 9, row = (facelet / 3) % 3, col = facelet % 3;
+    switch (face) {
+        case RIGHT: x = 1;       y = 1 - row; z = 1 - col; break;
+        case LEFT:  x = -1;      y = 1 - row; z = col - 1; break;
+        case UP:    x = col - 1; y = 1;       z = row - 1; break;
+        case DOWN:  x = col - 1; y = -1;      z = 1 - row; break;
+        case FRONT: x = col - 1; y = 1 - row; z = 1;       break;
+        case BACK:  x = 1 - col; y = 1 - row; z = -1;      break;
+        default:    x = y = z = 0; break;
+    }
 }
@@ -4,8 +4,10 @@
 #ifndef RUBIK_CUBE_H
 #define RUBIK_CUBE_H
 
-#include <vector>
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include "move_tokens.h"
 
 // Face colors: 0=White, 1=Yellow, 2=Red, 3=Orange, 4=Green, 5=Blue
 enum FaceColor {
@@ -27,11 +29,29 @@ enum FaceIndex {
     BACK = 5
 };
 
+// 54 facelets: facelet = face * 9 + row * 3 + col
+constexpr int RUBIK_FACELETS = 54;
+
+// Zero-copy view of the facelets as faces[face][row][col]
+class RubikFacesView {
+public:
+    class Face {
+    public:
+        explicit Face(const uint8_t* p) : p_(p) {}
+        const uint8_t* operator[](int row) const { return p_ + row * 3; }
+    private:
+        const uint8_t* p_;
+    };
+    explicit RubikFacesView(const uint8_t* data) : data_(data) {}
+    Face operator[](int face) const { return Face(data_ + face * 9); }
+private:
+    const uint8_t* data_;
+};
+
 class RubikCube {
 private:
-    std::vector<std::vector<std::vector<int>>> faces;
-    void rotateFaceClockwise(int face);
-    void rotateFaceCounterClockwise(int face);
+    uint8_t facelets_[RUBIK_FACELETS];
+    uint64_t hash_;
 
 public:
     RubikCube();
@@ -39,10 +59,37 @@ public:
     void rotateR(); void rotateL(); void rotateU(); void rotateD(); void rotateF(); void rotateB();
     void rotateRPrime(); void rotateLPrime(); void rotateUPrime(); void rotateDPrime(); void rotateFPrime(); void rotateBPrime();
     bool applyMove(const std::string& move);
-    void scramble(int numMoves = 25);
+    // Apply a pre-parsed opcode stream (see move_tokens.h); no parsing or allocation
+    void apply(const RubikOp* ops, size_t count);
+    // One gather through the op's 54-entry table (quarter, prime and half turns alike)
+    void apply(RubikOp op);
+    // Random quarter turns from Philox stream 0 of seed (see scrambleMoves); the seedless
+    // call picks a fresh seed and returns it so the scramble can be reproduced
+    uint64_t scramble(int numMoves = 25);
+    void scramble(int numMoves, uint64_t seed);
+    // Scramble `index` of a batch: numMoves quarter turns from Philox stream index of seed
+    static void scrambleMoves(uint64_t seed, uint64_t index, int numMoves, RubikOp* out);
     bool isSolved() const;
-    int getColor(int face, int row, int col) const;
-    const std::vector<std::vector<std::vector<int>>>& getFaces() const;
+    int getColor(int face, int row, int col) const { return facelets_[face * 9 + row * 3 + col]; }
+    RubikFacesView getFaces() const { return RubikFacesView(facelets_); }
+    const uint8_t* facelets() const { return facelets_; }
+    // Flat copy of the colors, indexed by facelet; setFacelets recomputes the hash
+    void getFacelets(uint8_t out[RUBIK_FACELETS]) const;
+    void setFacelets(const uint8_t in[RUBIK_FACELETS]);
+
+    bool operator==(const RubikCube& o) const;
+    bool operator!=(const RubikCube& o) const { return !(*this == o); }
+
+    // Zobrist hash: XOR of zobristKey(facelet, color) over all 54 facelets, updated by
+    // each move from the 20 facelets it changes
+    uint64_t hash() const { return hash_; }
+    uint64_t computeHash() const;
+    static uint64_t zobristKey(int facelet, int color);
+
+    // Facelet permutation of a move as a gather: new[dst] = old[src[dst]]
+    static void movePermutation(RubikOp op, uint8_t src[RUBIK_FACELETS]);
+    // Grid position (-1..1 per axis) of the cubie a facelet sits on, matching the renderer layout
+    static void faceletCubie(int facelet, int& x, int& y, int& z);
 };
 
 #endif // RUBIK_CUBE_H
@@ -0,0 +1,97 @@
+// Scramble Generator Implementation
+
+#include "scramble_generator.h"
+#include "tesseract_model.h"
+#include "rubik_cube.h"
+#include "work_stealing_pool.h"
+#include <cstring>
+#include <vector>
+
+static const char SCRAMBLE_MAGIC[8] = {'T', '4', 'S', 'C', 'R', 'A', 'M', 0};
+static const uint64_t CHUNK = 8192;
+
+static void setError(std::string* error, const std::string& msg) {
+    if (error) *error = msg;
+}
+
+// Move text per opcode, formatted once with appendMove
+struct MoveNames {
+    std::string tesseract[TESSERACT_OP_COUNT];
+    std::string rubik[RUBIK_OP_COUNT];
+    MoveNames() {
+        for (int m = 0; m < TESSERACT_OP_COUNT; m++) appendMove(tesseract[m], TesseractOp{static_cast<uint8_t>(m)});
+        for (int m = 0; m < RUBIK_OP_COUNT; m++) appendMove(rubik[m], RubikOp{static_cast<uint8_t>(m)});
+    }
+};
+
+static const MoveNames& moveNames() {
+    static const MoveNames names;
+    return names;
+}
+
+// Encode scrambles [begin, end) of the batch into out
+static void encodeChunk(const ScrambleBatch& batch, uint64_t begin, uint64_t end, std::string& out) {
+    const MoveNames& names = moveNames();
+    out.clear();
+    std::vector<uint8_t> codes(static_cast<size_t>(batch.length));
+    for (uint64_t k = begin; k < end; k++) {
+        if (batch.puzzle == SCRAMBLE_RUBIK)
+            RubikCube::scrambleMoves(batch.seed, k, batch.length, reinterpret_cast<RubikOp*>(codes.data()));
+        else
+            TesseractPuzzle::scrambleMoves(batch.seed, k, batch.length, reinterpret_cast<TesseractOp*>(codes.data()));
+        if (batch.format == SCRAMBLE_BINARY) {
+            out.append(reinterpret_cast<const char*>(codes.data()), codes.size());
+            continue;
+        }
+        for (int i = 0; i < batch.length; i++) {
+            if (i) out.push_back(' ');
+            out += batch.puzzle == SCRAMBLE_RUBIK ? names.rubik[codes[i]] : names.tesseract[codes[i]];
+        }
+        out.push_back('\n');
+    }
+}
+
+bool writeScrambles(FILE* out, const ScrambleBatch& batch, WorkStealingPool& pool, std::string* error) {
+    if (batch.length < 0) { setError(error, "negative scramble length"); return false; }
+    if (batch.format == SCRAMBLE_BINARY) {
+        ScrambleFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, SCRAMBLE_MAGIC, 8);
+        header.version = SCRAMBLE_FILE_VERSION;
+        header.puzzle = static_cast<uint32_t>(batch.puzzle);
+        header.seed = batch.seed;
+        header.first = batch.first;
+        header.count = batch.count;
+        header.length = static_cast<uint32_t>(batch.length);
+        if (std::fwrite(&header, sizeof(header), 1, out) != 1) { setError(error, "write failed"); return false; }
+    }
+
+    // A round of chunks is encoded in parallel, then written in order
+    uint64_t chunks = (batch.count + CHUNK - 1) / CHUNK;
+    size_t perRound = static_cast<size_t>(pool.size()) * 4;
+    std::vector<std::string> buffers(perRound);
+    for (uint64_t round = 0; round < chunks; round += perRound) {
+        size_t n = chunks - round < perRound ? static_cast<size_t>(chunks - round) : perRound;
+        pool.run(n, [&](size_t i, int) {
+            uint64_t begin = (round + i) * CHUNK;
+            uint64_t end = begin + CHUNK < batch.count ? begin + CHUNK : batch.count;
+            encodeChunk(batch, batch.first + begin, batch.first + end, buffers[i]);
+        });
+        for (size_t i = 0; i < n; i++)
+            if (std::fwrite(buffers[i].data(), 1, buffers[i].size(), out) != buffers[i].size()) {
+                setError(error, "write failed");
+                return false;
+            }
+    }
+    return true;
+}
+
+bool checkScrambleHeader(const ScrambleFileHeader& header, std::string* error) {
+    if (std::memcmp(header.magic, SCRAMBLE_MAGIC, 8) != 0) { setError(error, "not a scramble file"); return false; }
+    if (header.version != SCRAMBLE_FILE_VERSION) {
+        setError(error, "unsupported version " + std::to_string(header.version));
+        return false;
+    }
+    if (header.puzzle > SCRAMBLE_RUBIK) { setError(error, "unknown puzzle"); return false; }
+    return true;
+}
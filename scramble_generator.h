@@ -0,0 +1,50 @@
+// Scramble Generator
+// Reproducible bulk scrambles: scramble k of a batch depends only on (seed, k), so batches
+// can be generated in parallel, split across machines, or regenerated from the seed alone
+
+#ifndef SCRAMBLE_GENERATOR_H
+#define SCRAMBLE_GENERATOR_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+class WorkStealingPool;
+
+enum ScramblePuzzle { SCRAMBLE_TESSERACT = 0, SCRAMBLE_RUBIK = 1 };
+enum ScrambleFormat { SCRAMBLE_TEXT = 0, SCRAMBLE_BINARY = 1 };
+
+struct ScrambleBatch {
+    uint64_t seed;
+    uint64_t first;   // index of the first scramble
+    uint64_t count;
+    int length;       // moves per scramble
+    int puzzle;       // ScramblePuzzle
+    int format;       // ScrambleFormat
+    ScrambleBatch() : seed(0), first(0), count(0), length(30), puzzle(SCRAMBLE_TESSERACT), format(SCRAMBLE_TEXT) {}
+};
+
+// Binary stream: this header, then count * length opcode bytes (TesseractOp / RubikOp codes)
+struct ScrambleFileHeader {
+    char magic[8];     // "T4SCRAM" + zero byte
+    uint32_t version;
+    uint32_t puzzle;
+    uint64_t seed;
+    uint64_t first;
+    uint64_t count;
+    uint32_t length;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ScrambleFileHeader) == 48, "ScrambleFileHeader layout");
+
+constexpr uint32_t SCRAMBLE_FILE_VERSION = 1;
+
+// Text output is one scramble per line in move notation. Chunks of scrambles are encoded
+// on the pool and written in index order, so the output does not depend on thread count.
+bool writeScrambles(FILE* out, const ScrambleBatch& batch, WorkStealingPool& pool, std::string* error = nullptr);
+
+// Validate a binary header read from a stream
+bool checkScrambleHeader(const ScrambleFileHeader& header, std::string* error = nullptr);
+
+#endif // SCRAMBLE_GENERATOR_H
@@ -0,0 +1,318 @@
+// Batch Solve Pipeline Implementation
+
+#include "solve_pipeline.h"
+#include "tesseract_solver.h"
+#include "kociemba_solver.h"
+#include "move_tokens.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const size_t READ_CHUNK = 1 << 16;
+
+void setError(std::string* error, const std::string& msg) {
+    if (error) *error = msg;
+}
+
+double secondsSince(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// One scramble on its way through the ring
+struct Slot {
+    TesseractPuzzle puzzle;
+    RubikCube cube;
+    std::string problem;  // set by the reader when there is nothing to solve
+    std::string output;   // line to write, without the newline
+    int length;           // solution moves, -1 if none
+    bool timedOut;
+    double seconds;
+    bool done;
+};
+
+// Text lines or scramble_gen binary records, applied to a fresh puzzle as they are read
+class ScrambleReader {
+public:
+    ScrambleReader(FILE* in, int puzzle) : in_(in), pos_(0), binary_(false), remaining_(0), puzzle_(puzzle) {}
+
+    bool open(std::string* error) {
+        fill(sizeof(ScrambleFileHeader));
+        static const char binaryMagic[8] = {'T', '4', 'S', 'C', 'R', 'A', 'M', 0};
+        if (buf_.size() < sizeof(binaryMagic) || std::memcmp(buf_.data(), binaryMagic, sizeof(binaryMagic)) != 0)
+            return true;
+        ScrambleFileHeader header;
+        if (buf_.size() < sizeof(header)) { setError(error, "truncated scramble file header"); return false; }
+        std::memcpy(&header, buf_.data(), sizeof(header));
+        if (!checkScrambleHeader(header, error)) return false;
+        binary_ = true;
+        pos_ = sizeof(header);
+        remaining_ = header.count;
+        length_ = header.length;
+        puzzle_ = static_cast<int>(header.puzzle);
+        return true;
+    }
+
+    int puzzle() const { return puzzle_; }
+
+    // False at the end of input; truncated binary input sets error
+    bool next(Slot& slot, std::string* error) {
+        slot.puzzle.reset();
+        slot.cube.reset();
+        slot.problem.clear();
+        return binary_ ? nextRecord(slot, error) : nextLine(slot);
+    }
+
+private:
+    FILE* in_;
+    std::string buf_;
+    size_t pos_;
+    bool binary_;
+    uint64_t remaining_;
+    size_t length_ = 0;
+    int puzzle_;
+    std::vector<TesseractOp> tesseractOps_;
+    std::vector<RubikOp> rubikOps_;
+
+    // Make at least want unread bytes available unless the input ends first
+    void fill(size_t want) {
+        if (buf_.size() - pos_ >= want) return;
+        buf_.erase(0, pos_);
+        pos_ = 0;
+        char chunk[READ_CHUNK];
+        while (buf_.size() < want) {
+            size_t got = std::fread(chunk, 1, sizeof(chunk), in_);
+            if (got == 0) break;
+            buf_.append(chunk, got);
+        }
+    }
+
+    bool nextRecord(Slot& slot, std::string* error) {
+        if (remaining_ == 0) return false;
+        fill(length_);
+        if (buf_.size() - pos_ < length_) { setError(error, "truncated scramble file"); return false; }
+        const uint8_t* codes = reinterpret_cast<const uint8_t*>(buf_.data() + pos_);
+        int opCount = puzzle_ == SCRAMBLE_RUBIK ? RUBIK_OP_COUNT : TESSERACT_OP_COUNT;
+        for (size_t i = 0; i < length_ && slot.problem.empty(); i++)
+            if (codes[i] >= opCount) slot.problem = "bad opcode " + std::to_string(codes[i]);
+        if (slot.problem.empty()) {
+            if (puzzle_ == SCRAMBLE_RUBIK) slot.cube.apply(reinterpret_cast<const RubikOp*>(codes), length_);
+            else slot.puzzle.apply(reinterpret_cast<const TesseractOp*>(codes), length_);
+        }
+        pos_ += length_;
+        remaining_--;
+        return true;
+    }
+
+    bool nextLine(Slot& slot) {
+        size_t end;
+        for (;;) {
+            end = buf_.find('\n', pos_);
+            if (end != std::string::npos) break;
+            size_t before = buf_.size() - pos_;
+            fill(before + READ_CHUNK);
+            if (buf_.size() - pos_ == before) {
+                if (before == 0) return false;
+                end = buf_.size();  // last line without a newline
+                break;
+            }
+        }
+        std::string_view line(buf_.data() + pos_, end - pos_);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        pos_ = end < buf_.size() ? end + 1 : end;
+        bool ok;
+        if (puzzle_ == SCRAMBLE_RUBIK) {
+            ok = parseRubikMoves(line, rubikOps_);
+            if (ok) slot.cube.apply(rubikOps_.data(), rubikOps_.size());
+        } else {
+            ok = parseTesseractMoves(line, tesseractOps_);
+            if (ok) slot.puzzle.apply(tesseractOps_.data(), tesseractOps_.size());
+        }
+        if (!ok) slot.problem = "cannot parse scramble";
+        return true;
+    }
+};
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t i = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+}  // namespace
+
+bool runSolvePipeline(FILE* in, FILE* out, const SolvePipelineOptions& options, SolvePipelineReport& report,
+                      std::string* error) {
+    auto t0 = Clock::now();
+    report = SolvePipelineReport();
+    ScrambleReader reader(in, options.puzzle);
+    if (!reader.open(error)) return false;
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+    size_t capacity = options.queueCapacity > static_cast<size_t>(threads) ? options.queueCapacity
+                                                                           : static_cast<size_t>(threads) + 1;
+
+    // Tables are built or mapped once; each worker searches with its own single-threaded
+    // TesseractSolver over them, while the Kociemba tables are shared read-only
+    bool rubik = reader.puzzle() == SCRAMBLE_RUBIK;
+    std::unique_ptr<TesseractSolver> tables;
+    std::vector<std::unique_ptr<TesseractSolver>> tesseractSolvers;
+    std::unique_ptr<KociembaSolver> kociemba;
+    if (rubik) {
+        KociembaOptions ko;
+        ko.timeLimit = options.timeLimit > 0.0 ? options.timeLimit : 1e6;
+        if (options.maxLength > 0) ko.maxLength = options.maxLength;
+        ko.tablePath = options.tablePath;
+        kociemba.reset(new KociembaSolver(ko));
+    } else {
+        SolverOptions so;
+        so.threads = threads;
+        so.pdbPath = options.tablePath;
+        so.timeLimit = options.timeLimit;
+        if (options.maxLength > 0) so.maxDepth = options.maxLength;
+        tables.reset(new TesseractSolver(so));
+        so.threads = 1;
+        for (int w = 0; w < threads; w++) tesseractSolvers.emplace_back(new TesseractSolver(so, *tables));
+    }
+    report.setupSeconds = secondsSince(t0);
+
+    std::vector<Slot> ring(capacity);
+    std::mutex mutex;
+    std::condition_variable readable, solved, writable;
+    uint64_t readCount = 0, nextSolve = 0, written = 0;
+    bool eof = false, writeFailed = false;
+    std::vector<double> latencies;
+
+    auto solveSlot = [&](Slot& slot, int worker) {
+        auto start = Clock::now();
+        std::string reason;
+        slot.length = -1;
+        slot.timedOut = false;
+        if (!slot.problem.empty()) {
+            reason = slot.problem;
+        } else if (rubik) {
+            KociembaStats stats;
+            if (kociemba->solve(slot.cube, slot.output, &stats, &reason)) slot.length = stats.length;
+            slot.timedOut = stats.timedOut;
+        } else {
+            SolveStats stats;
+            std::vector<TesseractOp> ops;
+            if (tesseractSolvers[worker]->solve(slot.puzzle, ops, &stats)) {
+                slot.output = formatMoves(ops.data(), ops.size());
+                slot.length = static_cast<int>(ops.size());
+            }
+            slot.timedOut = stats.timedOut;
+            if (slot.length < 0) reason = stats.timedOut ? "time limit reached" : "no solution within the depth limit";
+        }
+        if (slot.length < 0) slot.output = "# " + reason;
+        slot.seconds = secondsSince(start);
+    };
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < threads; w++) {
+        workers.emplace_back([&, w] {
+            for (;;) {
+                uint64_t index;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    readable.wait(lock, [&] { return nextSolve < readCount || eof; });
+                    if (nextSolve == readCount) return;
+                    index = nextSolve++;
+                }
+                // The reader cannot reuse this slot before the writer has passed it
+                Slot& slot = ring[index % capacity];
+                solveSlot(slot, w);
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.done = true;
+                if (index == written) solved.notify_one();
+            }
+        });
+    }
+
+    std::thread writer([&] {
+        for (;;) {
+            Slot* slot;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                solved.wait(lock, [&] {
+                    return (written < readCount && ring[written % capacity].done) || (eof && written == readCount);
+                });
+                if (written == readCount) return;
+                slot = &ring[written % capacity];
+            }
+            slot->output.push_back('\n');
+            if (!writeFailed && std::fwrite(slot->output.data(), 1, slot->output.size(), out) != slot->output.size())
+                writeFailed = true;
+            if (slot->length >= 0) {
+                report.solved++;
+                if (report.lengths.size() <= static_cast<size_t>(slot->length)) report.lengths.resize(slot->length + 1, 0);
+                report.lengths[slot->length]++;
+            } else if (slot->timedOut) {
+                report.timedOut++;
+            } else {
+                report.failed++;
+            }
+            latencies.push_back(slot->seconds);
+            std::lock_guard<std::mutex> lock(mutex);
+            written++;
+            writable.notify_one();
+        }
+    });
+
+    std::string readError;
+    Slot incoming;
+    while (reader.next(incoming, &readError)) {
+        std::unique_lock<std::mutex> lock(mutex);
+        writable.wait(lock, [&] { return readCount - written < capacity; });
+        Slot& slot = ring[readCount % capacity];
+        std::swap(slot, incoming);
+        slot.done = false;
+        readCount++;
+        readable.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        eof = true;
+    }
+    readable.notify_all();
+    solved.notify_one();
+    for (std::thread& t : workers) t.join();
+    writer.join();
+
+    report.scrambles = readCount;
+    std::sort(latencies.begin(), latencies.end());
+    report.p50 = percentile(latencies, 0.50);
+    report.p90 = percentile(latencies, 0.90);
+    report.p99 = percentile(latencies, 0.99);
+    report.maxLatency = latencies.empty() ? 0.0 : latencies.back();
+    report.seconds = secondsSince(t0);
+    if (!readError.empty()) { setError(error, readError); return false; }
+    if (writeFailed || std::fflush(out) != 0) { setError(error, "write failed"); return false; }
+    return true;
+}
+
+void printSolveReport(FILE* out, const SolvePipelineReport& report) {
+    double solveSeconds = report.seconds - report.setupSeconds;
+    std::fprintf(out, "%llu scrambles in %.3f s (%.3f s tables): %.1f /s\n",
+                 static_cast<unsigned long long>(report.scrambles), report.seconds, report.setupSeconds,
+                 solveSeconds > 0.0 ? static_cast<double>(report.scrambles) / solveSeconds : 0.0);
+    std::fprintf(out, "solved %llu, timed out %llu, failed %llu\n", static_cast<unsigned long long>(report.solved),
+                 static_cast<unsigned long long>(report.timedOut), static_cast<unsigned long long>(report.failed));
+    uint64_t most = 0;
+    for (uint64_t n : report.lengths) most = std::max(most, n);
+    for (size_t len = 0; len < report.lengths.size(); len++) {
+        if (report.lengths[len] == 0) continue;
+        int bar = static_cast<int>(40 * report.lengths[len] / most);
+        std::fprintf(out, "  %3zu moves %10llu %s\n", len, static_cast<unsigned long long>(report.lengths[len]),
+                     std::string(bar > 0 ? bar : 1, '#').c_str());
+    }
+    std::fprintf(out, "latency p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n", report.p50 * 1e3,
+                 report.p90 * 1e3, report.p99 * 1e3, report.maxLatency * 1e3);
+}
@@ -0,0 +1,51 @@
+// Batch Solve Pipeline
+// Streams scrambles through a bounded queue to solver threads and writes solutions in input order
+
+#ifndef SOLVE_PIPELINE_H
+#define SOLVE_PIPELINE_H
+
+#include "scramble_generator.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct SolvePipelineOptions {
+    int puzzle;            // ScramblePuzzle of text input; binary input names its own
+    int threads;           // solver threads; 0 = all cores
+    size_t queueCapacity;  // scrambles read ahead of the oldest one not yet written
+    double timeLimit;      // seconds per scramble; 0 = no limit
+    int maxLength;         // longest solution searched; 0 = the solver's default
+    std::string tablePath; // pdb_build output (tesseract) or Kociemba table cache (rubik); "" = build
+    SolvePipelineOptions()
+        : puzzle(SCRAMBLE_TESSERACT), threads(0), queueCapacity(4096), timeLimit(10.0), maxLength(0) {}
+};
+
+struct SolvePipelineReport {
+    uint64_t scrambles;  // lines or binary records read
+    uint64_t solved;
+    uint64_t timedOut;
+    uint64_t failed;     // unparsable, unreachable or nothing within maxLength
+    double seconds;      // wall time of the whole run, table setup included
+    double setupSeconds; // building or mapping the solver tables
+    std::vector<uint64_t> lengths;  // [n] = solutions of n moves
+    // Per-scramble solve time (not counting time queued) over all scrambles
+    double p50, p90, p99, maxLatency;
+    SolvePipelineReport()
+        : scrambles(0), solved(0), timedOut(0), failed(0), seconds(0.0), setupSeconds(0.0),
+          p50(0.0), p90(0.0), p99(0.0), maxLatency(0.0) {}
+};
+
+// Input is text (one scramble per line, in options.puzzle notation) or a scramble_gen
+// --binary stream, told apart by the binary magic. Output is one line per scramble in
+// input order: the solution in move notation, or "# " and the reason it has none.
+// One reader (the caller), options.threads solvers and one writer thread share a ring of
+// queueCapacity slots, so memory stays bounded however long the input is.
+// False only on I/O or format errors.
+bool runSolvePipeline(FILE* in, FILE* out, const SolvePipelineOptions& options, SolvePipelineReport& report,
+                      std::string* error = nullptr);
+
+// Human-readable summary: throughput, length histogram, latency percentiles
+void printSolveReport(FILE* out, const SolvePipelineReport& report);
+
+#endif // SOLVE_PIPELINE_H
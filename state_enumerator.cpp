@@ -0,0 +1,217 @@
+// State-Space Enumerator Implementation
+
+#include "state_enumerator.h"
+#include "pattern_db.h"
+#include "tesseract_symmetry.h"
+#include "bit_ops.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+static const size_t FRONTIER_CHUNK = 4096;
+
+static std::vector<TesseractOp> planeOps(uint32_t planes) {
+    std::vector<TesseractOp> ops;
+    for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+        TesseractOp op{static_cast<uint8_t>(m)};
+        if ((planes >> opPlane(op)) & 1) ops.push_back(op);
+    }
+    return ops;
+}
+
+// forward[op][p] = where the sticker at p goes under op
+struct ForwardMaps {
+    uint8_t forward[TESSERACT_OP_COUNT][TESSERACT_STICKERS];
+    ForwardMaps() {
+        for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+            TesseractOp op{static_cast<uint8_t>(m)};
+            uint8_t src[TESSERACT_STICKERS];
+            TesseractPuzzle::slicePermutation(opPlane(op), opLayer(op), opClockwise(op), src);
+            for (int dst = 0; dst < TESSERACT_STICKERS; dst++) forward[m][src[dst]] = static_cast<uint8_t>(dst);
+        }
+    }
+};
+
+static const ForwardMaps& forwardMaps() {
+    static const ForwardMaps maps;
+    return maps;
+}
+
+// ---------------------------------------------------------------------------
+// StickerSetSpace
+
+StickerSetSpace::StickerSetSpace(uint64_t start, uint32_t planes)
+    : start_(start), k_(popCount(start)), size_(TesseractPatternDb::binomial(TESSERACT_STICKERS, k_)),
+      ops_(planeOps(planes)) {}
+
+uint64_t StickerSetSpace::root() const {
+    return TesseractPatternDb::rank(start_);
+}
+
+int StickerSetSpace::expand(uint64_t r, uint64_t out[TESSERACT_OP_COUNT]) const {
+    uint64_t mask = TesseractPatternDb::unrank(r, k_);
+    int n = 0;
+    for (TesseractOp op : ops_) out[n++] = TesseractPatternDb::rank(TesseractPuzzle::permuteMask(mask, op));
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// StickerTupleSpace
+
+StickerTupleSpace::StickerTupleSpace(const std::vector<int>& stickers, uint32_t planes)
+    : start_(stickers), size_(1), ops_(planeOps(planes)) {
+    for (size_t j = 0; j < start_.size(); j++) size_ *= static_cast<uint64_t>(TESSERACT_STICKERS - j);
+}
+
+uint64_t StickerTupleSpace::rank(const int positions[8]) const {
+    uint64_t r = 0, used = 0;
+    for (size_t j = 0; j < start_.size(); j++) {
+        uint64_t below = (uint64_t(1) << positions[j]) - 1;
+        r = r * static_cast<uint64_t>(TESSERACT_STICKERS - j) +
+            static_cast<uint64_t>(positions[j] - popCount(used & below));
+        used |= uint64_t(1) << positions[j];
+    }
+    return r;
+}
+
+void StickerTupleSpace::unrank(uint64_t r, int positions[8]) const {
+    int k = static_cast<int>(start_.size());
+    int digits[8];
+    for (int j = k - 1; j >= 0; j--) {
+        digits[j] = static_cast<int>(r % static_cast<uint64_t>(TESSERACT_STICKERS - j));
+        r /= static_cast<uint64_t>(TESSERACT_STICKERS - j);
+    }
+    uint64_t used = 0;
+    for (int j = 0; j < k; j++) {
+        uint64_t free = ~used;
+        for (int skip = digits[j]; skip > 0; skip--) free &= free - 1;
+        positions[j] = lowestBit(free);
+        used |= uint64_t(1) << positions[j];
+    }
+}
+
+int StickerTupleSpace::expand(uint64_t r, uint64_t out[TESSERACT_OP_COUNT]) const {
+    const ForwardMaps& maps = forwardMaps();
+    int cur[8], next[8];
+    unrank(r, cur);
+    int n = 0;
+    for (TesseractOp op : ops_) {
+        for (size_t j = 0; j < start_.size(); j++) next[j] = maps.forward[op.code][cur[j]];
+        out[n++] = rank(next);
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// SymmetricStickerSetSpace
+
+static uint64_t mapMask(const std::array<uint8_t, TESSERACT_STICKERS>& map, uint64_t mask) {
+    uint64_t out = 0;
+    for (; mask; mask &= mask - 1) out |= uint64_t(1) << map[lowestBit(mask)];
+    return out;
+}
+
+SymmetricStickerSetSpace::SymmetricStickerSetSpace(uint64_t start, uint32_t planes)
+    : start_(start), k_(popCount(start)), size_(TesseractPatternDb::binomial(TESSERACT_STICKERS, k_)),
+      ops_(planeOps(planes)) {
+    // Symmetry g = 0 is the identity, so maps_[0] is too
+    for (int g = 0; g < TESSERACT_SYMMETRIES; g++) {
+        std::array<uint8_t, TESSERACT_STICKERS> map;
+        for (int p = 0; p < TESSERACT_STICKERS; p++) map[p] = static_cast<uint8_t>(symmetrySticker(g, p));
+        if (mapMask(map, start_) != start_) continue;
+        bool closed = true;
+        for (TesseractOp op : ops_) closed = closed && ((planes >> opPlane(conjugateOp(g, op))) & 1);
+        if (closed) maps_.push_back(map);
+    }
+}
+
+uint64_t SymmetricStickerSetSpace::root() const {
+    return TesseractPatternDb::rank(canonical(start_));
+}
+
+uint64_t SymmetricStickerSetSpace::canonical(uint64_t mask) const {
+    uint64_t best = mask;
+    for (size_t h = 1; h < maps_.size(); h++) best = std::min(best, mapMask(maps_[h], mask));
+    return best;
+}
+
+int SymmetricStickerSetSpace::expand(uint64_t r, uint64_t out[TESSERACT_OP_COUNT]) const {
+    uint64_t mask = TesseractPatternDb::unrank(r, k_);
+    int n = 0;
+    for (TesseractOp op : ops_) out[n++] = TesseractPatternDb::rank(canonical(TesseractPuzzle::permuteMask(mask, op)));
+    return n;
+}
+
+uint64_t SymmetricStickerSetSpace::weight(uint64_t r) const {
+    uint64_t mask = TesseractPatternDb::unrank(r, k_);
+    uint64_t images[TESSERACT_SYMMETRIES];
+    for (size_t h = 0; h < maps_.size(); h++) images[h] = mapMask(maps_[h], mask);
+    std::sort(images, images + maps_.size());
+    return static_cast<uint64_t>(std::unique(images, images + maps_.size()) - images);
+}
+
+// ---------------------------------------------------------------------------
+// BFS
+
+void enumerateStates(const StateSpace& space, WorkStealingPool& pool, EnumerateResult& result,
+                     int maxDepth, const std::function<void(int, uint64_t, uint64_t)>& onDepth) {
+    auto t0 = std::chrono::steady_clock::now();
+    result = EnumerateResult();
+
+    uint64_t words = (space.size() + 63) / 64;
+    std::unique_ptr<std::atomic<uint64_t>[]> visited(new std::atomic<uint64_t>[words]);
+    for (uint64_t i = 0; i < words; i++) visited[i].store(0, std::memory_order_relaxed);
+
+    std::vector<uint64_t> frontier(1, space.root());
+    visited[frontier[0] >> 6].store(uint64_t(1) << (frontier[0] & 63));
+    std::vector<std::vector<uint64_t>> buffers(pool.size());
+    std::vector<uint64_t> weights(pool.size(), 0);  // per worker: states its new ranks stand for
+    uint64_t levelStates = space.weight(frontier[0]);
+
+    for (int depth = 0; !frontier.empty(); depth++) {
+        result.depthCounts.push_back(frontier.size());
+        result.depthStates.push_back(levelStates);
+        result.states += frontier.size();
+        result.expandedStates += levelStates;
+        if (onDepth) onDepth(depth, frontier.size(), levelStates);
+        if (depth == maxDepth) break;
+
+        size_t chunks = (frontier.size() + FRONTIER_CHUNK - 1) / FRONTIER_CHUNK;
+        pool.run(chunks, [&](size_t c, int worker) {
+            std::vector<uint64_t>& out = buffers[worker];
+            size_t end = (c + 1) * FRONTIER_CHUNK < frontier.size() ? (c + 1) * FRONTIER_CHUNK : frontier.size();
+            uint64_t next[TESSERACT_OP_COUNT];
+            for (size_t i = c * FRONTIER_CHUNK; i < end; i++) {
+                int n = space.expand(frontier[i], next);
+                for (int j = 0; j < n; j++) {
+                    std::atomic<uint64_t>& w = visited[next[j] >> 6];
+                    uint64_t bit = uint64_t(1) << (next[j] & 63);
+                    // Plain load first: most neighbours are already visited
+                    if (w.load(std::memory_order_relaxed) & bit) continue;
+                    if (w.fetch_or(bit, std::memory_order_relaxed) & bit) continue;
+                    out.push_back(next[j]);
+                    weights[worker] += space.weight(next[j]);
+                }
+            }
+        });
+
+        size_t total = 0;
+        for (const std::vector<uint64_t>& b : buffers) total += b.size();
+        levelStates = 0;
+        for (uint64_t& w : weights) {
+            levelStates += w;
+            w = 0;
+        }
+        frontier.clear();
+        frontier.reserve(total);
+        for (std::vector<uint64_t>& b : buffers) {
+            frontier.insert(frontier.end(), b.begin(), b.end());
+            b.clear();
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    result.statesPerSecond = result.seconds > 0.0 ? static_cast<double>(result.states) / result.seconds : 0.0;
+}
@@ -0,0 +1,110 @@
+// State-Space Enumerator
+// Exact distance histograms for reduced TesseractPuzzle state spaces by frontier-by-frontier BFS
+
+#ifndef STATE_ENUMERATOR_H
+#define STATE_ENUMERATOR_H
+
+#include "tesseract_model.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class WorkStealingPool;
+
+// Bit per RotationPlane; the reduced puzzle only turns slices of these planes
+constexpr uint32_t ALL_PLANES = 0x3F;
+
+// A reduced puzzle whose states are ranked densely in [0, size())
+class StateSpace {
+public:
+    virtual ~StateSpace() {}
+    virtual uint64_t size() const = 0;
+    virtual uint64_t root() const = 0;
+    // Ranks of the states one move away; returns how many were written (<= 48)
+    virtual int expand(uint64_t r, uint64_t out[TESSERACT_OP_COUNT]) const = 0;
+    // States of the full space that rank r stands for: its orbit size in a symmetry-reduced space
+    virtual uint64_t weight(uint64_t) const { return 1; }
+};
+
+// Where a set of indistinguishable stickers can be (e.g. all 8 of one color):
+// the positions mask, colex-ranked, C(64, k) states for k <= 8
+class StickerSetSpace : public StateSpace {
+public:
+    StickerSetSpace(uint64_t start, uint32_t planes = ALL_PLANES);
+    uint64_t size() const override { return size_; }
+    uint64_t root() const override;
+    int expand(uint64_t r, uint64_t out[TESSERACT_OP_COUNT]) const override;
+
+private:
+    uint64_t start_;
+    int k_;
+    uint64_t size_;
+    std::vector<TesseractOp> ops_;
+};
+
+// Where k distinguishable stickers are: ordered positions ranked as a partial
+// permutation, 64! / (64 - k)! states for k <= 5
+class StickerTupleSpace : public StateSpace {
+public:
+    StickerTupleSpace(const std::vector<int>& stickers, uint32_t planes = ALL_PLANES);
+    uint64_t size() const override { return size_; }
+    uint64_t root() const override { return rank(start_.data()); }
+    int expand(uint64_t r, uint64_t out[TESSERACT_OP_COUNT]) const override;
+
+    uint64_t rank(const int positions[8]) const;
+    void unrank(uint64_t r, int positions[8]) const;
+
+private:
+    std::vector<int> start_;
+    uint64_t size_;
+    std::vector<TesseractOp> ops_;
+};
+
+// The coset space of StickerSetSpace modulo symmetry: one rank per orbit of sticker sets
+// under the tesseract symmetries (tesseract_symmetry.h) that fix the start set and map the
+// chosen planes' moves to chosen-plane moves. Those symmetries preserve the distance from
+// the root, so the histogram over orbits, weighted by orbit size, is the unreduced one.
+// An orbit is ranked by its smallest mask, which is also its smallest colex rank, so ranks
+// stay in [0, C(64, k)) and the bitmap keeps the unreduced size; what shrinks, by up to
+// symmetries(), is the frontier lists, which dominate BFS memory at 8 bytes per state.
+// Canonicalizing a k-sticker set maps k bits per symmetry, far cheaper than a full state.
+class SymmetricStickerSetSpace : public StateSpace {
+public:
+    SymmetricStickerSetSpace(uint64_t start, uint32_t planes = ALL_PLANES);
+    uint64_t size() const override { return size_; }
+    uint64_t root() const override;
+    int expand(uint64_t r, uint64_t out[TESSERACT_OP_COUNT]) const override;
+    uint64_t weight(uint64_t r) const override;
+
+    int symmetries() const { return static_cast<int>(maps_.size()); }
+    // Smallest image of mask under the symmetries
+    uint64_t canonical(uint64_t mask) const;
+
+private:
+    uint64_t start_;
+    int k_;
+    uint64_t size_;
+    std::vector<TesseractOp> ops_;
+    std::vector<std::array<uint8_t, TESSERACT_STICKERS>> maps_;  // sticker maps, identity first
+};
+
+struct EnumerateResult {
+    std::vector<uint64_t> depthCounts;  // ranks at exactly each distance from root
+    std::vector<uint64_t> depthStates;  // states they stand for (= depthCounts unless reduced)
+    uint64_t states;                    // reachable ranks
+    uint64_t expandedStates;            // reachable states of the full space
+    double seconds;
+    double statesPerSecond;
+    EnumerateResult() : states(0), expandedStates(0), seconds(0.0), statesPerSecond(0.0) {}
+};
+
+// BFS from space.root(). Visited states live in one atomic bitmap (size() bits); each
+// level's frontier is split into chunks on the pool and every worker appends newly
+// claimed states to its own buffer, which become the next frontier.
+// onDepth, if set, is called as each level completes with its rank and state counts.
+// maxDepth < 0 = no limit.
+void enumerateStates(const StateSpace& space, WorkStealingPool& pool, EnumerateResult& result, int maxDepth = -1,
+                     const std::function<void(int, uint64_t, uint64_t)>& onDepth = nullptr);
+
+#endif // STATE_ENUMERATOR_H
@@ -0,0 +1,187 @@
+// Tesseract Batch Implementation
+
+#include "tesseract_batch.h"
+#include "bit_ops.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BATCH_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BATCH_SSE2 1
+#endif
+
+namespace {
+
+// One 32-byte sticker row
+#if defined(BATCH_AVX2)
+struct Row {
+    __m256i v;
+    static Row load(const uint8_t* p) { return Row{_mm256_load_si256(reinterpret_cast<const __m256i*>(p))}; }
+    void store(uint8_t* p) const { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+};
+#elif defined(BATCH_SSE2)
+struct Row {
+    __m128i lo, hi;
+    static Row load(const uint8_t* p) {
+        return Row{_mm_load_si128(reinterpret_cast<const __m128i*>(p)),
+                   _mm_load_si128(reinterpret_cast<const __m128i*>(p + 16))};
+    }
+    void store(uint8_t* p) const {
+        _mm_store_si128(reinterpret_cast<__m128i*>(p), lo);
+        _mm_store_si128(reinterpret_cast<__m128i*>(p + 16), hi);
+    }
+};
+#else
+struct Row {
+    uint64_t w[4];
+    static Row load(const uint8_t* p) { Row r; std::memcpy(r.w, p, 32); return r; }
+    void store(uint8_t* p) const { std::memcpy(p, w, 32); }
+};
+#endif
+
+// Lanes of a block whose row equals `color` in every byte, as a 32-bit mask
+inline uint32_t matchMask(const uint8_t* row, uint8_t color) {
+#if defined(BATCH_AVX2)
+    __m256i eq = _mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(row)), _mm256_set1_epi8(static_cast<char>(color)));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+#elif defined(BATCH_SSE2)
+    __m128i c = _mm_set1_epi8(static_cast<char>(color));
+    uint32_t lo = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(row)), c)));
+    uint32_t hi = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(row + 16)), c)));
+    return lo | (hi << 16);
+#else
+    uint32_t m = 0;
+    for (int i = 0; i < BATCH_LANES; i++) m |= static_cast<uint32_t>(row[i] == color) << i;
+    return m;
+#endif
+}
+
+// Moved stickers of each op as (dst, src) row pairs
+struct MoveRows {
+    int count;
+    uint8_t dst[TESSERACT_STICKERS];
+    uint8_t src[TESSERACT_STICKERS];
+};
+
+const MoveRows& moveRows(int code) {
+    struct Table {
+        MoveRows moves[TESSERACT_OP_COUNT];
+        Table() {
+            for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+                TesseractOp op{static_cast<uint8_t>(m)};
+                uint8_t src[TESSERACT_STICKERS];
+                TesseractPuzzle::slicePermutation(opPlane(op), opLayer(op), opClockwise(op), src);
+                MoveRows& mr = moves[m];
+                mr.count = 0;
+                for (int d = 0; d < TESSERACT_STICKERS; d++)
+                    if (src[d] != d) {
+                        mr.dst[mr.count] = static_cast<uint8_t>(d);
+                        mr.src[mr.count] = src[d];
+                        mr.count++;
+                    }
+            }
+        }
+    };
+    static const Table table;
+    return table.moves[code];
+}
+
+}  // namespace
+
+template <typename BlockT>
+static inline void applyToBlock(BlockT& block, const MoveRows& mr) {
+    // Gather every source row first, then scatter: moves are cycles, so rows overlap
+    Row tmp[TESSERACT_STICKERS];
+    for (int j = 0; j < mr.count; j++) tmp[j] = Row::load(block.rows[mr.src[j]]);
+    for (int j = 0; j < mr.count; j++) tmp[j].store(block.rows[mr.dst[j]]);
+}
+
+TesseractBatch::TesseractBatch(size_t count) : count_(0) {
+    resize(count);
+}
+
+void TesseractBatch::resize(size_t count) {
+    blocks_.resize((count + BATCH_LANES - 1) / BATCH_LANES);
+    // Lanes from the first added puzzle (or the new end, when shrinking) to the end of
+    // storage hold solved colors, so later growth never exposes old lanes
+    const TesseractState& solved = TesseractPuzzle::solvedState();
+    size_t end = blocks_.size() * BATCH_LANES;
+    for (size_t i = std::min(count_, count); i < end;) {
+        size_t b = i / BATCH_LANES, lane = i % BATCH_LANES;
+        for (int s = 0; s < TESSERACT_STICKERS; s++)
+            std::memset(blocks_[b].rows[s] + lane, solved.getColor(s), BATCH_LANES - lane);
+        i += BATCH_LANES - lane;
+    }
+    count_ = count;
+}
+
+void TesseractBatch::reset() {
+    size_t count = count_;
+    count_ = 0;
+    resize(count);
+}
+
+void TesseractBatch::set(size_t i, const TesseractPuzzle& puzzle) {
+    Block& block = blocks_[i / BATCH_LANES];
+    const TesseractState& st = puzzle.getState();
+    for (int s = 0; s < TESSERACT_STICKERS; s++) block.rows[s][i % BATCH_LANES] = static_cast<uint8_t>(st.getColor(s));
+}
+
+TesseractPuzzle TesseractBatch::get(size_t i) const {
+    const Block& block = blocks_[i / BATCH_LANES];
+    TesseractState st = {{0, 0, 0}};
+    for (int s = 0; s < TESSERACT_STICKERS; s++) st.setColor(s, block.rows[s][i % BATCH_LANES]);
+    TesseractPuzzle p;
+    p.setState(st);
+    return p;
+}
+
+void TesseractBatch::rotateSlice(int plane, int layer, bool clockwise) {
+    if (plane < 0 || plane > 5 || layer < 0 || layer > 3) return;
+    apply(makeTesseractOp(plane, layer, clockwise));
+}
+
+void TesseractBatch::apply(TesseractOp op) {
+    apply(&op, 1);
+}
+
+void TesseractBatch::apply(const TesseractOp* ops, size_t count) {
+    for (Block& block : blocks_)
+        for (size_t i = 0; i < count; i++)
+            if (ops[i].code < TESSERACT_OP_COUNT) applyToBlock(block, moveRows(ops[i].code));
+}
+
+void TesseractBatch::isSolved(std::vector<uint64_t>& mask) const {
+    mask.assign((count_ + 63) / 64, 0);
+    const TesseractState& solved = TesseractPuzzle::solvedState();
+    uint8_t colors[TESSERACT_STICKERS];
+    for (int s = 0; s < TESSERACT_STICKERS; s++) colors[s] = static_cast<uint8_t>(solved.getColor(s));
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        uint32_t lanes = 0xFFFFFFFFu;
+        for (int s = 0; s < TESSERACT_STICKERS && lanes; s++) lanes &= matchMask(blocks_[b].rows[s], colors[s]);
+        size_t first = b * BATCH_LANES;
+        if (first + BATCH_LANES > count_) lanes &= (1u << (count_ - first)) - 1;  // padding lanes
+        mask[first / 64] |= static_cast<uint64_t>(lanes) << (first % 64);
+    }
+}
+
+size_t TesseractBatch::countSolved() const {
+    std::vector<uint64_t> mask;
+    isSolved(mask);
+    size_t n = 0;
+    for (uint64_t w : mask) n += static_cast<size_t>(popCount(w));
+    return n;
+}
+
+const char* TesseractBatch::simdPath() {
+#if defined(BATCH_AVX2)
+    return "avx2";
+#elif defined(BATCH_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
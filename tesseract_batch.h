@@ -0,0 +1,51 @@
+// Tesseract Batch
+// Structure-of-arrays container that applies the same move to many puzzles at once
+
+#ifndef TESSERACT_BATCH_H
+#define TESSERACT_BATCH_H
+
+#include "tesseract_model.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Puzzles are stored in blocks of BATCH_LANES. Inside a block each of the 64 sticker slots
+// is one contiguous 32-byte lane array (color of that sticker in each puzzle), so a slice
+// move copies 32 whole rows per block with vector loads/stores (AVX2, SSE2, or a portable
+// scalar fallback, chosen at compile time) and no per-puzzle branching.
+constexpr int BATCH_LANES = 32;
+
+class TesseractBatch {
+public:
+    explicit TesseractBatch(size_t count = 0);
+
+    size_t size() const { return count_; }
+    void resize(size_t count);  // new puzzles start solved
+    void reset();
+
+    void set(size_t i, const TesseractPuzzle& puzzle);
+    TesseractPuzzle get(size_t i) const;
+
+    // The same move on every puzzle
+    void rotateSlice(int plane, int layer, bool clockwise);
+    void apply(TesseractOp op);
+    // A whole sequence, block by block so each block stays in L1
+    void apply(const TesseractOp* ops, size_t count);
+
+    // Bit i % 64 of mask[i / 64] set when puzzle i is solved
+    void isSolved(std::vector<uint64_t>& mask) const;
+    size_t countSolved() const;
+
+    // "avx2", "sse2" or "scalar"
+    static const char* simdPath();
+
+private:
+    struct alignas(32) Block {
+        uint8_t rows[TESSERACT_STICKERS][BATCH_LANES];
+    };
+
+    size_t count_;
+    std::vector<Block> blocks_;
+};
+
+#endif // TESSERACT_BATCH_H
@@ -1,10 +1,12 @@
 // Tesseract Puzzle Implementation
-// 2x2x2x2 state and plane-based slice rotations
+// 2x2x2x2 state (packed bit planes) and plane-based slice rotations from HypercubeGeometry<2, 4>
 
 #include "tesseract_model.h"
+#include "tesseract_symmetry.h"
+#include "bit_ops.h"
+#include "philox.h"
+#include "zobrist.h"
 #include <algorithm>
-#include <random>
-#include <ctime>
 #include <cstring>
 
 // Vertex index from grid coords (each 0 or 1)
@@ -12,34 +14,75 @@ int TesseractPuzzle::vertexIndex(int ix, int iy, int iz, int iw) const {
     return ix * 8 + iy * 4 + iz * 2 + iw;
 }
 
+// Solved colors per vertex, built once and shared by reset() and isSolved()
+static TesseractState makeSolvedState() {
+    const TesseractPuzzle::Geometry& g = TesseractPuzzle::Geometry::get();
+    TesseractState st = {{0, 0, 0}};
+    for (int p = 0; p < TESSERACT_STICKERS; p++) st.setColor(p, g.solved[p]);
+    return st;
+}
+
+const TesseractState& TesseractPuzzle::solvedState() {
+    static const TesseractState solved = makeSolvedState();
+    return solved;
+}
+
+// Zobrist keys are linear in the color bits: key(p, c) = XOR of bitKey[b][p] over the set
+// bits b of c. A state's hash is then a GF(2)-linear function of its three bit planes, so a
+// move updates it from the changed bits alone, looked up a byte at a time in
+// bytes[b][i][v] = XOR of bitKey[b][8i + j] for the bits j set in v.
+struct ZobristTables {
+    uint64_t bitKey[3][TESSERACT_STICKERS];
+    uint64_t bytes[3][8][256];
+    ZobristTables() {
+        uint64_t seed = 0x7E55E4AC7ull;
+        for (int b = 0; b < 3; b++)
+            for (int p = 0; p < TESSERACT_STICKERS; p++) bitKey[b][p] = splitMix64(seed);
+        for (int b = 0; b < 3; b++)
+            for (int i = 0; i < 8; i++)
+                for (int v = 0; v < 256; v++) {
+                    uint64_t h = 0;
+                    for (int j = 0; j < 8; j++)
+                        if ((v >> j) & 1) h ^= bitKey[b][i * 8 + j];
+                    bytes[b][i][v] = h;
+                }
+    }
+};
+
+static const ZobristTables& zobristTables() {
+    static const ZobristTables tables;
+    return tables;
+}
+
+// Hash contribution of three bit planes (a full state, or the XOR of two states)
+static inline uint64_t planeHash(uint64_t p0, uint64_t p1, uint64_t p2) {
+    const ZobristTables& z = zobristTables();
+    uint64_t h = 0;
+    for (int i = 0; i < 8; i++)
+        h ^= z.bytes[0][i][(p0 >> (i * 8)) & 0xFF] ^ z.bytes[1][i][(p1 >> (i * 8)) & 0xFF] ^
+             z.bytes[2][i][(p2 >> (i * 8)) & 0xFF];
+    return h;
+}
+
+uint64_t TesseractPuzzle::zobristKey(int sticker, int color) {
+    const ZobristTables& z = zobristTables();
+    uint64_t k = 0;
+    for (int b = 0; b < 3; b++)
+        if ((color >> b) & 1) k ^= z.bitKey[b][sticker & 63];
+    return k;
+}
+
+uint64_t TesseractPuzzle::hashState(const TesseractState& s) {
+    return planeHash(s.planes[0], s.planes[1], s.planes[2]);
+}
+
 void TesseractPuzzle::initSolved() {
-    // Each vertex gets colors for the 4 cells it touches (where coord = 1)
-    // Slot 0 = +X, 1 = +Y, 2 = +Z, 3 = +W. For vertex (ix,iy,iz,iw):
-    // slot 0 used when ix=1 (touches +X cell), slot 1 when iy=1, etc.
-    static const int solved[16][4] = {
-        {C_X_NEG, C_Y_NEG, C_Z_NEG, C_W_NEG}, // 0: (0,0,0,0) - no +axis
-        {C_X_NEG, C_Y_NEG, C_Z_NEG, C_W_POS}, // 1
-        {C_X_NEG, C_Y_NEG, C_Z_POS, C_W_NEG}, // 2
-        {C_X_NEG, C_Y_NEG, C_Z_POS, C_W_POS}, // 3
-        {C_X_NEG, C_Y_POS, C_Z_NEG, C_W_NEG}, // 4
-        {C_X_NEG, C_Y_POS, C_Z_NEG, C_W_POS}, // 5
-        {C_X_NEG, C_Y_POS, C_Z_POS, C_W_NEG}, // 6
-        {C_X_NEG, C_Y_POS, C_Z_POS, C_W_POS}, // 7
-        {C_X_POS, C_Y_NEG, C_Z_NEG, C_W_NEG}, // 8
-        {C_X_POS, C_Y_NEG, C_Z_NEG, C_W_POS}, // 9
-        {C_X_POS, C_Y_NEG, C_Z_POS, C_W_NEG}, // 10
-        {C_X_POS, C_Y_NEG, C_Z_POS, C_W_POS}, // 11
-        {C_X_POS, C_Y_POS, C_Z_NEG, C_W_NEG}, // 12
-        {C_X_POS, C_Y_POS, C_Z_NEG, C_W_POS}, // 13
-        {C_X_POS, C_Y_POS, C_Z_POS, C_W_NEG}, // 14
-        {C_X_POS, C_Y_POS, C_Z_POS, C_W_POS}, // 15
-    };
-    for (int i = 0; i < 16; i++)
-        for (int s = 0; s < 4; s++)
-            vertices_[i].colors[s] = solved[i][s];
+    static const uint64_t solvedHash = hashState(solvedState());
+    state_ = solvedState();
+    hash_ = solvedHash;
 }
 
-TesseractPuzzle::TesseractPuzzle() {
+TesseractPuzzle::HypercubePuzzle() {
     initSolved();
 }
 
@@ -47,118 +90,160 @@ void TesseractPuzzle::reset() {
     initSolved();
 }
 
-// Get 4 vertex indices for (plane, layer). Layer 0..3.
-// Returns indices in order: (0,0), (1,0), (1,1), (0,1) for the 2D sub-coords.
-static void getLayerIndices(int plane, int layer, int indices[4]) {
-    int a = layer / 2;
-    int b = layer % 2;
-    switch (plane) {
-        case PLANE_XY: { int iz = a, iw = b; indices[0] = iz*2+iw; indices[1] = 8+iz*2+iw; indices[2] = 12+iz*2+iw; indices[3] = 4+iz*2+iw; break; }
-        case PLANE_XZ: { int iy = a, iw = b; indices[0] = iy*4+iw; indices[1] = 8+iy*4+iw; indices[2] = 10+iy*4+iw; indices[3] = iy*4+2+iw; break; }
-        case PLANE_XW: { int iy = a, iz = b; indices[0] = iy*4+iz*2; indices[1] = 8+iy*4+iz*2; indices[2] = 8+iy*4+iz*2+1; indices[3] = iy*4+iz*2+1; break; }
-        case PLANE_YZ: { int ix = a, iw = b; indices[0] = ix*8+iw; indices[1] = ix*8+4+iw; indices[2] = ix*8+6+iw; indices[3] = ix*8+2+iw; break; }
-        case PLANE_YW: { int ix = a, iz = b; indices[0] = ix*8+iz*2; indices[1] = ix*8+4+iz*2; indices[2] = ix*8+6+iz*2; indices[3] = ix*8+2+iz*2; break; }
-        case PLANE_ZW: { int ix = a, iy = b; indices[0] = ix*8+iy*4; indices[1] = ix*8+iy*4+2; indices[2] = ix*8+iy*4+3; indices[3] = ix*8+iy*4+1; break; }
-        default: indices[0]=0; indices[1]=1; indices[2]=2; indices[3]=3; break;
-    }
+void TesseractPuzzle::slicePermutation(int plane, int layer, bool clockwise, uint8_t src[TESSERACT_STICKERS]) {
+    for (int i = 0; i < TESSERACT_STICKERS; i++) src[i] = static_cast<uint8_t>(i);
+    if (plane < 0 || plane > 5 || layer < 0 || layer > 3) return;
+    const Geometry::Move& m = Geometry::get().moves[Geometry::moveCode(plane, layer, clockwise)];
+    for (int k = 0; k < m.count; k++) src[m.dst[k]] = m.src[k];
 }
 
-// Slots to swap for each plane (0,1) or (0,2) or (0,3) or (1,2) or (1,3) or (2,3)
-static void getSlotSwap(int plane, int& s0, int& s1) {
-    switch (plane) {
-        case PLANE_XY: s0=0; s1=1; break;
-        case PLANE_XZ: s0=0; s1=2; break;
-        case PLANE_XW: s0=0; s1=3; break;
-        case PLANE_YZ: s0=1; s1=2; break;
-        case PLANE_YW: s0=1; s1=3; break;
-        case PLANE_ZW: s0=2; s1=3; break;
-        default: s0=0; s1=1; break;
+// Slice move as masked rotations: out = (in & keep) | OR_g rotl(in & mask[g], rot[g]).
+// Stickers are grouped by (dst - src) mod 64, so each move needs only 9-12 groups.
+struct SliceMasks {
+    uint64_t keep;
+    int count;
+    uint64_t mask[16];
+    int rot[16];
+};
+
+// Indexed by TesseractOp code (plane * 8 + layer * 2 + ccw)
+static const SliceMasks& sliceMasks(int code) {
+    struct Table {
+        SliceMasks moves[TESSERACT_OP_COUNT];
+        Table() {
+            for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+                uint8_t src[TESSERACT_STICKERS];
+                TesseractPuzzle::slicePermutation(m / 8, (m / 2) % 4, (m % 2) == 0, src);
+                SliceMasks& sm = moves[m];
+                sm.keep = 0;
+                sm.count = 0;
+                for (int dst = 0; dst < TESSERACT_STICKERS; dst++) {
+                    if (src[dst] == dst) { sm.keep |= uint64_t(1) << dst; continue; }
+                    int r = (dst - src[dst]) & 63;
+                    int g = 0;
+                    while (g < sm.count && sm.rot[g] != r) g++;
+                    if (g == sm.count) { sm.rot[g] = r; sm.mask[g] = 0; sm.count++; }
+                    sm.mask[g] |= uint64_t(1) << src[dst];
+                }
+            }
+        }
+    };
+    static const Table table;
+    return table.moves[code];
+}
+
+// Hot path shared by rotateSlice and apply: masked rotations on all three planes
+static inline void applySliceMasks(TesseractState& st, const SliceMasks& sm) {
+    uint64_t p0 = st.planes[0], p1 = st.planes[1], p2 = st.planes[2];
+    uint64_t r0 = p0 & sm.keep, r1 = p1 & sm.keep, r2 = p2 & sm.keep;
+    for (int g = 0; g < sm.count; g++) {
+        uint64_t m = sm.mask[g];
+        int r = sm.rot[g];
+        r0 |= rotl64(p0 & m, r);
+        r1 |= rotl64(p1 & m, r);
+        r2 |= rotl64(p2 & m, r);
     }
+    st.planes[0] = r0;
+    st.planes[1] = r1;
+    st.planes[2] = r2;
+}
+
+// Zobrist update from the bits that changed; only moved stickers can differ
+static inline void updateHash(uint64_t& hash, const TesseractState& before, const TesseractState& after) {
+    hash ^= planeHash(before.planes[0] ^ after.planes[0], before.planes[1] ^ after.planes[1],
+                      before.planes[2] ^ after.planes[2]);
+}
+
+void TesseractPuzzle::setState(const TesseractState& s) {
+    updateHash(hash_, state_, s);
+    state_ = s;
 }
 
 void TesseractPuzzle::rotateSlice(int plane, int layer, bool clockwise) {
-    int idx[4];
-    getLayerIndices(plane, layer, idx);
-    int s0, s1;
-    getSlotSwap(plane, s0, s1);
-
-    Vertex4D temp[4];
-    for (int i = 0; i < 4; i++) {
-        temp[i] = vertices_[idx[i]];
-        std::swap(temp[i].colors[s0], temp[i].colors[s1]);
-    }
-    if (clockwise) {
-        vertices_[idx[1]] = temp[0];
-        vertices_[idx[2]] = temp[1];
-        vertices_[idx[3]] = temp[2];
-        vertices_[idx[0]] = temp[3];
-    } else {
-        vertices_[idx[0]] = temp[1];
-        vertices_[idx[1]] = temp[2];
-        vertices_[idx[2]] = temp[3];
-        vertices_[idx[3]] = temp[0];
-    }
+    if (plane < 0 || plane > 5 || layer < 0 || layer > 3) return;
+    apply(makeTesseractOp(plane, layer, clockwise));
+}
+
+void TesseractPuzzle::apply(TesseractOp op) {
+    if (op.code >= TESSERACT_OP_COUNT) return;
+    TesseractState before = state_;
+    applySliceMasks(state_, sliceMasks(op.code));
+    updateHash(hash_, before, state_);
+}
+
+void TesseractPuzzle::apply(const TesseractOp* ops, size_t count) {
+    for (size_t i = 0; i < count; i++) apply(ops[i]);
+}
+
+void TesseractPuzzle::applyToState(TesseractState& s, TesseractOp op) {
+    if (op.code < TESSERACT_OP_COUNT) applySliceMasks(s, sliceMasks(op.code));
+}
+
+uint64_t TesseractPuzzle::permuteMask(uint64_t mask, TesseractOp op) {
+    const SliceMasks& sm = sliceMasks(op.code);
+    uint64_t r = mask & sm.keep;
+    for (int g = 0; g < sm.count; g++) r |= rotl64(mask & sm.mask[g], sm.rot[g]);
+    return r;
 }
 
 // Move notation: "XY0", "XY0'", "XZ1", etc. Plane name + layer (0-3) + optional '
+bool TesseractPuzzle::parseMove(const std::string& move, int& plane, int& layer, bool& clockwise) {
+    TesseractOp op;
+    if (!parseTesseractOp(move, op)) return false;
+    plane = opPlane(op);
+    layer = opLayer(op);
+    clockwise = opClockwise(op);
+    return true;
+}
+
 bool TesseractPuzzle::applyMove(const std::string& move) {
-    if (move.size() < 3) return false;
-    int plane = -1;
-    if (move[0] == 'X' && move[1] == 'Y') plane = PLANE_XY;
-    else if (move[0] == 'X' && move[1] == 'Z') plane = PLANE_XZ;
-    else if (move[0] == 'X' && move[1] == 'W') plane = PLANE_XW;
-    else if (move[0] == 'Y' && move[1] == 'Z') plane = PLANE_YZ;
-    else if (move[0] == 'Y' && move[1] == 'W') plane = PLANE_YW;
-    else if (move[0] == 'Z' && move[1] == 'W') plane = PLANE_ZW;
-    if (plane < 0) return false;
-    int layer = move[2] - '0';
-    if (layer < 0 || layer > 3) return false;
-    bool cw = true;
-    if (move.size() >= 4 && (move[3] == '\'' || move[3] == '`')) cw = false;
-    rotateSlice(plane, layer, cw);
+    TesseractOp op;
+    if (!parseTesseractOp(move, op)) return false;
+    apply(op);
     return true;
 }
 
-void TesseractPuzzle::scramble(int numMoves) {
-    static const char* planes[] = {"XY","XZ","XW","YZ","YW","ZW"};
-    std::mt19937 rng(static_cast<unsigned int>(std::time(nullptr)));
-    std::uniform_int_distribution<int> pdist(0, 5);
-    std::uniform_int_distribution<int> ldist(0, 3);
-    std::uniform_int_distribution<int> ddist(0, 1);
-    for (int i = 0; i < numMoves; i++) {
-        int pl = pdist(rng);
-        int lay = ldist(rng);
-        bool cw = ddist(rng) == 0;
-        std::string m = std::string(planes[pl]) + char('0' + lay);
-        if (!cw) m += "'";
-        applyMove(m);
-    }
+void TesseractPuzzle::scrambleMoves(uint64_t seed, uint64_t index, int numMoves, TesseractOp* out) {
+    PhiloxStream rng(seed, index);
+    for (int i = 0; i < numMoves; i++) out[i].code = static_cast<uint8_t>(rng.below(TESSERACT_OP_COUNT));
+}
+
+uint64_t TesseractPuzzle::scramble(int numMoves) {
+    uint64_t seed = freshSeed();
+    scramble(numMoves, seed);
+    return seed;
+}
+
+void TesseractPuzzle::scramble(int numMoves, uint64_t seed) {
+    PhiloxStream rng(seed, 0);
+    for (int i = 0; i < numMoves; i++) apply(TesseractOp{static_cast<uint8_t>(rng.below(TESSERACT_OP_COUNT))});
+}
+
+int TesseractPuzzle::canonicalize() {
+    TesseractState canonical;
+    int g = canonicalState(state_, canonical);
+    setState(canonical);
+    return g;
 }
 
 bool TesseractPuzzle::isSolved() const {
-    TesseractPuzzle solved;
-    for (int i = 0; i < 16; i++) {
-        for (int s = 0; s < 4; s++) {
-            if (vertices_[i].colors[s] != solved.vertices_[i].colors[s])
-                return false;
-        }
-    }
-    return true;
+    return state_ == solvedState();
 }
 
-const Vertex4D& TesseractPuzzle::getVertex(int ix, int iy, int iz, int iw) const {
-    return vertices_[vertexIndex(ix, iy, iz, iw)];
+Vertex4D TesseractPuzzle::getVertex(int ix, int iy, int iz, int iw) const {
+    int base = vertexIndex(ix, iy, iz, iw) * 4;
+    Vertex4D v;
+    for (int s = 0; s < 4; s++) v.colors[s] = state_.getColor(base + s);
+    return v;
 }
 
 void TesseractPuzzle::getAllVertices(std::vector<Vertex4D>& out) const {
     out.resize(16);
-    for (int i = 0; i < 16; i++) out[i] = vertices_[i];
+    for (int i = 0; i < 16; i++)
+        for (int s = 0; s < 4; s++)
+            out[i].colors[s] = state_.getColor(i * 4 + s);
 }
 
 bool TesseractPuzzle::isVertexInSlice(int vertexIndex, int plane, int layer) {
-    int idx[4];
-    getLayerIndices(plane, layer, idx);
-    for (int i = 0; i < 4; i++)
-        if (idx[i] == vertexIndex) return true;
-    return false;
+    return Geometry::inSlice(vertexIndex, plane, layer);
 }
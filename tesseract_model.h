@@ -6,6 +6,10 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <cstddef>
+#include "move_tokens.h"
+#include "hypercube_puzzle.h"
 
 // Cell colors: 0..7 for each of 8 cubic cells (+X,-X,+Y,-Y,+Z,-Z,+W,-W)
 enum CellColor {
@@ -34,29 +38,101 @@ struct Vertex4D {
     int colors[4];  // slots for +axis0, +axis1, +axis2, +axis3 (depends on vertex position)
 };
 
-// Tesseract puzzle state: 16 vertices, plane-based moves
-class TesseractPuzzle {
+// 64 sticker slots: sticker = vertexIndex * 4 + slot
+constexpr int TESSERACT_STICKERS = 64;
+
+// Packed puzzle state: 3-bit colors stored as three bit planes.
+// Bit p of planes[b] is bit b of the color at sticker p, so a slice move is the
+// same 64-bit permutation applied to each plane, and equality is 3 word compares.
+struct TesseractState {
+    uint64_t planes[3];
+
+    int getColor(int sticker) const {
+        return static_cast<int>(((planes[0] >> sticker) & 1u) |
+                                (((planes[1] >> sticker) & 1u) << 1) |
+                                (((planes[2] >> sticker) & 1u) << 2));
+    }
+    void setColor(int sticker, int color) {
+        for (int b = 0; b < 3; b++) {
+            uint64_t bit = uint64_t(1) << sticker;
+            planes[b] = (color >> b) & 1 ? (planes[b] | bit) : (planes[b] & ~bit);
+        }
+    }
+    bool operator==(const TesseractState& o) const {
+        return planes[0] == o.planes[0] && planes[1] == o.planes[1] && planes[2] == o.planes[2];
+    }
+    bool operator!=(const TesseractState& o) const { return !(*this == o); }
+};
+
+// Tesseract puzzle state: 16 vertices, plane-based moves. The 2^4 case of HypercubePuzzle,
+// with moves generated from HypercubeGeometry<2, 4> but state packed into bit planes
+template <>
+class HypercubePuzzle<2, 4> {
 public:
-    TesseractPuzzle();
+    typedef HypercubeGeometry<2, 4> Geometry;
+
+    HypercubePuzzle();
 
     void reset();
     void rotateSlice(int plane, int layer, bool clockwise);
     bool applyMove(const std::string& move);
-    void scramble(int numMoves = 30);
+    // Apply a pre-parsed opcode stream (see move_tokens.h); no parsing or allocation
+    void apply(const TesseractOp* ops, size_t count);
+    void apply(TesseractOp op);
+    // Random moves from Philox stream 0 of seed (see scrambleMoves); the seedless call
+    // picks a fresh seed and returns it so the scramble can be reproduced
+    uint64_t scramble(int numMoves = 30);
+    void scramble(int numMoves, uint64_t seed);
     bool isSolved() const;
 
+    // Packed state access (24 bytes); the Vertex4D accessors below decode from it
+    const TesseractState& getState() const { return state_; }
+    void setState(const TesseractState& s);
+    static const TesseractState& solvedState();
+    bool operator==(const HypercubePuzzle& o) const { return state_ == o.state_; }
+    bool operator!=(const HypercubePuzzle& o) const { return state_ != o.state_; }
+
+    // Zobrist hash: XOR of zobristKey(sticker, color) over all 64 stickers. Moves update
+    // it incrementally from the stickers whose color changed.
+    uint64_t hash() const { return hash_; }
+    static uint64_t hashState(const TesseractState& s);
+    static uint64_t zobristKey(int sticker, int color);
+
+    // Replace the state by its minimal representative under the 384 tesseract symmetries
+    // (see tesseract_symmetry.h) and return the symmetry g that was applied; a solution
+    // ops' of the new state solves the old one as conjugateOp(inverseSymmetry(g), ops').
+    // Costs about a dozen moves (see canonicalState), so not for every search node.
+    int canonicalize();
+
     // For rendering: get vertex at grid position (ix,iy,iz,iw) each in {0,1}
-    const Vertex4D& getVertex(int ix, int iy, int iz, int iw) const;
+    Vertex4D getVertex(int ix, int iy, int iz, int iw) const;
     void getAllVertices(std::vector<Vertex4D>& out) const;
 
+    // Scramble `index` of a batch: numMoves uniform opcodes drawn from Philox stream index
+    // of seed, so it depends only on (seed, index)
+    static void scrambleMoves(uint64_t seed, uint64_t index, int numMoves, TesseractOp* out);
+
+    // Parse one move token ("XY0", "ZW3'"); returns false if malformed
+    static bool parseMove(const std::string& move, int& plane, int& layer, bool& clockwise);
+
     // Check if vertex index (0..15) is in the given plane/layer (for animation)
     static bool isVertexInSlice(int vertexIndex, int plane, int layer);
 
+    // Sticker permutation of a slice move as a gather: new[dst] = old[src[dst]]
+    static void slicePermutation(int plane, int layer, bool clockwise, uint8_t src[TESSERACT_STICKERS]);
+    // Move a 64-bit sticker mask the way op moves stickers (bit p = sticker slot p)
+    static uint64_t permuteMask(uint64_t mask, TesseractOp op);
+    // Apply op to a bare state (no hash upkeep), for search loops that do not need hashes
+    static void applyToState(TesseractState& s, TesseractOp op);
+
 private:
-    Vertex4D vertices_[16];
+    TesseractState state_;
+    uint64_t hash_;
 
     int vertexIndex(int ix, int iy, int iz, int iw) const;
     void initSolved();
 };
 
+typedef HypercubePuzzle<2, 4> TesseractPuzzle;
+
 #endif // TESSERACT_MODEL_H
@@ -0,0 +1,202 @@
+// Tesseract Solver Implementation
+// Each IDA* iteration splits the tree at depth 2 into ~1700 subtree tasks that the
+// work-stealing pool spreads across cores. The lowest-numbered task that finds a
+// solution wins, so results do not depend on thread timing.
+
+#include "tesseract_solver.h"
+#include "move_simplifier.h"
+#include "bit_ops.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <mutex>
+
+namespace {
+
+const size_t NO_TASK = static_cast<size_t>(-1);
+const int MAX_PATH = 64;
+
+// Bare state: the search never reads the Zobrist hash, so it skips its upkeep
+struct Node {
+    TesseractState state;
+    uint64_t groups[HEURISTIC_GROUPS];
+};
+
+const uint64_t ALL_OPS = (uint64_t(1) << TESSERACT_OP_COUNT) - 1;
+
+// Canonical-order successors (see move_simplifier.h), and a clockwise move may only be
+// repeated once (cw cw = half turn; ccw ccw is the same half turn, cw cw cw = ccw)
+inline uint64_t successors(int last, int repeat) {
+    if (last < 0) return ALL_OPS;
+    uint64_t next = canonicalSuccessors(TesseractOp{static_cast<uint8_t>(last)});
+    return repeat > 1 ? next & ~(uint64_t(1) << last) : next;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+struct Shared {
+    const TesseractHeuristic* heuristic;
+    bool limited;
+    Clock::time_point deadline;
+    std::atomic<bool> timedOut;
+    int bound;
+    std::atomic<int> nextBound;
+    std::atomic<uint64_t> nodes;
+    std::atomic<size_t> bestTask;
+    std::mutex mutex;
+    std::vector<TesseractOp> best;
+};
+
+struct Searcher {
+    Shared& shared;
+    size_t task;
+    const TesseractOp* prefix;
+    int prefixLen;
+    uint64_t nodes;
+    int nextBound;
+    bool aborted;
+    TesseractOp path[MAX_PATH];
+
+    Searcher(Shared& s, size_t t, const TesseractOp* p, int len)
+        : shared(s), task(t), prefix(p), prefixLen(len), nodes(0), nextBound(INT_MAX), aborted(false) {}
+
+    bool dfs(const Node& n, int g, int last, int repeat) {
+        int f = g + shared.heuristic->estimate(n.groups);
+        if (f > shared.bound) {
+            if (f < nextBound) nextBound = f;
+            return false;
+        }
+        if (n.state == TesseractPuzzle::solvedState()) {
+            record(g);
+            return true;
+        }
+        if (g == shared.bound || g == MAX_PATH) {
+            if (g + 1 < nextBound) nextBound = g + 1;
+            return false;
+        }
+        // A lower-numbered task already has an optimal answer, or time is up
+        if ((nodes & 1023) == 0 && (shared.bestTask.load(std::memory_order_relaxed) < task || expired())) {
+            aborted = true;
+            return false;
+        }
+        uint64_t next = successors(last, repeat);
+        if (g < prefixLen) next &= uint64_t(1) << prefix[g].code;
+        for (; next && !aborted; next &= next - 1) {
+            int op = lowestBit(next);
+            Node child = n;
+            TesseractOp move{static_cast<uint8_t>(op)};
+            TesseractPuzzle::applyToState(child.state, move);
+            TesseractHeuristic::applyMove(child.groups, move);
+            if (g + 1 >= prefixLen) nodes++;
+            path[g] = move;
+            if (dfs(child, g + 1, op, op == last ? repeat + 1 : 1)) return true;
+        }
+        return false;
+    }
+
+    bool expired() {
+        if (shared.timedOut.load(std::memory_order_relaxed)) return true;
+        if (!shared.limited || Clock::now() < shared.deadline) return false;
+        shared.timedOut.store(true);
+        return true;
+    }
+
+    void record(int length) {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (task >= shared.bestTask.load()) return;
+        shared.best.assign(path, path + length);
+        shared.bestTask.store(task);
+    }
+};
+
+void enumeratePrefixes(int depth, std::vector<TesseractOp>& out) {
+    out.clear();
+    if (depth == 1) {
+        for (int a = 0; a < TESSERACT_OP_COUNT; a++) out.push_back(TesseractOp{static_cast<uint8_t>(a)});
+        return;
+    }
+    for (int a = 0; a < TESSERACT_OP_COUNT; a++)
+        for (uint64_t next = successors(a, 1); next; next &= next - 1) {
+            int b = lowestBit(next);
+            out.push_back(TesseractOp{static_cast<uint8_t>(a)});
+            out.push_back(TesseractOp{static_cast<uint8_t>(b)});
+        }
+}
+
+}  // namespace
+
+TesseractSolver::TesseractSolver(const SolverOptions& options)
+    : options_(options), tables_(this), heuristic_(&ownHeuristic_), pool_(options.threads) {
+    if (!options_.pdbPath.empty() && pdbFile_.open(options_.pdbPath) &&
+        ownHeuristic_.attach(pdbFile_, options_.tracked))
+        return;
+    pdbFile_.close();
+    ownHeuristic_.build(options_.tracked, &pool_);
+}
+
+TesseractSolver::TesseractSolver(const SolverOptions& options, const TesseractSolver& tables)
+    : options_(options), tables_(tables.tables_), heuristic_(tables.heuristic_), pool_(options.threads) {}
+
+bool TesseractSolver::solve(const TesseractPuzzle& start, std::vector<TesseractOp>& solution, SolveStats* stats) {
+    auto t0 = Clock::now();
+    solution.clear();
+    SolveStats local;
+
+    Node root;
+    root.state = start.getState();
+    heuristic_->initGroups(start.getState(), root.groups);
+
+    bool found = start.isSolved();
+    int bound = heuristic_->estimate(root.groups);
+    if (bound == 0 && !found) bound = 1;
+    int maxDepth = options_.maxDepth < MAX_PATH ? options_.maxDepth : MAX_PATH;
+
+    Shared shared;
+    shared.heuristic = heuristic_;
+    shared.limited = options_.timeLimit > 0.0;
+    shared.deadline = t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options_.timeLimit));
+    shared.timedOut.store(false);
+    shared.nodes.store(0);
+    std::vector<TesseractOp> prefixes;
+    while (!found && bound <= maxDepth) {
+        int prefixLen = bound < 2 ? bound : 2;
+        enumeratePrefixes(prefixLen, prefixes);
+        shared.bound = bound;
+        shared.nextBound.store(INT_MAX);
+        shared.bestTask.store(NO_TASK);
+        shared.best.clear();
+        std::atomic<uint64_t>& nodeCount = shared.nodes;
+        pool_.run(prefixes.size() / prefixLen, [&](size_t task, int) {
+            Searcher s(shared, task, &prefixes[task * prefixLen], prefixLen);
+            s.dfs(root, 0, -1, 0);
+            nodeCount.fetch_add(s.nodes, std::memory_order_relaxed);
+            int nb = shared.nextBound.load();
+            while (s.nextBound < nb && !shared.nextBound.compare_exchange_weak(nb, s.nextBound)) {}
+        });
+        local.iterations++;
+        // Every shorter bound was exhausted, so even a timed-out iteration's answer is optimal
+        if (shared.bestTask.load() != NO_TASK) {
+            solution = shared.best;
+            found = true;
+            break;
+        }
+        if (shared.timedOut.load()) break;
+        if (shared.nextBound.load() == INT_MAX) break;
+        bound = shared.nextBound.load();
+    }
+
+    local.nodes = shared.nodes.load();
+    local.depth = found ? static_cast<int>(solution.size()) : bound;
+    local.timedOut = shared.timedOut.load();
+    local.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    local.nodesPerSecond = local.seconds > 0.0 ? static_cast<double>(local.nodes) / local.seconds : 0.0;
+    if (stats) *stats = local;
+    return found;
+}
+
+bool TesseractSolver::solve(const TesseractPuzzle& start, std::string& solution, SolveStats* stats) {
+    std::vector<TesseractOp> ops;
+    bool ok = solve(start, ops, stats);
+    solution = formatMoves(ops.data(), ops.size());
+    return ok;
+}
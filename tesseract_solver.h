@@ -0,0 +1,59 @@
+// Tesseract Solver
+// Parallel IDA* over the 48 slice moves with pattern-database lower bounds
+
+#ifndef TESSERACT_SOLVER_H
+#define TESSERACT_SOLVER_H
+
+#include "tesseract_model.h"
+#include "pattern_db.h"
+#include "work_stealing_pool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SolverOptions {
+    int maxDepth;  // give up when the bound passes this many moves
+    int threads;   // worker threads; 0 = all cores
+    int tracked;   // stickers per pattern-database group (C(64, tracked) entries per color)
+    std::string pdbPath;  // pdb_build output to map instead of building tables; "" = build
+    double timeLimit;     // seconds before solve() gives up; 0 = no limit
+    SolverOptions() : maxDepth(14), threads(0), tracked(4), timeLimit(0.0) {}
+};
+
+struct SolveStats {
+    uint64_t nodes;         // nodes generated over all iterations
+    double seconds;
+    double nodesPerSecond;
+    int depth;              // solution length, or last bound searched on failure
+    int iterations;
+    bool timedOut;          // stopped by SolverOptions::timeLimit
+    SolveStats() : nodes(0), seconds(0.0), nodesPerSecond(0.0), depth(0), iterations(0), timedOut(false) {}
+};
+
+class TesseractSolver {
+public:
+    explicit TesseractSolver(const SolverOptions& options = SolverOptions());
+    // Search with the pattern databases of tables, which must outlive this solver
+    // (one solver per thread for batch solving; options.pdbPath / tracked are ignored)
+    TesseractSolver(const SolverOptions& options, const TesseractSolver& tables);
+
+    // Optimal (shortest) solution in slice moves; false if none within maxDepth
+    bool solve(const TesseractPuzzle& start, std::vector<TesseractOp>& solution, SolveStats* stats = nullptr);
+    // Same, formatted in the existing notation ("XY0 ZW1' ...")
+    bool solve(const TesseractPuzzle& start, std::string& solution, SolveStats* stats = nullptr);
+
+    const TesseractHeuristic& heuristic() const { return *heuristic_; }
+    int threads() const { return pool_.size(); }
+    // True when the tables came from options.pdbPath rather than a fresh build
+    bool mappedTables() const { return tables_->pdbFile_.isOpen(); }
+
+private:
+    SolverOptions options_;
+    const TesseractSolver* tables_;  // this, or the solver passed as tables
+    const TesseractHeuristic* heuristic_;
+    TesseractHeuristic ownHeuristic_;
+    WorkStealingPool pool_;
+    PdbFile pdbFile_;
+};
+
+#endif // TESSERACT_SOLVER_H
@@ -0,0 +1,181 @@
+// Tesseract Symmetry Implementation
+
+#include "tesseract_symmetry.h"
+#include <algorithm>
+#include <cstring>
+
+// Sticker p = vertex * 4 + slot, vertex = ix*8 + iy*4 + iz*2 + iw, so axis a is vertex bit 3 - a.
+// Color c = 2 * axis + (0 for the + cell, 1 for the - cell).
+struct SymmetryTables {
+    uint8_t sticker[TESSERACT_SYMMETRIES][TESSERACT_STICKERS];  // p -> g(p)
+    uint8_t source[TESSERACT_SYMMETRIES][TESSERACT_STICKERS];   // q -> g^-1(q)
+    uint8_t sourceAt[TESSERACT_STICKERS][TESSERACT_SYMMETRIES]; // the same by position, for canonicalState
+    // The 6 symmetries taking sticker p to position 0, and the smallest color they give it
+    uint16_t toFirst[TESSERACT_STICKERS][6];
+    uint8_t firstMin[TESSERACT_STICKERS][8];
+    uint64_t spread[256];  // bit i -> bit 0 of byte i
+    uint8_t color[TESSERACT_SYMMETRIES][8];
+    uint16_t inverse[TESSERACT_SYMMETRIES];
+    uint8_t conjugate[TESSERACT_SYMMETRIES][TESSERACT_OP_COUNT];
+
+    SymmetryTables() {
+        for (int b = 0; b < 256; b++) {
+            spread[b] = 0;
+            for (int i = 0; i < 8; i++) spread[b] |= static_cast<uint64_t>((b >> i) & 1) << (8 * i);
+        }
+        int perms[24][4];
+        int p[4] = {0, 1, 2, 3};
+        for (int i = 0; i < 24; i++) {
+            std::copy(p, p + 4, perms[i]);
+            std::next_permutation(p, p + 4);
+        }
+        for (int g = 0; g < TESSERACT_SYMMETRIES; g++) {
+            const int* perm = perms[g / 16];
+            int flips = g % 16;
+            for (int v = 0; v < 16; v++) {
+                int w = 0;
+                for (int a = 0; a < 4; a++) {
+                    int bit = ((v >> (3 - a)) & 1) ^ ((flips >> a) & 1);
+                    w |= bit << (3 - perm[a]);
+                }
+                for (int a = 0; a < 4; a++) {
+                    int to = w * 4 + perm[a];
+                    sticker[g][v * 4 + a] = static_cast<uint8_t>(to);
+                    source[g][to] = static_cast<uint8_t>(v * 4 + a);
+                    sourceAt[to][g] = static_cast<uint8_t>(v * 4 + a);
+                }
+            }
+            for (int c = 0; c < 8; c++)
+                color[g][c] = static_cast<uint8_t>(2 * perm[c / 2] + ((c & 1) ^ ((flips >> (c / 2)) & 1)));
+        }
+        int found[TESSERACT_STICKERS] = {0};
+        for (int g = 0; g < TESSERACT_SYMMETRIES; g++) {
+            int p = source[g][0];
+            toFirst[p][found[p]++] = static_cast<uint16_t>(g);
+        }
+        for (int p = 0; p < TESSERACT_STICKERS; p++)
+            for (int c = 0; c < 8; c++) {
+                firstMin[p][c] = 8;
+                for (int k = 0; k < 6; k++) firstMin[p][c] = std::min(firstMin[p][c], color[toFirst[p][k]][c]);
+            }
+        for (int g = 0; g < TESSERACT_SYMMETRIES; g++)
+            for (int h = 0; h < TESSERACT_SYMMETRIES; h++)
+                if (std::equal(sticker[h], sticker[h] + TESSERACT_STICKERS, source[g])) {
+                    inverse[g] = static_cast<uint16_t>(h);
+                    break;
+                }
+
+        // op' gathers src'[g(p)] = g(src[p]); match it against the 48 slice permutations
+        uint8_t moves[TESSERACT_OP_COUNT][TESSERACT_STICKERS];
+        for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+            TesseractOp op{static_cast<uint8_t>(m)};
+            TesseractPuzzle::slicePermutation(opPlane(op), opLayer(op), opClockwise(op), moves[m]);
+        }
+        for (int g = 0; g < TESSERACT_SYMMETRIES; g++)
+            for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+                uint8_t conj[TESSERACT_STICKERS];
+                for (int q = 0; q < TESSERACT_STICKERS; q++)
+                    conj[sticker[g][q]] = sticker[g][moves[m][q]];
+                conjugate[g][m] = 0xFF;
+                for (int k = 0; k < TESSERACT_OP_COUNT; k++)
+                    if (std::equal(conj, conj + TESSERACT_STICKERS, moves[k])) {
+                        conjugate[g][m] = static_cast<uint8_t>(k);
+                        break;
+                    }
+            }
+    }
+};
+
+static const SymmetryTables& symmetryTables() {
+    static const SymmetryTables tables;
+    return tables;
+}
+
+// One color byte per sticker, 8 stickers per step
+static void unpackColors(const SymmetryTables& t, const TesseractState& s, uint8_t colors[TESSERACT_STICKERS]) {
+    for (int j = 0; j < 8; j++) {
+        uint64_t w = t.spread[(s.planes[0] >> (8 * j)) & 0xFF] | t.spread[(s.planes[1] >> (8 * j)) & 0xFF] << 1 |
+                     t.spread[(s.planes[2] >> (8 * j)) & 0xFF] << 2;
+        std::memcpy(colors + 8 * j, &w, 8);
+    }
+}
+
+static void packColors(const uint8_t colors[TESSERACT_STICKERS], TesseractState& s) {
+    s.planes[0] = s.planes[1] = s.planes[2] = 0;
+    for (int j = 0; j < 8; j++) {
+        uint64_t w;
+        std::memcpy(&w, colors + 8 * j, 8);
+        // Bit 0 of each byte, gathered into the top byte by one multiply
+        for (int b = 0; b < 3; b++)
+            s.planes[b] |= ((((w >> b) & 0x0101010101010101ull) * 0x0102040810204080ull) >> 56) << (8 * j);
+    }
+}
+
+int symmetrySticker(int g, int sticker) {
+    return symmetryTables().sticker[g][sticker];
+}
+
+int symmetryColor(int g, int color) {
+    return symmetryTables().color[g][color];
+}
+
+int inverseSymmetry(int g) {
+    return symmetryTables().inverse[g];
+}
+
+TesseractOp conjugateOp(int g, TesseractOp op) {
+    return TesseractOp{symmetryTables().conjugate[g][op.code]};
+}
+
+void applySymmetry(int g, const TesseractState& in, TesseractState& out) {
+    const SymmetryTables& t = symmetryTables();
+    uint8_t colors[TESSERACT_STICKERS], image[TESSERACT_STICKERS];
+    unpackColors(t, in, colors);
+    for (int q = 0; q < TESSERACT_STICKERS; q++) image[q] = t.color[g][colors[t.source[g][q]]];
+    packColors(image, out);
+}
+
+int canonicalState(const TesseractState& in, TesseractState& out) {
+    const SymmetryTables& t = symmetryTables();
+    uint8_t colors[TESSERACT_STICKERS];
+    unpackColors(t, in, colors);
+
+    // Keep the symmetries whose image is smallest so far, one sticker at a time. Position 0
+    // comes from precomputed minima over the 6 symmetries per source sticker (64 lookups
+    // instead of 384); each later pass reads its position's sources for all candidates
+    // from one contiguous row and compacts the survivors without data-dependent branches.
+    uint16_t cand[TESSERACT_SYMMETRIES];
+    uint8_t image[TESSERACT_SYMMETRIES];
+    uint8_t best = 8;
+    for (int p = 0; p < TESSERACT_STICKERS; p++) best = std::min(best, t.firstMin[p][colors[p]]);
+    int n = 0;
+    for (int p = 0; p < TESSERACT_STICKERS; p++) {
+        if (t.firstMin[p][colors[p]] != best) continue;
+        for (int k = 0; k < 6; k++) {
+            int g = t.toFirst[p][k];
+            cand[n] = static_cast<uint16_t>(g);
+            n += t.color[g][colors[p]] == best;
+        }
+    }
+    for (int q = 1; q < TESSERACT_STICKERS && n > 1; q++) {
+        const uint8_t* src = t.sourceAt[q];
+        best = 8;
+        for (int i = 0; i < n; i++) {
+            int g = cand[i];
+            image[i] = t.color[g][colors[src[g]]];
+            best = std::min(best, image[i]);
+        }
+        int kept = 0;
+        for (int i = 0; i < n; i++) {
+            cand[kept] = cand[i];
+            kept += image[i] == best;
+        }
+        n = kept;
+    }
+    // Any survivors left all give the same image (in is symmetric); take the lowest g
+    int g = *std::min_element(cand, cand + n);
+    uint8_t result[TESSERACT_STICKERS];
+    for (int q = 0; q < TESSERACT_STICKERS; q++) result[q] = t.color[g][colors[t.source[g][q]]];
+    packColors(result, out);
+    return g;
+}
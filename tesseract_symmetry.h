@@ -0,0 +1,38 @@
+// Tesseract Symmetry
+// The 384 spatial symmetries of the tesseract (signed axis permutations, the
+// hyperoctahedral group B4) acting on TesseractState, with the matching color relabelling
+
+#ifndef TESSERACT_SYMMETRY_H
+#define TESSERACT_SYMMETRY_H
+
+#include "tesseract_model.h"
+#include <cstdint>
+
+// Symmetry g = perm * 16 + flips: axis a goes to axis perms[perm][a] and is mirrored when
+// bit a of flips is set; g = 0 is the identity. Sticker (vertex, slot) moves with its
+// vertex and its color is relabelled to the cell it now faces, so g maps the solved state
+// to itself and conjugates slice moves to slice moves: distances to solved are invariant.
+constexpr int TESSERACT_SYMMETRIES = 384;
+
+// Position of sticker p after g, and the relabelled color
+int symmetrySticker(int g, int sticker);
+int symmetryColor(int g, int color);
+int inverseSymmetry(int g);
+
+// out = g applied to in (out may not alias in)
+void applySymmetry(int g, const TesseractState& in, TesseractState& out);
+
+// The slice move op' with g(op(s)) == op'(g(s)), from a precomputed 384 x 48 table
+TesseractOp conjugateOp(int g, TesseractOp op);
+
+// Minimal representative of in's symmetry class: the image whose color sequence
+// (sticker 0 first) is lexicographically smallest. Returns the g with out = g(in).
+// Candidates are filtered sticker by sticker, so typically only a few symmetries are
+// followed past the first couple of stickers. It costs about a dozen slice moves
+// (tesseract.canonicalize in bench_tesseract): fine for states that are stored (visited
+// sets, results, deduplicating batches), too slow for every search node. Reduced
+// enumeration uses SymmetricStickerSetSpace (state_enumerator.h) instead, whose canonical
+// form maps only the tracked stickers.
+int canonicalState(const TesseractState& in, TesseractState& out);
+
+#endif // TESSERACT_SYMMETRY_H
@@ -2,9 +2,35 @@
 // Run: build/Release/test_tesseract.exe
 
 #include "tesseract_model.h"
+#include "move_compiler.h"
+#include "move_tokens.h"
+#include "rubik_cube.h"
+#include "tesseract_solver.h"
 #include "math_4d.h"
+#include "math_nd.h"
+#include "rotor_4d.h"
 #include "projection_4d.h"
+#include "pattern_db.h"
+#include "pdb_file.h"
+#include "state_enumerator.h"
+#include "transposition_table.h"
+#include "tesseract_symmetry.h"
+#include "scramble_generator.h"
+#include "philox.h"
+#include "tesseract_batch.h"
+#include "move_journal.h"
+#include "move_simplifier.h"
+#include "move_log.h"
+#include "cubie_cube.h"
+#include "kociemba_solver.h"
+#include "solve_pipeline.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 
 static int tests_run = 0;
@@ -47,6 +73,806 @@ void test_four_moves_identity() {
     else FAIL("4× XY0 CW should be identity");
 }
 
+void test_packed_moves_match_permutation() {
+    TEST("Packed slice moves match sticker permutation");
+    TesseractPuzzle p;
+    p.scramble(20);
+    bool ok = true;
+    for (int m = 0; m < 48 && ok; m++) {
+        int plane = m / 8, layer = (m / 2) % 4;
+        bool cw = (m % 2) == 0;
+        uint8_t src[TESSERACT_STICKERS];
+        TesseractPuzzle::slicePermutation(plane, layer, cw, src);
+        TesseractPuzzle q = p;
+        q.rotateSlice(plane, layer, cw);
+        for (int i = 0; i < TESSERACT_STICKERS; i++)
+            if (q.getState().getColor(i) != p.getState().getColor(src[i])) ok = false;
+    }
+    if (ok) PASS();
+    else FAIL("rotateSlice should equal the gather new[i] = old[src[i]]");
+}
+
+void test_packed_color_counts() {
+    TEST("Every color keeps 8 stickers");
+    TesseractPuzzle p;
+    for (int m = 0; m < 48; m++) p.rotateSlice(m / 8, (m / 2) % 4, (m % 2) == 0);
+    int counts[8] = {0};
+    std::vector<Vertex4D> verts;
+    p.getAllVertices(verts);
+    for (const Vertex4D& v : verts)
+        for (int s = 0; s < 4; s++)
+            if (v.colors[s] >= 0 && v.colors[s] < 8) counts[v.colors[s]]++;
+    bool ok = true;
+    for (int c = 0; c < 8; c++) if (counts[c] != 8) ok = false;
+    if (ok) PASS();
+    else FAIL("slice moves should permute stickers, not create or drop colors");
+}
+
+void test_hypercube_puzzle() {
+    TEST("3^4 and 4^4 hypercube moves are invertible permutations of order 4");
+    typedef Tesseract3Puzzle::Geometry G3;
+    bool ok = G3::STICKERS == 216 && G3::MOVES == 108 && Tesseract4Puzzle::STICKERS == 512 &&
+              TesseractPuzzle::Geometry::MOVES == TESSERACT_OP_COUNT;
+    Tesseract3Puzzle p;
+    p.scramble(25, 11);
+    ok = ok && !p.isSolved();
+    for (int m = 0; m < G3::MOVES; m++) {
+        Tesseract3Puzzle q = p;
+        q.apply(m);
+        ok = ok && q != p;
+        q.apply(m ^ 1);
+        ok = ok && q == p;
+        for (int i = 0; i < 4; i++) q.apply(m);
+        ok = ok && q == p;
+    }
+    int counts[8] = {0};
+    for (int i = 0; i < G3::STICKERS; i++) counts[p.getColor(i)]++;
+    for (int c = 0; c < 8; c++) ok = ok && counts[c] == 27;
+    // Undo the scramble from its Philox moves
+    int moves[25];
+    PhiloxStream rng(11, 0);
+    for (int i = 0; i < 25; i++) moves[i] = static_cast<int>(rng.below(G3::MOVES));
+    for (int i = 24; i >= 0; i--) p.apply(moves[i] ^ 1);
+    ok = ok && p.isSolved();
+    Tesseract4Puzzle big;
+    big.rotateSlice(PLANE_YW, 5, true);
+    ok = ok && !big.isSolved();
+    big.rotateSlice(PLANE_YW, 5, false);
+    ok = ok && big.isSolved();
+    if (ok) PASS(); else FAIL("hypercube move tables are not a consistent permutation");
+}
+
+void test_compiled_sequence() {
+    TEST("Compiled sequence equals move-by-move");
+    const char* seq = "XY0 ZW1' XW3 YW3 YZ2' XZ1";
+    StickerPermutation perm;
+    bool ok = StickerPermutation::compile(seq, perm);
+    TesseractPuzzle a, b;
+    a.applyMove("XY0"); a.applyMove("ZW1'"); a.applyMove("XW3");
+    a.applyMove("YW3"); a.applyMove("YZ2'"); a.applyMove("XZ1");
+    perm.apply(b);
+    ok = ok && a == b;
+    perm.inverse().apply(b);
+    ok = ok && b.isSolved();
+    ok = ok && !StickerPermutation::compile("XY0 QQ1", perm);
+    if (ok) PASS();
+    else FAIL("compiled permutation should match sequential applyMove");
+}
+
+void test_permutation_order() {
+    TEST("Permutation order and powers");
+    StickerPermutation m = StickerPermutation::fromSlice(PLANE_XY, 0, true);
+    StickerPermutation seq;
+    StickerPermutation::compile("XY0 ZW1", seq);
+    bool ok = m.order() == 4 && m.power(4).isIdentity() && m.power(-1) == m.inverse();
+    ok = ok && seq.power(static_cast<long long>(seq.order())).isIdentity();
+    ok = ok && seq.power(3) == seq.then(seq).then(seq);
+    if (ok) PASS();
+    else FAIL("order should come from the cycle decomposition");
+}
+
+void test_tokenizer_opcodes() {
+    TEST("Tokenizer opcode stream matches applyMove");
+    TesseractOp ops[8];
+    size_t count = 0, consumed = 0;
+    bool ok = parseTesseractMoves("XY0  ZW1',XW3\tYW2`", ops, 8, count, consumed) && count == 4;
+    TesseractPuzzle a, b;
+    a.apply(ops, count);
+    b.applyMove("XY0"); b.applyMove("ZW1'"); b.applyMove("XW3"); b.applyMove("YW2'");
+    ok = ok && a == b && formatMoves(ops, count) == "XY0 ZW1' XW3 YW2'";
+    ok = ok && !parseTesseractMoves("XY0 XY4", ops, 8, count, consumed) && count == 1 && consumed == 4;
+    ok = ok && parseTesseractMoves("XY0 XY1 XY2", ops, 2, count, consumed) && count == 2 && consumed == 8;
+    RubikOp rops[8];
+    ok = ok && parseRubikMoves("R U' F2 B", rops, 8, count, consumed) && count == 4;
+    RubikCube c, d;
+    c.apply(rops, count);
+    d.applyMove("R"); d.applyMove("U'"); d.applyMove("F"); d.applyMove("F"); d.applyMove("B");
+    ok = ok && c == d && !parseRubikOp("R3", rops[0]);
+    if (ok) PASS();
+    else FAIL("parsed opcodes should replay the same moves as the text API");
+}
+
+void test_rubik_table_moves() {
+    TEST("Rubik table moves: prime and half turns match repeated quarter turns");
+    RubikCube base;
+    base.scramble(25, 3);
+    bool ok = true;
+    for (int face = 0; face < 6; face++) {
+        RubikCube cw = base, prime = base, half = base;
+        for (int k = 0; k < 3; k++) cw.apply(makeRubikOp(face, 0));
+        prime.apply(makeRubikOp(face, 1));
+        half.apply(makeRubikOp(face, 2));
+        ok = ok && cw == prime && cw.hash() == prime.hash() && prime.hash() == prime.computeHash();
+        cw.apply(makeRubikOp(face, 1));
+        ok = ok && cw == half && half.hash() == half.computeHash();
+    }
+    RubikFacesView faces = base.getFaces();
+    for (int f = 0; f < RUBIK_FACELETS; f++)
+        ok = ok && faces[f / 9][(f / 3) % 3][f % 3] == base.getColor(f / 9, (f / 3) % 3, f % 3) &&
+             base.facelets()[f] == faces[f / 9][(f / 3) % 3][f % 3];
+    if (ok) PASS(); else FAIL("table-driven turns disagree");
+}
+
+void test_zobrist_incremental() {
+    TEST("Incremental Zobrist hash matches full rehash");
+    TesseractPuzzle p;
+    uint64_t solvedHash = p.hash();
+    bool ok = solvedHash == TesseractPuzzle::hashState(p.getState());
+    const char* moves[] = {"XY0", "ZW1'", "XW3", "YW2", "YZ1", "XZ0'"};
+    for (const char* m : moves) {
+        p.applyMove(m);
+        if (p.hash() != TesseractPuzzle::hashState(p.getState())) ok = false;
+    }
+    ok = ok && p.hash() != solvedHash;
+    StickerPermutation inverse;
+    ok = ok && StickerPermutation::compile("XY0 ZW1' XW3 YW2 YZ1 XZ0'", inverse);
+    inverse.inverse().apply(p);
+    ok = ok && p.isSolved() && p.hash() == solvedHash;
+
+    RubikCube c;
+    uint64_t cubeSolved = c.hash();
+    c.applyMove("R"); c.applyMove("U'"); c.applyMove("F2"); c.applyMove("B");
+    ok = ok && c.hash() == c.computeHash() && c.hash() != cubeSolved;
+    c.applyMove("B'"); c.applyMove("F2"); c.applyMove("U"); c.applyMove("R'");
+    ok = ok && c.isSolved() && c.hash() == cubeSolved;
+    if (ok) PASS();
+    else FAIL("hash drifted from the state");
+}
+
+void test_transposition_table() {
+    TEST("Transposition table store/probe/replace");
+    TranspositionTable tt(1);
+    TTEntry e = {7, 3, 12, 1}, out = {0, 0, 0, 0};
+    tt.store(0x1234, e);
+    bool ok = tt.probe(0x1234, out) && out.value == 7 && out.depth == 3 && out.move == 12 && !tt.probe(0x4321, out);
+    // Fill one bucket past capacity: the shallowest entry goes first
+    size_t buckets = tt.capacity() / 4;
+    for (uint64_t i = 1; i <= 5; i++) tt.store(0x99 + i * buckets, TTEntry{0, static_cast<uint8_t>(i), 0, 0});
+    ok = ok && !tt.probe(0x99 + 1 * buckets, out) && tt.probe(0x99 + 5 * buckets, out) && out.depth == 5;
+    // Concurrent writers never produce a mismatched entry
+    WorkStealingPool pool(2);
+    std::atomic<int> bad(0);
+    pool.run(64, [&](size_t task, int) {
+        TTEntry mine, seen;
+        for (uint64_t k = 0; k < 2000; k++) {
+            uint64_t key = (k * 0x9E3779B97F4A7C15ull) | 1;
+            mine.value = static_cast<int16_t>(key & 0x7FFF);
+            mine.depth = static_cast<uint8_t>(task);
+            mine.move = static_cast<uint8_t>(key >> 8);
+            mine.flags = 0;
+            tt.store(key, mine);
+            if (tt.probe(key, seen) && (seen.value != mine.value || seen.move != mine.move)) bad++;
+        }
+    });
+    ok = ok && bad.load() == 0 && tt.usage() > 0;
+    if (ok) PASS();
+    else FAIL("table returned wrong or torn entries");
+}
+
+void test_symmetry_canonical() {
+    TEST("Symmetries conjugate moves and canonicalize consistently");
+    TesseractState image;
+    bool ok = true;
+    for (int g = 0; g < TESSERACT_SYMMETRIES && ok; g++) {
+        applySymmetry(g, TesseractPuzzle::solvedState(), image);
+        ok = image == TesseractPuzzle::solvedState() && inverseSymmetry(inverseSymmetry(g)) == g;
+        for (int m = 0; m < TESSERACT_OP_COUNT; m++)
+            if (conjugateOp(g, TesseractOp{static_cast<uint8_t>(m)}).code >= TESSERACT_OP_COUNT) ok = false;
+    }
+    TesseractPuzzle p;
+    p.applyMove("XY0"); p.applyMove("ZW1'"); p.applyMove("XW3"); p.applyMove("YZ2");
+    TesseractPuzzle canonical = p;
+    int g = canonical.canonicalize();
+    TesseractState mapped;
+    applySymmetry(g, p.getState(), mapped);
+    ok = ok && mapped == canonical.getState() && canonical.hash() == TesseractPuzzle::hashState(mapped);
+    for (int h = 1; h < TESSERACT_SYMMETRIES; h += 7) {
+        // Every image has the same canonical form, and it is the smallest image
+        TesseractState other, otherCanonical;
+        applySymmetry(h, p.getState(), other);
+        canonicalState(other, otherCanonical);
+        if (otherCanonical != canonical.getState()) ok = false;
+        for (int i = 0; i < TESSERACT_STICKERS; i++) {
+            if (other.getColor(i) == mapped.getColor(i)) continue;
+            if (other.getColor(i) < mapped.getColor(i)) ok = false;
+            break;
+        }
+        // g(op(s)) == conj(op)(g(s))
+        TesseractOp op{static_cast<uint8_t>(h % TESSERACT_OP_COUNT)};
+        TesseractPuzzle moved = p;
+        moved.apply(op);
+        TesseractState lhs;
+        applySymmetry(h, moved.getState(), lhs);
+        TesseractPuzzle::applyToState(other, conjugateOp(h, op));
+        if (lhs != other) ok = false;
+    }
+    // Undo the scramble on the canonical state, then map the moves back
+    const char* undo[] = {"YZ2'", "XW3'", "ZW1", "XY0'"};
+    for (const char* m : undo) {
+        TesseractOp op;
+        parseTesseractOp(m, op);
+        canonical.apply(conjugateOp(g, op));
+    }
+    ok = ok && canonical.isSolved();
+    if (ok) PASS();
+    else FAIL("symmetry tables are inconsistent");
+}
+
+void test_seeded_scrambles() {
+    TEST("Seeded scrambles are reproducible and order-independent");
+    // Philox4x32-10 known-answer test (Random123 kat_vectors: counter 0, key 0)
+    uint32_t counter[4] = {0, 0, 0, 0}, key[2] = {0, 0}, out[4];
+    philox4x32(counter, key, out);
+    bool ok = out[0] == 0x6627e8d5u && out[1] == 0xe169c58du && out[2] == 0xbc57ac4cu && out[3] == 0x9b00dbd8u;
+
+    TesseractPuzzle a, b;
+    a.scramble(30, 1234);
+    b.scramble(30, 1234);
+    ok = ok && a == b && !a.isSolved();
+    b.reset();
+    b.scramble(30, 1235);
+    ok = ok && a != b;
+    b.reset();
+    uint64_t seed = b.scramble();
+    TesseractPuzzle c;
+    c.scramble(30, seed);
+    ok = ok && c == b;
+
+    // Batch output: same bytes with 1 or 2 threads, and scramble k matches scrambleMoves
+    ScrambleBatch batch;
+    batch.seed = 99;
+    batch.first = 5;
+    batch.count = 20000;
+    batch.format = SCRAMBLE_BINARY;
+    std::string files[2] = {"test_scrambles_1.tmp", "test_scrambles_2.tmp"};
+    std::vector<uint8_t> data[2];
+    for (int t = 0; t < 2; t++) {
+        WorkStealingPool pool(t + 1);
+        FILE* f = std::fopen(files[t].c_str(), "wb");
+        ok = ok && f && writeScrambles(f, batch, pool);
+        if (f) std::fclose(f);
+        f = std::fopen(files[t].c_str(), "rb");
+        if (!f) { ok = false; continue; }
+        int ch;
+        while ((ch = std::fgetc(f)) != EOF) data[t].push_back(static_cast<uint8_t>(ch));
+        std::fclose(f);
+        std::remove(files[t].c_str());
+    }
+    ScrambleFileHeader header;
+    ok = ok && data[0] == data[1] && data[0].size() == sizeof(header) + batch.count * batch.length;
+    if (ok) {
+        std::memcpy(&header, data[0].data(), sizeof(header));
+        TesseractOp moves[30];
+        TesseractPuzzle::scrambleMoves(99, 5 + 12345, 30, moves);
+        ok = checkScrambleHeader(header) && header.first == 5 &&
+             std::memcmp(moves, data[0].data() + sizeof(header) + 12345 * 30, 30) == 0;
+    }
+    if (ok) PASS();
+    else FAIL("scrambles depend on more than (seed, index)");
+}
+
+void test_batch_engine() {
+    TEST("Batch moves and isSolved mask match single puzzles");
+    const size_t n = 100;  // not a multiple of the lane count
+    TesseractBatch batch(n);
+    std::vector<TesseractPuzzle> single(n);
+    for (size_t i = 0; i < n; i += 3) {
+        single[i].scramble(static_cast<int>(i % 7), 500 + i);
+        batch.set(i, single[i]);
+    }
+    std::vector<uint64_t> mask;
+    batch.isSolved(mask);
+    size_t solved = 0;
+    bool ok = mask.size() == 2;
+    for (size_t i = 0; i < n; i++) {
+        solved += single[i].isSolved() ? 1 : 0;
+        if (((mask[i / 64] >> (i % 64)) & 1) != (single[i].isSolved() ? 1u : 0u)) ok = false;
+    }
+    ok = ok && batch.countSolved() == solved && solved < n;
+    TesseractOp ops[4];
+    parseTesseractOp("XY0", ops[0]); parseTesseractOp("ZW1'", ops[1]);
+    parseTesseractOp("YW3", ops[2]); parseTesseractOp("XZ2", ops[3]);
+    batch.apply(ops, 4);
+    batch.rotateSlice(PLANE_XW, 1, false);
+    for (size_t i = 0; i < n; i++) {
+        single[i].apply(ops, 4);
+        single[i].rotateSlice(PLANE_XW, 1, false);
+        if (batch.get(i) != single[i]) ok = false;
+    }
+    batch.isSolved(mask);
+    ok = ok && mask[0] == 0 && mask[1] == 0;
+    batch.reset();
+    ok = ok && batch.countSolved() == n;
+    // Shrinking then growing again must not bring back the dropped puzzles
+    batch.apply(ops[0]);
+    batch.resize(5);
+    batch.resize(n);
+    ok = ok && batch.countSolved() == n - 5 && batch.get(7).isSolved() && !batch.get(4).isSolved();
+    if (ok) PASS();
+    else FAIL(std::string("batch diverged on the ") + TesseractBatch::simdPath() + " path");
+}
+
+void test_pattern_db_rank() {
+    TEST("Pattern database rank/unrank round trip");
+    bool ok = true;
+    for (uint64_t r = 0; r < TesseractPatternDb::binomial(TESSERACT_STICKERS, 3); r += 97)
+        if (TesseractPatternDb::rank(TesseractPatternDb::unrank(r, 3)) != r) ok = false;
+    TesseractPatternDb db;
+    db.build(C_W_POS, 2);
+    uint64_t home = TesseractPatternDb::homeMask(C_W_POS);
+    uint64_t rest = home & (home - 1);
+    uint64_t two = (home ^ rest) | (rest & (0 - rest));  // lowest two home cells
+    ok = ok && db.lookup(two) == 0 && db.maxDistance() > 0;
+    if (ok) PASS();
+    else FAIL("colex rank should invert unrank");
+}
+
+void test_pdb_file_round_trip() {
+    TEST("Parallel PDB build, file write and mmap attach");
+    TesseractPatternDb serial, parallel;
+    serial.build(C_X_NEG, 2);
+    WorkStealingPool pool(2);
+    parallel.build(C_X_NEG, 2, &pool);
+    const DistanceTable& a = serial.table();
+    const DistanceTable& b = parallel.table();
+    bool ok = a.size() == b.size() && std::equal(a.data(), a.data() + a.bytes(), b.data());
+
+    RubikPatternDb corners;
+    corners.build(RUBIK_CORNER_PIECES, 0x3);
+    std::vector<PdbTableSource> sources;
+    sources.push_back(parallel.source());
+    sources.push_back(corners.source());
+    const std::string path = "test_tesseract_pdb.tmp";
+    ok = ok && writePdbFile(path, sources);
+
+    PdbFile file;
+    TesseractPatternDb mapped;
+    RubikPatternDb mappedCorners;
+    ok = ok && file.open(path) && file.verify() && file.tableCount() == 2;
+    ok = ok && mapped.attach(file, C_X_NEG, 2) && !mapped.attach(file, C_X_NEG, 3);
+    ok = ok && mappedCorners.attach(file, RUBIK_CORNER_PIECES, 0x3);
+    for (uint64_t r = 0; ok && r < a.size(); r++)
+        if (mapped.table().get(r) != a.get(r)) ok = false;
+    ok = ok && mapped.maxDistance() == serial.maxDistance();
+    ok = ok && mappedCorners.table().bytes() == corners.table().bytes();
+    file.close();
+    std::remove(path.c_str());
+    if (ok) PASS();
+    else FAIL("mapped tables should match the built ones");
+}
+
+void test_rubik_pattern_db() {
+    TEST("Rubik corner/edge PDBs are admissible");
+    RubikPatternDb corners, edges;
+    corners.build(RUBIK_CORNER_PIECES, 0x7);
+    edges.build(RUBIK_EDGE_PIECES, 0x3);
+    bool ok = corners.size() == 8 * 7 * 6 * 27 && edges.size() == 12 * 11 * 4;
+    uint8_t f[12];
+    for (uint64_t r = 0; r < corners.size(); r += 13) {
+        corners.unrank(r, f);
+        if (corners.rank(f) != r) ok = false;
+    }
+    RubikCube cube;
+    ok = ok && corners.lookup(cube) == 0 && edges.lookup(cube) == 0;
+    // A state n moves from solved never looks further than n
+    const char* moves[] = {"R", "U'", "F", "L", "D'", "B", "R'"};
+    for (int i = 0; i < 7; i++) {
+        cube.applyMove(moves[i]);
+        if (corners.lookup(cube) > i + 1 || edges.lookup(cube) > i + 1) ok = false;
+    }
+    RubikCube oneTurn;
+    oneTurn.applyMove("F");
+    ok = ok && corners.lookup(oneTurn) == 1 && edges.lookup(oneTurn) <= 1;
+    if (ok) PASS();
+    else FAIL("piece ranking or BFS distances are wrong");
+}
+
+void test_state_enumerator() {
+    TEST("Parallel BFS histogram matches a serial BFS");
+    // Serial reference: 3 red stickers under XY and ZW slices only
+    uint64_t home = TesseractPatternDb::homeMask(C_X_POS);
+    uint64_t start = home & ~(home & (home - 1));
+    home &= home - 1;
+    start |= home & (0 - home);
+    home &= home - 1;
+    start |= home & (0 - home);
+    uint32_t planes = (1u << PLANE_XY) | (1u << PLANE_ZW);
+    std::vector<int> dist(TesseractPatternDb::binomial(TESSERACT_STICKERS, 3), -1);
+    std::vector<uint64_t> frontier(1, start), expected;
+    dist[TesseractPatternDb::rank(start)] = 0;
+    while (!frontier.empty()) {
+        expected.push_back(frontier.size());
+        std::vector<uint64_t> next;
+        for (uint64_t mask : frontier)
+            for (int m = 0; m < TESSERACT_OP_COUNT; m++) {
+                TesseractOp op{static_cast<uint8_t>(m)};
+                if (!((planes >> opPlane(op)) & 1)) continue;
+                uint64_t to = TesseractPuzzle::permuteMask(mask, op);
+                int& d = dist[TesseractPatternDb::rank(to)];
+                if (d < 0) { d = static_cast<int>(expected.size()); next.push_back(to); }
+            }
+        frontier.swap(next);
+    }
+    WorkStealingPool pool(2);
+    EnumerateResult result;
+    enumerateStates(StickerSetSpace(start, planes), pool, result);
+    bool ok = result.depthCounts == expected;
+
+    // Ordered stickers: rank round trip, and the histogram does not depend on thread count
+    std::vector<int> tuple = {0, 17, 42};
+    StickerTupleSpace space(tuple);
+    int back[8];
+    space.unrank(space.root(), back);
+    ok = ok && back[0] == 0 && back[1] == 17 && back[2] == 42;
+    WorkStealingPool single(1);
+    EnumerateResult serial;
+    enumerateStates(space, pool, result);
+    enumerateStates(space, single, serial);
+    uint64_t total = 0;
+    for (uint64_t n : result.depthCounts) total += n;
+    ok = ok && result.depthCounts == serial.depthCounts && total == result.states && result.states <= space.size();
+    if (ok) PASS();
+    else FAIL("enumerator histogram differs from reference");
+}
+
+void test_symmetric_coset_space() {
+    TEST("Symmetry-reduced coset BFS, weighted by orbit size, matches the full BFS");
+    WorkStealingPool pool(2);
+    bool ok = true;
+    // 4 stickers of one color on all planes, and 3 under XY and ZW only (fewer symmetries)
+    uint64_t home = TesseractPatternDb::homeMask(C_X_POS);
+    uint64_t four = 0;
+    for (int k = 0; k < 4; k++) {
+        four |= home & (0 - home);
+        home &= home - 1;
+    }
+    uint64_t three = four & (four - 1);
+    uint32_t planeSets[2] = {ALL_PLANES, (1u << PLANE_XY) | (1u << PLANE_ZW)};
+    uint64_t starts[2] = {four, three};
+    for (int t = 0; t < 2; t++) {
+        SymmetricStickerSetSpace reduced(starts[t], planeSets[t]);
+        EnumerateResult full, cosets;
+        enumerateStates(StickerSetSpace(starts[t], planeSets[t]), pool, full);
+        enumerateStates(reduced, pool, cosets);
+        ok = ok && reduced.symmetries() > 1 && cosets.depthStates == full.depthCounts &&
+             cosets.expandedStates == full.states && full.depthStates == full.depthCounts &&
+             cosets.states < full.states;
+        // A representative is its own canonical form, and every image canonicalizes to it
+        uint64_t mask = TesseractPuzzle::permuteMask(starts[t], TesseractOp{3});
+        uint64_t c = reduced.canonical(mask);
+        ok = ok && reduced.canonical(c) == c && c <= mask;
+    }
+    if (ok) PASS();
+    else FAIL("reduced histogram differs from the full one");
+}
+
+void test_move_journal() {
+    TEST("Move journal undo/redo and checkpoint seek");
+    TesseractPuzzle p;
+    RubikCube cube;
+    MoveJournal journal(64);
+    journal.reset(p, cube);
+
+    // Mixed session; remember both puzzles' hashes at every position
+    const int MOVES = 1000;
+    PhiloxStream rng(7, 0);
+    std::vector<uint64_t> hashes(1, p.hash() ^ cube.hash());
+    for (int i = 0; i < MOVES; i++) {
+        uint32_t r = rng.below(TESSERACT_OP_COUNT + 12);
+        uint8_t entry = r < TESSERACT_OP_COUNT
+                            ? journalEntry(TesseractOp{static_cast<uint8_t>(r)})
+                            : journalEntry(makeRubikOp((r - TESSERACT_OP_COUNT) / 2, (r - TESSERACT_OP_COUNT) % 2));
+        MoveJournal::applyEntry(entry, p, cube);
+        journal.record(entry, p, cube);
+        hashes.push_back(p.hash() ^ cube.hash());
+    }
+    bool ok = journal.size() == MOVES && journal.checkpointCount() == MOVES / 64 + 1;
+
+    uint8_t entry;
+    for (int i = 0; i < 300; i++) {
+        ok = ok && journal.undo(entry);
+        MoveJournal::applyEntry(inverseEntry(entry), p, cube);
+    }
+    ok = ok && journal.position() == 700 && (p.hash() ^ cube.hash()) == hashes[700];
+    for (int i = 0; i < 100; i++) {
+        ok = ok && journal.redo(entry);
+        MoveJournal::applyEntry(entry, p, cube);
+    }
+    ok = ok && journal.position() == 800 && (p.hash() ^ cube.hash()) == hashes[800];
+
+    // Seeking replays < 64 entries from the nearest checkpoint
+    size_t targets[] = {0, 123, 640, 999, MOVES};
+    for (size_t t : targets) {
+        int replayed = 0;
+        ok = ok && journal.seek(t, p, cube, [&](uint8_t) { replayed++; });
+        ok = ok && replayed < 64 && journal.position() == t && (p.hash() ^ cube.hash()) == hashes[t];
+        ok = ok && cube.hash() == cube.computeHash();
+    }
+    ok = ok && !journal.seek(MOVES + 1, p, cube) && !journal.redo(entry);
+
+    // A new move after undo drops the redo tail and its checkpoints
+    journal.seek(130, p, cube);
+    MoveJournal::applyEntry(0, p, cube);
+    journal.record(0, p, cube);
+    ok = ok && journal.size() == 131 && journal.checkpointCount() == 3 && !journal.canRedo();
+    ok = ok && journal.seek(129, p, cube) && (p.hash() ^ cube.hash()) == hashes[129];
+
+    if (ok) PASS(); else FAIL("journal state mismatch");
+}
+
+void test_move_simplifier() {
+    TEST("Simplifier cancels, merges and orders commuting moves");
+    std::vector<TesseractOp> t;
+    bool ok = parseTesseractMoves("XY0 XY0'", t) && simplifyMoves(t) == 2 && t.empty();
+    ok = ok && parseTesseractMoves("XY0 XY0 XY0 XY0", t) && simplifyMoves(t) == 4 && t.empty();
+    ok = ok && parseTesseractMoves("XY0 XY0 XY0", t) && simplifyMoves(t) == 2 && formatMoves(t.data(), t.size()) == "XY0'";
+    std::vector<RubikOp> r;
+    ok = ok && parseRubikMoves("R L R'", r) && simplifyMoves(r) == 2 && r.size() == 1 && opFace(r[0]) == LEFT;
+    ok = ok && movesCommute(makeRubikOp(UP, 0), makeRubikOp(DOWN, 2)) && !movesCommute(makeRubikOp(UP, 0), makeRubikOp(RIGHT, 0));
+
+    // Random sequences: same effect, never longer, canonical, and a fixed point
+    PhiloxStream rng(11, 0);
+    for (int trial = 0; trial < 200 && ok; trial++) {
+        std::vector<TesseractOp> ops(40);
+        for (TesseractOp& op : ops) {
+            // Few distinct slices so merges and cancellations are common
+            op.code = static_cast<uint8_t>(rng.below(8) * 6 % TESSERACT_OP_COUNT + rng.below(2));
+        }
+        TesseractPuzzle a, b;
+        a.apply(ops.data(), ops.size());
+        std::vector<TesseractOp> simple = ops;
+        simplifyMoves(simple);
+        b.apply(simple.data(), simple.size());
+        ok = ok && a == b && simple.size() <= ops.size();
+        for (size_t i = 1; i < simple.size(); i++) {
+            int repeat = i >= 2 && simple[i - 1].code == simple[i - 2].code ? 2 : 1;
+            uint64_t next = canonicalSuccessors(simple[i - 1]);
+            if (repeat > 1) next &= ~(uint64_t(1) << simple[i - 1].code);
+            ok = ok && ((next >> simple[i].code) & 1);
+        }
+        std::vector<TesseractOp> again = simple;
+        ok = ok && simplifyMoves(again) == 0;
+
+        std::vector<RubikOp> rops(40);
+        for (RubikOp& op : rops) op.code = static_cast<uint8_t>(rng.below(RUBIK_OP_COUNT));
+        RubikCube c, d;
+        c.apply(rops.data(), rops.size());
+        std::vector<RubikOp> rsimple = rops;
+        simplifyMoves(rsimple);
+        d.apply(rsimple.data(), rsimple.size());
+        ok = ok && c == d;
+        for (size_t i = 1; i < rsimple.size(); i++) ok = ok && ((canonicalSuccessors(rsimple[i - 1]) >> rsimple[i].code) & 1);
+    }
+    if (ok) PASS(); else FAIL("simplified sequence differs or is not canonical");
+}
+
+void test_move_log_file() {
+    TEST("Binary move log round trip and checkpoint seek");
+    TesseractPuzzle p;
+    RubikCube cube;
+    p.scramble(20, 5);
+    const std::string path = "test_moves.tmp";
+    MoveLogWriter writer;
+    bool ok = writer.open(path, p, cube, 100);  // rounded up to 100 (a multiple of 4)
+
+    // Mixed session including Rubik half turns (stored as two codes); hash after each code
+    PhiloxStream rng(21, 0);
+    std::vector<uint64_t> hashes(1, p.hash() ^ cube.hash());
+    for (int i = 0; i < 5000; i++) {
+        uint32_t r = rng.below(TESSERACT_OP_COUNT + RUBIK_OP_COUNT);
+        if (r < TESSERACT_OP_COUNT) {
+            TesseractOp op{static_cast<uint8_t>(r)};
+            writer.append(op);
+            p.apply(op);
+            hashes.push_back(p.hash() ^ cube.hash());
+        } else {
+            RubikOp op{static_cast<uint8_t>(r - TESSERACT_OP_COUNT)};
+            writer.append(op);
+            for (int q = 0; q < (opTurn(op) == 2 ? 2 : 1); q++) {
+                cube.apply(opTurn(op) == 2 ? makeRubikOp(opFace(op), 0) : op);
+                hashes.push_back(p.hash() ^ cube.hash());
+            }
+        }
+    }
+    uint64_t moves = writer.moveCount();
+    ok = ok && moves == hashes.size() - 1 && writer.close();
+
+    MoveLogReader reader;
+    std::string error;
+    ok = ok && reader.open(path, &error) && reader.moveCount() == moves && reader.checkpointInterval() == 100;
+    ok = ok && reader.checkpointCount() == moves / 100 + 1;
+    uint64_t targets[] = {0, 1, 99, 100, 2345, moves - 1, moves};
+    for (uint64_t t : targets) {
+        TesseractPuzzle a;
+        RubikCube b;
+        ok = ok && reader.seek(t, a, b) && (a.hash() ^ b.hash()) == hashes[t] && b.hash() == b.computeHash();
+    }
+    TesseractPuzzle a;
+    RubikCube b;
+    ok = ok && !reader.seek(moves + 1, a, b);
+    // Streaming the whole log from the first checkpoint reaches the final state
+    reader.seek(0, a, b);
+    uint64_t visited = 0;
+    reader.forEach(0, moves, [&](uint8_t c) { applyMoveLogCode(c, a, b); visited++; });
+    ok = ok && visited == moves && a == p && b == cube;
+    reader.close();
+
+    // A damaged index is rejected
+    FILE* f = std::fopen(path.c_str(), "r+b");
+    if (f) {
+        std::fseek(f, -20, SEEK_END);
+        int c = std::fgetc(f);
+        std::fseek(f, -20, SEEK_END);
+        std::fputc(c ^ 0x40, f);
+        std::fclose(f);
+    }
+    ok = ok && f && !reader.open(path, &error);
+    std::remove(path.c_str());
+    if (ok) PASS(); else FAIL("move log mismatch: " + error);
+}
+
+void test_cubie_rank() {
+    TEST("Cubie coordinates: O(n) rank/unrank round trips in lexicographic order");
+    bool ok = true;
+    uint8_t p[EDGE_COUNT], q[EDGE_COUNT];
+    for (int i = 0; i < CORNER_COUNT; i++) p[i] = static_cast<uint8_t>(i);
+    for (int r = 0; r < CORNER_PERM_COUNT && ok; r++) {
+        unrankPermutation(r, q, CORNER_COUNT);
+        ok = rankPermutation(q, CORNER_COUNT) == r && std::memcmp(p, q, CORNER_COUNT) == 0;
+        std::next_permutation(p, p + CORNER_COUNT);
+    }
+    PhiloxStream rng(18, 0);
+    for (int k = 0; k < 2000 && ok; k++) {
+        CubieCube c;
+        c.setTwist(static_cast<int>(rng.below(TWIST_COUNT)));
+        c.setFlip(static_cast<int>(rng.below(FLIP_COUNT)));
+        c.setCornerPerm(static_cast<int>(rng.below(CORNER_PERM_COUNT)));
+        int edges = static_cast<int>(rng.below(EDGE_PERM_COUNT));
+        c.setEdgePerm(edges);
+        CubieCube d;
+        d.setTwist(c.twist());
+        d.setFlip(c.flip());
+        d.setCornerPerm(c.cornerPerm());
+        d.setEdgePerm(c.edgePerm());
+        ok = c == d && c.edgePerm() == edges;
+    }
+    for (uint64_t seed = 0; seed < 20 && ok; seed++) {
+        RubikCube cube, back;
+        cube.scramble(30, seed);
+        CubieCube c;
+        ok = CubieCube::fromCube(cube, c);
+        c.toCube(back);
+        ok = ok && back == cube && back.hash() == cube.hash();
+    }
+    if (ok) PASS(); else FAIL("rank/unrank mismatch");
+}
+
+void test_kociemba_two_phase() {
+    TEST("Kociemba: cubie round trip, coordinates, short solutions, cached tables");
+    bool ok = true;
+    CubieCube solved;
+    for (int op = 0; op < RUBIK_OP_COUNT && ok; op++) {
+        RubikCube c;
+        c.scramble(20, static_cast<uint64_t>(op));
+        c.apply(RubikOp{static_cast<uint8_t>(op)});
+        CubieCube cc;
+        uint8_t back[RUBIK_FACELETS];
+        ok = CubieCube::fromCube(c, cc) && cc.twist() < TWIST_COUNT && cc.slice() < SLICE_COUNT;
+        cc.toFacelets(back);
+        ok = ok && std::memcmp(back, c.facelets(), RUBIK_FACELETS) == 0;
+        CubieCube moved = solved;
+        moved.apply(RubikOp{static_cast<uint8_t>(op)});
+        RubikCube one;
+        one.apply(RubikOp{static_cast<uint8_t>(op)});
+        CubieCube expect;
+        ok = ok && CubieCube::fromCube(one, expect) && moved == expect;
+    }
+    RubikCube twisted;
+    uint8_t bad[RUBIK_FACELETS];
+    std::memcpy(bad, twisted.facelets(), RUBIK_FACELETS);
+    std::swap(bad[0], bad[2 * 9]);  // an R sticker and a U sticker of different pieces
+    CubieCube reject;
+    std::string why;
+    ok = ok && !CubieCube::fromFacelets(bad, reject, &why) && !why.empty();
+
+    const std::string path = "test_kociemba.tmp";
+    std::remove(path.c_str());
+    KociembaOptions options;
+    options.tablePath = path;
+    KociembaSolver built(options);
+    KociembaSolver mapped(options);
+    ok = ok && !built.mappedTables() && mapped.mappedTables();
+    for (uint64_t seed = 1; seed <= 4 && ok; seed++) {
+        RubikCube c;
+        c.scramble(40, seed);
+        std::vector<RubikOp> solution;
+        KociembaStats stats;
+        ok = (seed & 1 ? built : mapped).solve(c, solution, &stats) &&
+             static_cast<int>(solution.size()) <= options.maxLength && stats.length == static_cast<int>(solution.size());
+        for (RubikOp op : solution) c.apply(op);
+        ok = ok && c.isSolved();
+    }
+    std::remove(path.c_str());
+    if (ok) PASS(); else FAIL("two-phase solve failed");
+}
+
+void test_solve_pipeline() {
+    TEST("Batch solve pipeline keeps input order and reports failures");
+    const char* scrambles[] = {"R U F' L2 D B'", "", "R Q", "F2 U' R D' L B U2 R' F D2", "U", "B' L' D R2 F'"};
+    const int count = sizeof(scrambles) / sizeof(scrambles[0]);
+    FILE* in = std::tmpfile();
+    FILE* out = std::tmpfile();
+    bool ok = in && out;
+    for (int i = 0; ok && i < count; i++) std::fprintf(in, "%s\n", scrambles[i]);
+    SolvePipelineOptions options;
+    options.puzzle = SCRAMBLE_RUBIK;
+    options.threads = 3;
+    options.queueCapacity = 2;  // smaller than the input, so the reader has to wait
+    options.tablePath = "";
+    SolvePipelineReport report;
+    if (ok) {
+        std::rewind(in);
+        ok = runSolvePipeline(in, out, options, report) && report.scrambles == count && report.solved == count - 1 &&
+             report.failed == 1 && report.p99 <= report.maxLatency;
+        std::rewind(out);
+    }
+    char line[256];
+    for (int i = 0; ok && i < count; i++) {
+        ok = std::fgets(line, sizeof(line), out) != nullptr;
+        std::string text = ok ? std::string(line, std::strcspn(line, "\n")) : std::string();
+        std::vector<RubikOp> scramble, solution;
+        if (i == 2) { ok = ok && text.rfind("# ", 0) == 0; continue; }
+        ok = ok && parseRubikMoves(scrambles[i], scramble) && parseRubikMoves(text, solution);
+        RubikCube c;
+        c.apply(scramble.data(), scramble.size());
+        c.apply(solution.data(), solution.size());
+        ok = ok && c.isSolved();
+    }
+    if (in) std::fclose(in);
+    if (out) std::fclose(out);
+    if (ok) PASS(); else FAIL("pipeline output out of order or wrong");
+}
+
+void test_solver_optimal() {
+    TEST("IDA* solver returns a short solution");
+    SolverOptions opts;
+    opts.tracked = 3;
+    opts.threads = 2;
+    opts.maxDepth = 6;
+    TesseractSolver solver(opts);
+    TesseractPuzzle p;
+    p.applyMove("XY0"); p.applyMove("ZW1'"); p.applyMove("XW3"); p.applyMove("YW2");
+    std::string solution;
+    SolveStats stats;
+    bool ok = solver.solve(p, solution, &stats) && stats.depth <= 4 && stats.nodes > 0;
+    std::vector<TesseractOp> ops;
+    ok = ok && parseTesseractMoves(solution, ops);
+    p.apply(ops.data(), ops.size());
+    ok = ok && p.isSolved();
+    if (ok) PASS();
+    else FAIL("solution should solve the scramble in at most 4 moves");
+}
+
 void test_projection_finite() {
     TEST("Projection produces finite values");
     Vec4 p(1.0f, 1.0f, 1.0f, 1.0f);
@@ -56,6 +882,27 @@ void test_projection_finite() {
     else FAIL("projection should not produce NaN");
 }
 
+void test_projection_batch() {
+    TEST("Batch SoA projection matches project4Dto3D, including w = -wDistance");
+    const float wDistance = 4.0f;
+    float xs[9], ys[9], zs[9], ws[9];
+    for (int i = 0; i < 9; i++) {
+        xs[i] = 0.5f * i - 2.0f;
+        ys[i] = 1.0f - 0.25f * i;
+        zs[i] = static_cast<float>(i % 3);
+        ws[i] = i == 4 ? -wDistance : 0.4f * i - 1.5f;
+    }
+    float ox[9], oy[9], oz[9], ow[9];
+    Vec4SoA in = {xs, ys, zs, ws}, out = {ox, oy, oz, ow};
+    projectPoints(in, out, 9, wDistance);
+    bool ok = true;
+    for (int i = 0; i < 9; i++) {
+        Vec4 want = project4Dto3D(Vec4(xs[i], ys[i], zs[i], ws[i]), wDistance);
+        ok = ok && ox[i] == want.x && oy[i] == want.y && oz[i] == want.z && ow[i] == 0.0f;
+    }
+    if (ok) PASS(); else FAIL("batch projection differs");
+}
+
 void test_math_rotate() {
     TEST("4D rotation matrix");
     Mat4x4 r = rotate4D(PLANE_XY, 90.0f);
@@ -67,14 +914,156 @@ void test_math_rotate() {
     else FAIL("90° XY rotation of (1,0,0,0) should give ~(0,-1,0,0)");
 }
 
+void test_rotor_4d() {
+    TEST("Rotors match rotate4D, compose like matMul, slerp and renormalize");
+    auto close = [](const Mat4x4& a, const Mat4x4& b, float eps) {
+        for (int i = 0; i < 16; i++)
+            if (a.m[i] - b.m[i] > eps || b.m[i] - a.m[i] > eps) return false;
+        return true;
+    };
+    bool ok = true;
+    for (int plane = 0; plane < 6; plane++)
+        for (float angle : {-90.0f, 17.0f, 90.0f, 200.0f})
+            ok = ok && close(Rotor4::plane(plane, angle).toMatrix(), rotate4D(plane, angle), 1e-5f);
+    Rotor4 a = Rotor4::plane(PLANE_XW, 30.0f), b = Rotor4::plane(PLANE_YZ, -50.0f);
+    Rotor4 ab = compose(a, b);
+    ok = ok && close(ab.toMatrix(), matMul(a.toMatrix(), b.toMatrix()), 1e-5f);
+    Vec4 v(0.3f, -1.0f, 2.0f, 0.5f), back = ab.inverse().apply(ab.apply(v));
+    ok = ok && std::fabs(back.x - v.x) < 1e-5f && std::fabs(back.w - v.w) < 1e-5f;
+    // Halfway along a quarter turn is an eighth turn; the ends are exact
+    Rotor4 quarter = Rotor4::plane(PLANE_ZW, 90.0f);
+    ok = ok && close(slerp(Rotor4::identity(), quarter, 0.5f).toMatrix(), rotate4D(PLANE_ZW, 45.0f), 1e-5f) &&
+         close(slerp(Rotor4::identity(), quarter, 1.0f).toMatrix(), quarter.toMatrix(), 1e-6f) &&
+         close(slerp(ab, ab, 0.3f).toMatrix(), ab.toMatrix(), 1e-5f);
+    // A long chain stays a rotation once renormalized
+    Rotor4 step = compose(Rotor4::plane(PLANE_XY, 0.7f), Rotor4::plane(PLANE_YW, 1.3f)), chain;
+    Mat4x4 m = Mat4x4::identity();
+    for (int i = 0; i < 2000; i++) {
+        chain = compose(step, chain);
+        m = matMul(step.toMatrix(), m);
+    }
+    chain.normalize();
+    ok = ok && close(chain.toMatrix(), m, 1e-3f);
+    Vec4 unit = chain.apply(Vec4(1.0f, 0.0f, 0.0f, 0.0f));
+    float len = unit.x * unit.x + unit.y * unit.y + unit.z * unit.z + unit.w * unit.w;
+    ok = ok && std::fabs(len - 1.0f) < 1e-5f;
+    if (ok) PASS(); else FAIL("rotor disagrees with matrix rotation");
+}
+
+void test_math_batch() {
+    TEST("SIMD matMul and batch transforms match scalar arithmetic");
+    Mat4x4 m = matMul(rotate4D(PLANE_XW, 33.0f), rotate4D(PLANE_YZ, -71.0f));
+    m.m[12] = 0.5f;  // not just a rotation
+    m.m[7] = -2.0f;
+    auto reference = [&](const Vec4& v) {
+        const float* e = m.m;
+        return Vec4(e[0] * v.x + e[4] * v.y + e[8] * v.z + e[12] * v.w, e[1] * v.x + e[5] * v.y + e[9] * v.z + e[13] * v.w,
+                    e[2] * v.x + e[6] * v.y + e[10] * v.z + e[14] * v.w, e[3] * v.x + e[7] * v.y + e[11] * v.z + e[15] * v.w);
+    };
+    auto close = [](float a, float b) { return a - b < 1e-5f && b - a < 1e-5f; };
+    auto same = [&](const Vec4& a, const Vec4& b) { return close(a.x, b.x) && close(a.y, b.y) && close(a.z, b.z) && close(a.w, b.w); };
+
+    const size_t n = 37;  // leaves a tail after every vector width
+    std::vector<Vec4> in(n), out(n);
+    std::vector<float> sx(n), sy(n), sz(n), sw(n);
+    for (size_t i = 0; i < n; i++) {
+        in[i] = Vec4(0.1f * i - 1.0f, 0.5f - 0.03f * i, static_cast<float>(i % 5), 1.0f + 0.25f * (i % 3));
+        sx[i] = in[i].x; sy[i] = in[i].y; sz[i] = in[i].z; sw[i] = in[i].w;
+    }
+    transformPoints(m, in.data(), out.data(), n);
+    Vec4SoA soa = {sx.data(), sy.data(), sz.data(), sw.data()};
+    transformPoints(m, soa, soa, n);  // in place
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        Vec4 want = reference(in[i]);
+        ok = ok && same(out[i], want) && same(matMul(m, in[i]), want) && same(Vec4(sx[i], sy[i], sz[i], sw[i]), want);
+    }
+    Mat4x4 a = rotate4D(PLANE_ZW, 12.0f), p = matMul(m, a);
+    for (int c = 0; c < 4; c++) {
+        Vec4 col = reference(Vec4(a.m[c * 4], a.m[c * 4 + 1], a.m[c * 4 + 2], a.m[c * 4 + 3]));
+        ok = ok && same(Vec4(p.m[c * 4], p.m[c * 4 + 1], p.m[c * 4 + 2], p.m[c * 4 + 3]), col);
+    }
+    ok = ok && alignof(Vec4) == 16 && alignof(Mat4x4) == 16;
+    if (ok) PASS(); else FAIL("SIMD result differs from scalar");
+}
+
+void test_math_nd() {
+    TEST("Vec<N>/Mat<N> planes, Givens rotations and projection agree with the 4D code");
+    bool ok = true;
+    for (int plane = 0; plane < planeCount(4); plane++) {
+        Mat4x4 m = matMul(rotate4D(PLANE_XW, 33.0f), rotate4D(PLANE_YZ, -71.0f)), g = m;
+        givensRotate(g, planeAxes(4, plane), std::cos(0.3f), std::sin(0.3f));
+        Mat4x4 want = matMul(rotate4D(plane, 0.3f * 180.0f / 3.14159265f), m);
+        for (int i = 0; i < 16; i++) ok = ok && std::fabs(g.m[i] - want.m[i]) < 1e-5f;
+        PlaneAxes axes = planeAxes(4, plane);
+        ok = ok && planeIndex(4, axes.first, axes.second) == plane;
+    }
+    // 5D: ten planes, each rotation orthogonal, matrix and in-place vector rotation agree
+    Vec5f v(1.0f, -2.0f, 0.5f, 0.25f, 3.0f);
+    Mat5f all = Mat5f::identity();
+    for (int plane = 0; plane < planeCount(5); plane++) {
+        Mat5f r = planeRotation<5>(plane, 10.0f + plane);
+        all = matMul(r, all);
+        givensRotate(v, planeAxes(5, plane), std::cos((10.0f + plane) * 3.14159265f / 180.0f),
+                     std::sin((10.0f + plane) * 3.14159265f / 180.0f));
+    }
+    Vec5f want = matMul(all, Vec5f(1.0f, -2.0f, 0.5f, 0.25f, 3.0f));
+    for (int i = 0; i < 5; i++) {
+        ok = ok && std::fabs(v[i] - want[i]) < 1e-5f;
+        for (int j = 0; j < 5; j++) {
+            float dot = 0.0f;
+            for (int k = 0; k < 5; k++) dot += all.m[i * 5 + k] * all.m[j * 5 + k];
+            ok = ok && std::fabs(dot - (i == j ? 1.0f : 0.0f)) < 1e-5f;
+        }
+    }
+    Mat<5, float> fixed = Mat5f::identity();
+    givensRotate<planeIndex(5, 2, 4)>(fixed, 0.6f, 0.8f);
+    ok = ok && fixed.m[2 * 5 + 2] == 0.6f && fixed.m[4 * 5 + 2] == 0.8f && fixed.m[2 * 5 + 4] == -0.8f;
+    // Projection: N = 4 matches project4Dto3D, N = 3 drops to the plane
+    Vec4 p(0.5f, -0.5f, 0.25f, 0.75f), q = project4Dto3D(p, 3.0f);
+    Vec3f r = projectPerspective(p, 3.0f);
+    Vec<2, float> flat = projectPerspective(Vec3f(1.0f, 2.0f, 1.0f), 1.0f);
+    ok = ok && r[0] == q.x && r[1] == q.y && r[2] == q.z && flat[0] == 0.5f && flat[1] == 1.0f;
+    ok = ok && alignof(Vec4) == 16 && alignof(Mat4x4) == 16 && sizeof(Vec3f) == 12;
+    if (ok) PASS(); else FAIL("generic N-D math disagrees with the 4D code");
+}
+
 int main() {
     std::cout << "Tesseract smoke tests\n";
     test_solved_state();
     test_reset();
     test_inverse_move();
     test_four_moves_identity();
+    test_packed_moves_match_permutation();
+    test_packed_color_counts();
+    test_hypercube_puzzle();
+    test_compiled_sequence();
+    test_permutation_order();
+    test_tokenizer_opcodes();
+    test_rubik_table_moves();
+    test_zobrist_incremental();
+    test_transposition_table();
+    test_symmetry_canonical();
+    test_seeded_scrambles();
+    test_batch_engine();
+    test_pattern_db_rank();
+    test_pdb_file_round_trip();
+    test_rubik_pattern_db();
+    test_state_enumerator();
+    test_symmetric_coset_space();
+    test_move_journal();
+    test_move_simplifier();
+    test_move_log_file();
+    test_cubie_rank();
+    test_kociemba_two_phase();
+    test_solve_pipeline();
+    test_solver_optimal();
     test_projection_finite();
+    test_projection_batch();
     test_math_rotate();
+    test_math_batch();
+    test_rotor_4d();
+    test_math_nd();
     std::cout << "\n" << tests_run << " tests, " << tests_failed << " failed\n";
     return tests_failed ? 1 : 0;
 }
@@ -0,0 +1,86 @@
+// Transposition Table Implementation
+
+#include "transposition_table.h"
+
+// data layout: value:16 | depth:8 | move:8 | flags:8 | generation:8 | occupied:1
+static const uint64_t OCCUPIED = uint64_t(1) << 48;
+
+static inline uint64_t pack(const TTEntry& e, uint32_t generation) {
+    return static_cast<uint64_t>(static_cast<uint16_t>(e.value)) | (static_cast<uint64_t>(e.depth) << 16) |
+           (static_cast<uint64_t>(e.move) << 24) | (static_cast<uint64_t>(e.flags) << 32) |
+           (static_cast<uint64_t>(generation & 0xFF) << 40) | OCCUPIED;
+}
+
+static inline TTEntry unpack(uint64_t data) {
+    TTEntry e;
+    e.value = static_cast<int16_t>(data & 0xFFFF);
+    e.depth = static_cast<uint8_t>(data >> 16);
+    e.move = static_cast<uint8_t>(data >> 24);
+    e.flags = static_cast<uint8_t>(data >> 32);
+    return e;
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) : mask_(0), generation_(0) {
+    // Largest power-of-two bucket count that fits
+    size_t buckets = 1;
+    while (buckets * 2 * sizeof(Bucket) <= (megabytes << 20)) buckets *= 2;
+    buckets_.reset(new Bucket[buckets]);
+    mask_ = buckets - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t b = 0; b <= mask_; b++)
+        for (int s = 0; s < SLOTS; s++) {
+            buckets_[b].slots[s].check.store(0, std::memory_order_relaxed);
+            buckets_[b].slots[s].data.store(0, std::memory_order_relaxed);
+        }
+    generation_.store(0, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& out) const {
+    const Bucket& bucket = buckets_[key & mask_];
+    for (int s = 0; s < SLOTS; s++) {
+        uint64_t data = bucket.slots[s].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket.slots[s].check.load(std::memory_order_relaxed);
+        if ((data & OCCUPIED) && (check ^ data) == key) {
+            out = unpack(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, const TTEntry& entry) {
+    Bucket& bucket = buckets_[key & mask_];
+    uint32_t generation = generation_.load(std::memory_order_relaxed);
+    int victim = -1, worst = 1 << 30;
+    for (int s = 0; s < SLOTS && victim < 0; s++) {
+        uint64_t data = bucket.slots[s].data.load(std::memory_order_relaxed);
+        if ((data & OCCUPIED) && (bucket.slots[s].check.load(std::memory_order_relaxed) ^ data) == key) victim = s;
+    }
+    if (victim < 0) {
+        for (int s = 0; s < SLOTS; s++) {
+            uint64_t data = bucket.slots[s].data.load(std::memory_order_relaxed);
+            if (!(data & OCCUPIED)) { victim = s; break; }
+            int age = static_cast<int>((generation - (data >> 40)) & 0xFF);
+            int priority = static_cast<int>((data >> 16) & 0xFF) - 4 * age;
+            if (priority < worst) { worst = priority; victim = s; }
+        }
+    }
+    uint64_t data = pack(entry, generation);
+    bucket.slots[victim].data.store(data, std::memory_order_relaxed);
+    bucket.slots[victim].check.store(key ^ data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::usage() const {
+    size_t buckets = mask_ + 1 < 1000 ? mask_ + 1 : 1000;
+    uint32_t generation = generation_.load(std::memory_order_relaxed) & 0xFF;
+    size_t used = 0;
+    for (size_t b = 0; b < buckets; b++)
+        for (int s = 0; s < SLOTS; s++) {
+            uint64_t data = buckets_[b].slots[s].data.load(std::memory_order_relaxed);
+            if ((data & OCCUPIED) && ((data >> 40) & 0xFF) == generation) used++;
+        }
+    return static_cast<int>(used * 1000 / (buckets * SLOTS));
+}
@@ -0,0 +1,57 @@
+// Transposition Table
+// Fixed-size, lock-free table keyed by Zobrist hashes, shared by search threads without a mutex
+
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// What a search stores per state
+struct TTEntry {
+    int16_t value;   // e.g. best known distance bound
+    uint8_t depth;   // remaining depth the value was searched to
+    uint8_t move;    // best opcode, or 0xFF
+    uint8_t flags;   // caller-defined (exact / lower / upper bound, ...)
+};
+
+// Buckets of 4 slots fill one 64-byte cache line. Each slot holds the packed entry and
+// key ^ entry (lockless XOR check): a torn read or a concurrent overwrite makes the
+// check fail, so probe() reports a miss instead of returning mixed data.
+// Replacement: the same key is overwritten in place; otherwise the slot with the lowest
+// depth - 4 * age is evicted, where age counts newGeneration() calls since it was stored.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = 64);
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool probe(uint64_t key, TTEntry& out) const;
+    void store(uint64_t key, const TTEntry& entry);
+
+    // Start a new search: older entries become preferred victims
+    void newGeneration() { generation_.fetch_add(1, std::memory_order_relaxed); }
+    void clear();
+
+    size_t capacity() const { return (mask_ + 1) * SLOTS; }
+    // Occupied slots from the current generation, per mille, sampled over the first 1000 buckets
+    int usage() const;
+
+private:
+    static const int SLOTS = 4;
+    struct Slot {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;
+    };
+    struct alignas(64) Bucket {
+        Slot slots[SLOTS];
+    };
+
+    std::unique_ptr<Bucket[]> buckets_;
+    size_t mask_;
+    std::atomic<uint32_t> generation_;
+};
+
+#endif // TRANSPOSITION_TABLE_H
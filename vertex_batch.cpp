@@ -0,0 +1,80 @@
+// Vertex Batches Implementation
+
+#include "vertex_batch.h"
+#include <SFML/Window/Context.hpp>
+#include <cstddef>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+
+// GL 1.5 signatures, spelled out so no glext.h is needed
+typedef void(APIENTRY* GenBuffersFn)(GLsizei n, GLuint* buffers);
+typedef void(APIENTRY* BindBufferFn)(GLenum target, GLuint buffer);
+typedef void(APIENTRY* BufferDataFn)(GLenum target, std::ptrdiff_t size, const void* data, GLenum usage);
+
+static GenBuffersFn genBuffers = nullptr;
+static BindBufferFn bindBuffer = nullptr;
+static BufferDataFn bufferData = nullptr;
+
+bool loadVertexBufferFunctions() {
+    genBuffers = reinterpret_cast<GenBuffersFn>(sf::Context::getFunction("glGenBuffers"));
+    bindBuffer = reinterpret_cast<BindBufferFn>(sf::Context::getFunction("glBindBuffer"));
+    bufferData = reinterpret_cast<BufferDataFn>(sf::Context::getFunction("glBufferData"));
+    if (genBuffers && bindBuffer && bufferData) return true;
+    genBuffers = nullptr;
+    bindBuffer = nullptr;
+    bufferData = nullptr;
+    return false;
+}
+
+// Attribute pointer: an offset into the bound buffer, or an address in client memory
+static const void* attribute(const char* base, size_t offset) {
+    return base ? static_cast<const void*>(base + offset) : reinterpret_cast<const void*>(offset);
+}
+
+VertexBatch::VertexBatch() : buffer_(0), uploaded_(0) {}
+
+void VertexBatch::upload(bool dynamic) {
+    if (!genBuffers) return;
+    if (!buffer_) genBuffers(1, &buffer_);
+    bindBuffer(GL_ARRAY_BUFFER, buffer_);
+    // Respecifying the whole store lets the driver orphan the old one instead of stalling
+    bufferData(GL_ARRAY_BUFFER, static_cast<std::ptrdiff_t>(vertices_.size() * sizeof(BatchVertex)),
+               vertices_.data(), dynamic ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+    bindBuffer(GL_ARRAY_BUFFER, 0);
+    uploaded_ = vertices_.size();
+}
+
+void VertexBatch::draw(GLenum mode, size_t first, size_t count) const {
+    bool fromBuffer = buffer_ != 0 && bindBuffer;
+    size_t total = fromBuffer ? uploaded_ : vertices_.size();
+    if (count == 0) count = total > first ? total - first : 0;
+    if (count == 0 || first + count > total) return;
+
+    const char* base = nullptr;
+    if (fromBuffer) bindBuffer(GL_ARRAY_BUFFER, buffer_);
+    else base = reinterpret_cast<const char*>(vertices_.data());
+    const GLsizei stride = sizeof(BatchVertex);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, attribute(base, offsetof(BatchVertex, x)));
+    glNormalPointer(GL_FLOAT, stride, attribute(base, offsetof(BatchVertex, nx)));
+    glColorPointer(4, GL_FLOAT, stride, attribute(base, offsetof(BatchVertex, r)));
+    glDrawArrays(mode, static_cast<GLint>(first), static_cast<GLsizei>(count));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    // SFML's own drawing expects no buffer bound
+    if (fromBuffer) bindBuffer(GL_ARRAY_BUFFER, 0);
+}
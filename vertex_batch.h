@@ -0,0 +1,46 @@
+// Vertex Batches
+// CPU-side position/normal/color arrays drawn with one glDrawArrays each, from a VBO when available
+
+#ifndef VERTEX_BATCH_H
+#define VERTEX_BATCH_H
+
+#include <SFML/OpenGL.hpp>
+#include <cstddef>
+#include <vector>
+
+// Interleaved vertex: position, normal (ignored with lighting off), RGBA color
+struct BatchVertex {
+    float x, y, z;
+    float nx, ny, nz;
+    float r, g, b, a;
+};
+
+// Load the GL 1.5 buffer-object entry points through sf::Context::getFunction (opengl32 on
+// Windows exports only GL 1.1). Call once with the context active; returns false, and
+// batches draw from client memory instead, when the context has no buffer objects.
+bool loadVertexBufferFunctions();
+
+// A list of vertices built on the CPU, uploaded once (static geometry) or once per frame,
+// and drawn in a few calls over index ranges. The buffer object belongs to the GL context
+// and is released with it, so a batch never calls GL from its destructor.
+class VertexBatch {
+public:
+    VertexBatch();
+
+    void clear() { vertices_.clear(); }
+    void add(const BatchVertex& v) { vertices_.push_back(v); }
+    size_t size() const { return vertices_.size(); }
+
+    // Copy the vertices into the batch's buffer object (a no-op without buffer objects)
+    void upload(bool dynamic);
+
+    // glDrawArrays over [first, first + count); count = 0 draws to the end
+    void draw(GLenum mode, size_t first = 0, size_t count = 0) const;
+
+private:
+    std::vector<BatchVertex> vertices_;
+    GLuint buffer_;
+    size_t uploaded_;  // vertices in buffer_ as of the last upload
+};
+
+#endif // VERTEX_BATCH_H
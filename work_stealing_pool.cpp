@@ -0,0 +1,80 @@
+// Work-Stealing Thread Pool Implementation
+
+#include "work_stealing_pool.h"
+
+WorkStealingPool::WorkStealingPool(int threads)
+    : job_(nullptr), generation_(0), remaining_(0), stop_(false) {
+    if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads <= 0) threads = 1;
+    for (int i = 0; i < threads; i++) queues_.emplace_back(new Queue());
+    for (int i = 0; i < threads; i++) workers_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& t : workers_) t.join();
+}
+
+void WorkStealingPool::run(size_t count, const std::function<void(size_t, int)>& fn) {
+    if (count == 0) return;
+    // Publish the job before any task is visible: a worker still draining the
+    // previous generation may pick up a new task and must see the new job
+    job_.store(&fn);
+    remaining_.store(count);
+    size_t n = queues_.size();
+    for (size_t w = 0; w < n; w++) {
+        size_t begin = count * w / n, end = count * (w + 1) / n;
+        std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+        for (size_t t = begin; t < end; t++) queues_[w]->tasks.push_back(t);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    generation_++;
+    wake_.notify_all();
+    done_.wait(lock, [this] { return remaining_.load() == 0; });
+}
+
+bool WorkStealingPool::popOwn(int index, size_t& task) {
+    Queue& q = *queues_[index];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    task = q.tasks.back();
+    q.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int index, size_t& task) {
+    size_t n = queues_.size();
+    for (size_t k = 1; k < n; k++) {
+        Queue& q = *queues_[(index + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) continue;
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int index) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        size_t task;
+        while (popOwn(index, task) || steal(index, task)) {
+            (*job_.load())(task, index);
+            if (remaining_.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_.notify_all();
+            }
+        }
+    }
+}
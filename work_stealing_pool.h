@@ -0,0 +1,54 @@
+// Work-Stealing Thread Pool
+// Fixed worker set with per-worker task deques; idle workers steal from the others
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    // threads <= 0 uses std::thread::hardware_concurrency()
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()); }
+
+    // Run fn(task, worker) for task in [0, count) and block until all have finished.
+    // Tasks are dealt to the workers in contiguous blocks; an owner pops from the back
+    // of its own deque and thieves take from the front of someone else's.
+    // One run() at a time: the pool is owned by a single caller.
+    void run(size_t count, const std::function<void(size_t, int)>& fn);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::atomic<const std::function<void(size_t, int)>*> job_;
+    uint64_t generation_;
+    std::atomic<size_t> remaining_;
+    bool stop_;
+
+    void workerLoop(int index);
+    bool popOwn(int index, size_t& task);
+    bool steal(int index, size_t& task);
+};
+
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,17 @@
+// Zobrist Keys
+// Deterministic 64-bit keys for incremental state hashing (same on every run and platform)
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// SplitMix64 step: advances state and returns the next key
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+#endif // ZOBRIST_H